@@ -23,6 +23,8 @@
 #include "IMPL/ReconstructedParticleImpl.h"
 #include <UTIL/LCRelationNavigator.h>
 
+#include "PFOConeIndex.h"
+
 
 class IsolatedLeptonFinderProcessor : public marlin::Processor {
 
@@ -111,6 +113,10 @@ class IsolatedLeptonFinderProcessor : public marlin::Processor {
 		float _cosConeAngle = 0;
 		std::vector<ReconstructedParticle*> _workingList = {};
 
+		/** Angular index of the PFOs of the working list, for cone energies */
+		PFOConeIndex _coneIndex {};
+		std::vector<int> _coneParticles {};
+
 		/** If set to true, uses PID cuts */
 		bool _usePID = false;
 		float _electronMinEnergyDepositByMomentum = 0;
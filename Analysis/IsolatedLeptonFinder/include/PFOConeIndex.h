@@ -0,0 +1,52 @@
+/**
+ * @brief Per-event angular index of the PFOs used for cone energies.
+ *
+ * The PFOs of a collection are sorted by polar angle, with their momenta
+ * stored as arrays. A cone query only visits the PFOs whose polar angle
+ * lies within the cone half-angle of the axis (the opening angle is never
+ * smaller than the difference in polar angle), and applies exactly the
+ * cosine cut of a scan over all PFOs. PFOs can be removed, e.g. when they
+ * are merged into a dressed lepton.
+ */
+#ifndef PFOConeIndex_h
+#define PFOConeIndex_h 1
+
+#include <vector>
+
+#include <EVENT/LCCollection.h>
+#include <EVENT/ReconstructedParticle.h>
+
+class PFOConeIndex {
+
+	public:
+
+		PFOConeIndex() {}
+
+		/** Index all PFOs of the collection */
+		void build( EVENT::LCCollection* pfoCol ) ;
+
+		/** Exclude PFO i (collection index) from further queries */
+		void remove( int i ) { _active[i] = false ; }
+
+		int getNumberOfParticles() const { return int(_pfo.size()) ; }
+
+		EVENT::ReconstructedParticle* getParticle( int i ) const { return _pfo[i] ; }
+
+		/** Collection indices, in collection order, of the PFOs with cos(angle to p) >= cosConeAngle */
+		void findInCone( const double* p, float cosConeAngle, std::vector<int>& inCone ) const ;
+
+	private:
+
+		std::vector<EVENT::ReconstructedParticle*> _pfo {};
+		std::vector<char> _active {};
+
+		/** PFOs with non-zero momentum, sorted by polar angle */
+		std::vector<double> _theta {};
+		std::vector<int> _index {};
+		std::vector<double> _px {};
+		std::vector<double> _py {};
+		std::vector<double> _pz {};
+		std::vector<double> _mag {};
+} ;
+
+#endif
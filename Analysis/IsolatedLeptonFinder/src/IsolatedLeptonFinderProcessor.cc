@@ -322,6 +322,9 @@ void IsolatedLeptonFinderProcessor::processEvent( LCEvent * evt ) {
 		}
 	}
 
+	// index PFO directions for the cone energies
+	_coneIndex.build( _pfoCol );
+
 	// order by energy
 	std::sort(goodLeptonIndices.begin(), goodLeptonIndices.end(), [this](const int i, const int j) {return isMoreEnergetic(i, j);});
 
@@ -400,6 +403,7 @@ void IsolatedLeptonFinderProcessor::dressLepton( ReconstructedParticleImpl* pfo,
 			else if (isElectron) {streamlog_out(DEBUG) << "MESSAGE: merging lepton "<<i<<" with theta "<<theta <<" and type "<<pfo->getType()<<std::endl;}
 			_dressedPFOs.push_back(i);
 			_workingList.erase(std::remove(_workingList.begin(), _workingList.end(), pfo_dress), _workingList.end());
+			_coneIndex.remove(i);
 			double dressedMomentum[3] = {pfo->getMomentum()[0] + pfo_dress->getMomentum()[0],
 								  		 pfo->getMomentum()[1] + pfo_dress->getMomentum()[1],
 								  		 pfo->getMomentum()[2] + pfo_dress->getMomentum()[2]};
@@ -609,18 +613,16 @@ bool IsolatedLeptonFinderProcessor::PassesImpactParameterSignificanceCuts( Recon
 float IsolatedLeptonFinderProcessor::getConeEnergy( ReconstructedParticle* pfo ) {
 	float coneE = 0;
 
-	TVector3 P( pfo->getMomentum() );
-	int npfo = _workingList.size();
-	for ( int i = 0; i < npfo; i++ ) {
-		ReconstructedParticle* pfo_i = static_cast<ReconstructedParticle*>( _workingList.at(i) );
+	// PFOs of the working list inside the cone, in working list order
+	_coneIndex.findInCone( pfo->getMomentum(), _cosConeAngle, _coneParticles );
+	int ncone = _coneParticles.size();
+	for ( int i = 0; i < ncone; i++ ) {
+		ReconstructedParticle* pfo_i = _coneIndex.getParticle( _coneParticles[i] );
 
 		// don't add itself to the cone energy
 		if ( pfo == pfo_i ) continue;
 
-		TVector3 P_i( pfo_i->getMomentum() );
-		float cosTheta = P.Dot( P_i )/(P.Mag()*P_i.Mag());
-		if ( cosTheta >= _cosConeAngle )
-			coneE += pfo_i->getEnergy();
+		coneE += pfo_i->getEnergy();
 	}
 
 	return coneE;
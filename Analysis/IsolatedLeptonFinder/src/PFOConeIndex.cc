@@ -0,0 +1,73 @@
+#include "PFOConeIndex.h"
+
+#include <algorithm>
+#include <cmath>
+
+void PFOConeIndex::build( EVENT::LCCollection* pfoCol ) {
+
+	int npfo = pfoCol->getNumberOfElements();
+
+	_pfo.resize( npfo );
+	_active.assign( npfo, true );
+
+	std::vector<std::pair<double,int> > order;
+	order.reserve( npfo );
+
+	for ( int i = 0; i < npfo; i++ ) {
+		_pfo[i] = static_cast<EVENT::ReconstructedParticle*>( pfoCol->getElementAt(i) );
+
+		// PFOs without momentum have no direction and are never inside a cone
+		const double* p = _pfo[i]->getMomentum();
+		if ( p[0]*p[0] + p[1]*p[1] + p[2]*p[2] == 0 ) continue;
+
+		order.push_back( std::make_pair( std::atan2( std::sqrt( p[0]*p[0] + p[1]*p[1] ), p[2] ), i ) );
+	}
+	std::sort( order.begin(), order.end() );
+
+	int n = order.size();
+	_theta.resize( n );
+	_index.resize( n );
+	_px.resize( n );
+	_py.resize( n );
+	_pz.resize( n );
+	_mag.resize( n );
+
+	for ( int k = 0; k < n; k++ ) {
+		const double* p = _pfo[ order[k].second ]->getMomentum();
+		_theta[k] = order[k].first;
+		_index[k] = order[k].second;
+		_px[k]    = p[0];
+		_py[k]    = p[1];
+		_pz[k]    = p[2];
+		_mag[k]   = std::sqrt( p[0]*p[0] + p[1]*p[1] + p[2]*p[2] );   // as TVector3::Mag()
+	}
+}
+
+void PFOConeIndex::findInCone( const double* p, float cosConeAngle, std::vector<int>& inCone ) const {
+
+	inCone.clear();
+
+	const double mag = std::sqrt( p[0]*p[0] + p[1]*p[1] + p[2]*p[2] );
+	if ( mag == 0 ) return;
+
+	// half-angle of the cone, widened to cover the float rounding of the cosine
+	const double cosCut = std::max( -1., std::min( 1., double(cosConeAngle) - 1e-6 ) );
+	const double halfAngle = std::acos( cosCut ) + 1e-6;
+
+	const double theta = std::atan2( std::sqrt( p[0]*p[0] + p[1]*p[1] ), p[2] );
+
+	int kBegin = std::lower_bound( _theta.begin(), _theta.end(), theta - halfAngle ) - _theta.begin();
+	int kEnd   = std::upper_bound( _theta.begin(), _theta.end(), theta + halfAngle ) - _theta.begin();
+
+	for ( int k = kBegin; k < kEnd; k++ ) {
+		if ( !_active[ _index[k] ] ) continue;
+
+		// same expression as TVector3: P.Dot( P_i )/(P.Mag()*P_i.Mag())
+		float cosTheta = ( p[0]*_px[k] + p[1]*_py[k] + p[2]*_pz[k] )/( mag*_mag[k] );
+		if ( cosTheta >= cosConeAngle )
+			inCone.push_back( _index[k] );
+	}
+
+	// collection order, so that sums over the cone are those of a scan over all PFOs
+	std::sort( inCone.begin(), inCone.end() );
+}
@@ -11,6 +11,9 @@
 #include <EVENT/ReconstructedParticle.h>
 #include <IMPL/ReconstructedParticleImpl.h>
 
+#include <vector>
+#include <unordered_map>
+
 #include "TROOT.h"
 #include "TVector3.h"
 #include "TLorentzVector.h"
@@ -20,6 +23,45 @@ using namespace std;
 
 namespace isolep{
 
+  // Truth lookups of one event: the serial of each MCParticle, the MC particles linked
+  // to each PFO (in the order and with the weights of LCRelationNavigator) together
+  // with the highest-energy link, and the original particle of each MCParticle, which
+  // is resolved once along the first parents and remembered for the whole chain.
+  // Fill it once per event and pass it to the overloads below instead of the collections.
+  class TruthContext {
+  public:
+    TruthContext() {}
+
+    void setEvent(LCCollection *colMCP, LCCollection *colMCTL);
+    void clear();
+
+    Int_t getMCSerial(MCParticle *mcPart) const;
+
+    Int_t getNumberOfLinks(ReconstructedParticle *recPart) const;
+    MCParticle* getLinkedMCParticle(ReconstructedParticle *recPart, Int_t iLink) const;
+    Float_t getLinkWeight(ReconstructedParticle *recPart, Int_t iLink) const;
+    Int_t getBestLink(ReconstructedParticle *recPart) const;  // -1 if not linked
+
+    Int_t getOriginalSerial(MCParticle *mcPart, Bool_t iHiggs = 0);
+    Int_t getOriginalSerialForZHH(MCParticle *mcPart);
+
+  private:
+    enum { kWZH = 0, kHiggs, kZHH, kNModes };
+
+    Int_t findPFO(ReconstructedParticle *recPart) const;
+    Int_t getOriginalSerial(MCParticle *mcPart, Int_t mode);
+
+    std::unordered_map<const MCParticle*, Int_t> _mcSerial {};
+    std::unordered_map<const LCObject*, Int_t> _pfoSlot {};
+    std::vector<Int_t> _linkBegin {};
+    std::vector<Int_t> _linkEnd {};
+    std::vector<MCParticle*> _linkMC {};
+    std::vector<Float_t> _linkWeight {};
+    std::vector<Int_t> _bestLink {};
+    std::vector<Int_t> _originalSerial[kNModes] {};
+    std::vector<Int_t> _walk {};
+  };
+
   Int_t getMCSerial(MCParticle *mcPart, LCCollection *colMCP);
   //MCParticle* getLinkedMCParticle(ReconstructedParticle *recPart, LCCollection *colMCTL, Double_t &weight, Int_t &nMCTL);
   Int_t getLinkedMCParticle(ReconstructedParticle *recPart, LCCollection *colMCTL, Double_t &weight, Int_t &nMCTL);
@@ -27,6 +69,8 @@ namespace isolep{
   Int_t getOriginalSerial(MCParticle *mcPart, LCCollection *colMCP, Bool_t iHiggs = 0);
   Int_t getOriginalSerial(ReconstructedParticle *recPart, LCCollection *colMCTL, LCCollection *colMCP, Bool_t iHiggs = 0);
   Int_t getOriginalSerialForZHH(MCParticle *mcPart, LCCollection *colMCP);
+  Int_t getLinkedMCParticle(ReconstructedParticle *recPart, const TruthContext &truth, Double_t &weight, Int_t &nMCTL);
+  Int_t getOriginalSerial(ReconstructedParticle *recPart, TruthContext &truth, Bool_t iHiggs = 0);
   Double_t getConeEnergy(ReconstructedParticle *recPart, LCCollection *colPFO, Double_t cosCone);
   Double_t getConeEnergy(ReconstructedParticle *recPart, LCCollection *colPFO, Double_t cosCone, Int_t mode);
   Double_t getConeEnergy(ReconstructedParticle *recPart, LCCollection *colPFO, Double_t cosCone, 
@@ -54,18 +98,25 @@ namespace isolep{
   Int_t calculateEnergyComponents(LCCollection *colMC, LCCollection *colMCTL, ReconstructedParticle *jet, Double_t energyComponents[4]);
   Int_t calculateEnergyComponents(LCCollection *colMC, LCCollection *colMCTL, ReconstructedParticle *jet, Double_t energyComponents[4],
 				  Int_t iColor1, Int_t iColor2, Int_t iColor3);
+  Int_t calculateEnergyComponents(TruthContext &truth, ReconstructedParticle *jet, Double_t energyComponents[4]);
+  Int_t calculateEnergyComponents(TruthContext &truth, ReconstructedParticle *jet, Double_t energyComponents[4],
+				  Int_t iColor1, Int_t iColor2, Int_t iColor3);
 
   Double_t getLikelihood(TString fname, TString hist, Double_t mass);
   
   void listMCParticles(LCCollection *colMC);
   
   Bool_t isOverlay(ReconstructedParticle *pfo, LCCollection *colMCTL);
+  Bool_t isOverlay(ReconstructedParticle *pfo, const TruthContext &truth);
   
   void dumpJetParticles(ReconstructedParticle *jet, LCCollection *colMC, LCCollection *colMCTL);
+  void dumpJetParticles(ReconstructedParticle *jet, const TruthContext &truth);
   
   Int_t getVertexComponents(LCCollection *colMC, LCCollection *colMCTL, ReconstructedParticle *vetex, Double_t energyComponents[2], Int_t nparticles[2]);
+  Int_t getVertexComponents(const TruthContext &truth, ReconstructedParticle *vertex, Double_t energyComponents[2], Int_t nparticles[2]);
 
   Int_t isVertexFromOverlay( ReconstructedParticle *vertex, LCCollection *colMC, LCCollection *colMCTL);
+  Int_t isVertexFromOverlay( ReconstructedParticle *vertex, const TruthContext &truth);
   
   Double_t getJetDistance( ReconstructedParticle *i, ReconstructedParticle *j, TString algorithm, Double_t R);
   
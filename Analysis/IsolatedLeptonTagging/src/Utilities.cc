@@ -7,9 +7,11 @@
 #include "TFile.h"
 #include "TH1D.h"
 #include "TLorentzVector.h"
-#include <UTIL/LCRelationNavigator.h>
+#include <EVENT/LCRelation.h>
 #include <IMPL/ReconstructedParticleImpl.h>
 #include <iomanip>
+#include <map>
+#include <vector>
 
 namespace isolep{
 
@@ -29,25 +31,16 @@ Int_t getMCSerial(MCParticle *mcPart, LCCollection *colMCP) {
 
 Int_t getLinkedMCParticle(ReconstructedParticle *recPart, LCCollection *colMCTL, Double_t &weight, Int_t &nMCTL) {
   // get the corresponding MC particle of one reconstructed particle using the MCTruthLinker information
-  //  MCParticle *mcLinkedParticle = NULL;
-  Int_t iLink = -1;
-  LCRelationNavigator *navMCTL = new LCRelationNavigator(colMCTL);
-  LCObjectVec vecMCTL = navMCTL->getRelatedToObjects(recPart);
-  FloatVec vecWgtMCTL = navMCTL->getRelatedToWeights(recPart);
-  Double_t mcEnergyMax = -1.0;
-  weight = 0.;
-  nMCTL = vecMCTL.size();
-  for (Int_t i=0;i<nMCTL;i++) {
-    MCParticle *mcPart = dynamic_cast<MCParticle *>(vecMCTL[i]);
-    Double_t mcEnergy = mcPart->getEnergy();
-    if (mcEnergy > mcEnergyMax) {   // find the linked particle with largest energy as the mc truth particle
-      mcEnergyMax = mcEnergy;
-      //      mcLinkedParticle = mcPart;
-      weight = vecWgtMCTL[i];
-      iLink = i;
-    }
-  }
-  //  return mcLinkedParticle;
+  TruthContext truth;
+  truth.setEvent(0,colMCTL);
+  return getLinkedMCParticle(recPart,truth,weight,nMCTL);
+}
+
+Int_t getLinkedMCParticle(ReconstructedParticle *recPart, const TruthContext &truth, Double_t &weight, Int_t &nMCTL) {
+  // the linked particle with largest energy is taken as the mc truth particle
+  Int_t iLink = truth.getBestLink(recPart);
+  nMCTL = truth.getNumberOfLinks(recPart);
+  weight = iLink < 0 ? 0. : truth.getLinkWeight(recPart,iLink);
   return iLink;
 }
 
@@ -96,14 +89,18 @@ Int_t getOriginalSerial(MCParticle *mcPart, LCCollection *colMCP, Bool_t iHiggs)
 }
 
 Int_t getOriginalSerial(ReconstructedParticle *recPart, LCCollection *colMCTL, LCCollection *colMCP, Bool_t iHiggs) {
+  TruthContext truth;
+  truth.setEvent(colMCP,colMCTL);
+  return getOriginalSerial(recPart,truth,iHiggs);
+}
+
+Int_t getOriginalSerial(ReconstructedParticle *recPart, TruthContext &truth, Bool_t /*iHiggs*/) {
   // get the serial number of the original particle where the PFO comes from
 
   Int_t originalSerial = -1;
-  LCRelationNavigator *navMCTL = new LCRelationNavigator(colMCTL);
-  LCObjectVec vecMCTL = navMCTL->getRelatedToObjects(recPart);
-  if (vecMCTL.size() > 0) {
-    MCParticle *mcPart = dynamic_cast<MCParticle *>(vecMCTL[0]);
-    originalSerial = getOriginalSerialForZHH(mcPart,colMCP);
+  if (truth.getNumberOfLinks(recPart) > 0) {
+    MCParticle *mcPart = truth.getLinkedMCParticle(recPart,0);
+    originalSerial = truth.getOriginalSerialForZHH(mcPart);
   }
   return originalSerial;
 }
@@ -131,6 +128,173 @@ Int_t getOriginalSerialForZHH(MCParticle *mcPart, LCCollection *colMCP) {
   return originalSerial;
 }
 
+void TruthContext::clear() {
+
+  _mcSerial.clear();
+  _pfoSlot.clear();
+  _linkBegin.clear();
+  _linkEnd.clear();
+  _linkMC.clear();
+  _linkWeight.clear();
+  _bestLink.clear();
+  for (Int_t m=0;m<kNModes;m++) {
+    _originalSerial[m].clear();
+  }
+}
+
+void TruthContext::setEvent(LCCollection *colMCP, LCCollection *colMCTL) {
+
+  clear();
+
+  if (colMCP) {
+    Int_t nMCP = colMCP->getNumberOfElements();
+    _mcSerial.reserve(nMCP);
+    for (Int_t i=0;i<nMCP;i++) {
+      MCParticle *mcp = dynamic_cast<MCParticle*>(colMCP->getElementAt(i));
+      _mcSerial.insert(std::make_pair(mcp,i));  // the first occurrence, as the scan of getMCSerial
+    }
+    for (Int_t m=0;m<kNModes;m++) {
+      _originalSerial[m].assign(nMCP,-2);  // -2: not resolved yet
+    }
+  }
+
+  if (!colMCTL) return;
+
+  // number the PFOs in the order of their first relation and count their relations
+  Int_t nRel = colMCTL->getNumberOfElements();
+  std::vector<LCRelation*> relations(nRel);
+  std::vector<Int_t> slots(nRel,-1);
+  std::vector<Int_t> counts;
+  for (Int_t i=0;i<nRel;i++) {
+    relations[i] = dynamic_cast<LCRelation*>(colMCTL->getElementAt(i));
+    if (!relations[i]->getFrom() || !relations[i]->getTo()) continue;
+    std::pair<std::unordered_map<const LCObject*, Int_t>::iterator, bool> slot =
+      _pfoSlot.insert(std::make_pair(relations[i]->getFrom(),Int_t(counts.size())));
+    if (slot.second) counts.push_back(0);
+    slots[i] = slot.first->second;
+    counts[slots[i]]++;
+  }
+
+  Int_t nPFO = counts.size();
+  _linkBegin.resize(nPFO+1);
+  _linkBegin[0] = 0;
+  for (Int_t k=0;k<nPFO;k++) {
+    _linkBegin[k+1] = _linkBegin[k] + counts[k];
+  }
+  _linkEnd.assign(_linkBegin.begin(),_linkBegin.end()-1);
+  _linkMC.resize(_linkBegin[nPFO]);
+  _linkWeight.resize(_linkBegin[nPFO]);
+
+  for (Int_t i=0;i<nRel;i++) {
+    Int_t k = slots[i];
+    if (k < 0) continue;
+    MCParticle *mcPart = dynamic_cast<MCParticle*>(relations[i]->getTo());
+    // like LCRelationNavigator, a repeated PFO-MCParticle pair is one link with the summed weight
+    Int_t j = _linkBegin[k];
+    while (j < _linkEnd[k] && _linkMC[j] != mcPart) j++;
+    if (j < _linkEnd[k]) {
+      _linkWeight[j] += relations[i]->getWeight();
+    }
+    else {
+      _linkMC[j] = mcPart;
+      _linkWeight[j] = relations[i]->getWeight();
+      _linkEnd[k]++;
+    }
+  }
+
+  // the linked particle with the largest energy, as in getLinkedMCParticle
+  _bestLink.assign(nPFO,-1);
+  for (Int_t k=0;k<nPFO;k++) {
+    Double_t mcEnergyMax = -1.0;
+    for (Int_t j=_linkBegin[k];j<_linkEnd[k];j++) {
+      Double_t mcEnergy = _linkMC[j]->getEnergy();
+      if (mcEnergy > mcEnergyMax) {
+	mcEnergyMax = mcEnergy;
+	_bestLink[k] = j - _linkBegin[k];
+      }
+    }
+  }
+}
+
+Int_t TruthContext::getMCSerial(MCParticle *mcPart) const {
+  std::unordered_map<const MCParticle*, Int_t>::const_iterator it = _mcSerial.find(mcPart);
+  return it != _mcSerial.end() ? it->second : -1;
+}
+
+Int_t TruthContext::findPFO(ReconstructedParticle *recPart) const {
+  std::unordered_map<const LCObject*, Int_t>::const_iterator it = _pfoSlot.find(recPart);
+  return it != _pfoSlot.end() ? it->second : -1;
+}
+
+Int_t TruthContext::getNumberOfLinks(ReconstructedParticle *recPart) const {
+  Int_t k = findPFO(recPart);
+  return k < 0 ? 0 : _linkEnd[k] - _linkBegin[k];
+}
+
+MCParticle* TruthContext::getLinkedMCParticle(ReconstructedParticle *recPart, Int_t iLink) const {
+  return _linkMC[_linkBegin[findPFO(recPart)] + iLink];
+}
+
+Float_t TruthContext::getLinkWeight(ReconstructedParticle *recPart, Int_t iLink) const {
+  return _linkWeight[_linkBegin[findPFO(recPart)] + iLink];
+}
+
+Int_t TruthContext::getBestLink(ReconstructedParticle *recPart) const {
+  Int_t k = findPFO(recPart);
+  return k < 0 ? -1 : _bestLink[k];
+}
+
+Int_t TruthContext::getOriginalSerial(MCParticle *mcPart, Bool_t iHiggs) {
+  return getOriginalSerial(mcPart, iHiggs ? Int_t(kHiggs) : Int_t(kWZH));
+}
+
+Int_t TruthContext::getOriginalSerialForZHH(MCParticle *mcPart) {
+  return getOriginalSerial(mcPart, Int_t(kZHH));
+}
+
+Int_t TruthContext::getOriginalSerial(MCParticle *mcPart, Int_t mode) {
+  // the same walk along the first parents as the collection versions; every particle
+  // passed on the way has the same original particle, so the result is stored for all
+  std::vector<Int_t> &cache = _originalSerial[mode];
+  _walk.clear();
+  Int_t originalSerial = -1;
+  while (true) {
+    Int_t serial = getMCSerial(mcPart);
+    if (serial >= 0) {
+      if (cache[serial] != -2) {
+	originalSerial = cache[serial];
+	break;
+      }
+      _walk.push_back(serial);
+    }
+    if (mcPart->getParents().size() == 0) {
+      originalSerial = serial;
+      break;
+    }
+    MCParticle *mother = mcPart->getParents()[0];
+    Int_t pdg = mother->getPDG();
+    Bool_t isOriginal = kFALSE;
+    if (mode == kWZH) {
+      isOriginal = abs(pdg) == 24 || abs(pdg) == 23 || abs(pdg) == 25;
+    }
+    else if (mode == kHiggs) {
+      isOriginal = abs(pdg) == 25;
+    }
+    else if (abs(pdg) == 25 && mother->getParents().size() > 0) {
+      isOriginal = mother->getParents()[0]->getPDG() == 11;
+    }
+    if (isOriginal) {
+      originalSerial = getMCSerial(mother);
+      break;
+    }
+    mcPart = mother;
+  }
+  for (UInt_t i=0;i<_walk.size();i++) {
+    cache[_walk[i]] = originalSerial;
+  }
+  return originalSerial;
+}
+
 Int_t getLeptonID(ReconstructedParticle *recPart) {
   // electron identification using ratios of energies deposited in ECal, HCal and Momentum
   Int_t iLeptonType = 0;
@@ -606,6 +770,12 @@ Double_t jetFunction( TLorentzVector lortz, float virtual_scale) {
 }
 
 Int_t calculateEnergyComponents(LCCollection *colMC, LCCollection *colMCTL, ReconstructedParticle *jet, Double_t energyComponents[4]) {
+  TruthContext truth;
+  truth.setEvent(colMC,colMCTL);
+  return calculateEnergyComponents(truth,jet,energyComponents);
+}
+
+Int_t calculateEnergyComponents(TruthContext &truth, ReconstructedParticle *jet, Double_t energyComponents[4]) {
   // calculate energies from different color singlets in a jet
   // [0]: from first Higgs; [1]: from second Higgs; [2]: from other color-singlet (mostly Z); [3]: from overlay
 
@@ -613,18 +783,15 @@ Int_t calculateEnergyComponents(LCCollection *colMC, LCCollection *colMCTL, Reco
     energyComponents[i] = 0.;
   }
 
-  LCRelationNavigator *navMCTL = new LCRelationNavigator(colMCTL);
-
   Int_t np = jet->getParticles().size();
   //  cerr << "Debug: Npar in jet = " << np << endl;
   for (Int_t i=0;i<np;i++) {
     ReconstructedParticle *pfo = dynamic_cast<ReconstructedParticle *>(jet->getParticles()[i]);
     Double_t energy = pfo->getEnergy();
-    LCObjectVec vecMCTL = navMCTL->getRelatedToObjects(pfo);
-    //    cerr << "Debug: energy = " << energy << " ; mclink = " << vecMCTL.size() << endl;
-    if (vecMCTL.size() > 0) {
-      MCParticle *mcPart = dynamic_cast<MCParticle *>(vecMCTL[0]);
-      Int_t originalSerial = getOriginalSerialForZHH(mcPart,colMC);
+    //    cerr << "Debug: energy = " << energy << " ; mclink = " << truth.getNumberOfLinks(pfo) << endl;
+    if (truth.getNumberOfLinks(pfo) > 0) {
+      MCParticle *mcPart = truth.getLinkedMCParticle(pfo,0);
+      Int_t originalSerial = truth.getOriginalSerialForZHH(mcPart);
       //      cerr << "Debug: Original Serial = " << originalSerial << endl;
       if (originalSerial == 8) { // 1st H
 	energyComponents[0] += energy;
@@ -658,6 +825,13 @@ Int_t calculateEnergyComponents(LCCollection *colMC, LCCollection *colMCTL, Reco
 
 Int_t calculateEnergyComponents(LCCollection *colMC, LCCollection *colMCTL, ReconstructedParticle *jet, Double_t energyComponents[4],
 				Int_t iColor1, Int_t iColor2, Int_t iColor3) {
+  TruthContext truth;
+  truth.setEvent(colMC,colMCTL);
+  return calculateEnergyComponents(truth,jet,energyComponents,iColor1,iColor2,iColor3);
+}
+
+Int_t calculateEnergyComponents(TruthContext &truth, ReconstructedParticle *jet, Double_t energyComponents[4],
+				Int_t iColor1, Int_t iColor2, Int_t iColor3) {
   // calculate energies from different color singlets in a jet
   // [0]: from first Higgs; [1]: from second Higgs; [2]: from other color-singlet (mostly Z); [3]: from overlay
   // for qqH
@@ -666,18 +840,15 @@ Int_t calculateEnergyComponents(LCCollection *colMC, LCCollection *colMCTL, Reco
     energyComponents[i] = 0.;
   }
 
-  LCRelationNavigator *navMCTL = new LCRelationNavigator(colMCTL);
-
   Int_t np = jet->getParticles().size();
   //  cerr << "Debug: Npar in jet = " << np << endl;
   for (Int_t i=0;i<np;i++) {
     ReconstructedParticle *pfo = dynamic_cast<ReconstructedParticle *>(jet->getParticles()[i]);
     Double_t energy = pfo->getEnergy();
-    LCObjectVec vecMCTL = navMCTL->getRelatedToObjects(pfo);
-    //    cerr << "Debug: energy = " << energy << " ; mclink = " << vecMCTL.size() << endl;
-    if (vecMCTL.size() > 0) {
-      MCParticle *mcPart = dynamic_cast<MCParticle *>(vecMCTL[0]);
-      Int_t originalSerial = getOriginalSerialForZHH(mcPart,colMC);
+    //    cerr << "Debug: energy = " << energy << " ; mclink = " << truth.getNumberOfLinks(pfo) << endl;
+    if (truth.getNumberOfLinks(pfo) > 0) {
+      MCParticle *mcPart = truth.getLinkedMCParticle(pfo,0);
+      Int_t originalSerial = truth.getOriginalSerialForZHH(mcPart);
       //      cerr << "Debug: Original Serial = " << originalSerial << endl;
       if (originalSerial == iColor1) { // H
 	energyComponents[0] += energy;
@@ -709,32 +880,142 @@ Int_t calculateEnergyComponents(LCCollection *colMC, LCCollection *colMCTL, Reco
   return iMax+1;
 }
 
-Double_t getLikelihood(TString fname, TString hist, Double_t mass)
-{
+namespace {
+
+// Adaptive-bandwidth kernel density estimate of a mass histogram. The
+// per-bin kernels are read once; the density and its derivative are
+// tabulated on a grid finer than the narrowest kernel and interpolated
+// with cubic Hermite polynomials. Outside the grid the kernels are summed.
+class LikelihoodTable {
+public:
+  void load(TString fname, TString hist);
+  Double_t evaluate(Double_t mass) const;
+private:
+  Double_t sumKernels(Double_t mass, Double_t *derivative) const;
+
+  std::vector<Double_t> _center;   // bin centre
+  std::vector<Double_t> _width;    // kernel width
+  std::vector<Double_t> _norm;     // kernel normalisation
+  Double_t _xmin = 0.;
+  Double_t _step = 0.;
+  std::vector<Double_t> _f;        // density on the grid
+  std::vector<Double_t> _df;       // derivative of the density on the grid
+};
+
+void LikelihoodTable::load(TString fname, TString hist) {
 
   TFile file(fname);
   TH1D *hmass = dynamic_cast<TH1D *>(file.Get(hist));
+  if (!hmass) {
+    std::cerr << "getLikelihood: histogram " << hist << " not found in " << fname << std::endl;
+    return;
+  }
   Int_t nbin = hmass->GetNbinsX();
   Double_t ntot = hmass->GetEntries();
   Double_t epsilon = 0.001;
-  Double_t prob = 0.;
   for (Int_t j=0;j<nbin;j++) {
     Double_t nj = hmass->GetBinContent(j+1);
+    if (nj == 0.) continue;   // empty bins do not contribute
     Double_t tj = hmass->GetBinCenter(j+1);
     Double_t delta = hmass->GetBinWidth(j+1);
     Double_t hj = TMath::Power(4./3/ntot,1./5)*delta*TMath::Sqrt(ntot/(nj+epsilon));
-    Double_t density = 1.0*nj/ntot/TMath::Sqrt(2*3.1416)/hj*TMath::Exp(-(mass-tj)*(mass-tj)/2/hj/hj);
-    //    cerr << "hj: " << hj << " nj: " << nj << " tj: " << tj 
-    //	 << " delta: " << delta << " mass: " << mass << endl;
-    //    cerr << "Prob Density: " << density << endl;
-    prob += density;
+    _center.push_back(tj);
+    _width.push_back(hj);
+    _norm.push_back(1.0*nj/ntot/TMath::Sqrt(2*3.1416)/hj);
   }
-
   file.Close();
-  //  cerr << "Prob: " << prob <<endl; 
+
+  if (_center.empty()) return;
+
+  // grid over +-8 kernel widths, four points per narrowest kernel width
+  const Double_t range = 8.;
+  const Int_t maxPoints = 100000;
+  Double_t xmin = _center[0] - range*_width[0];
+  Double_t xmax = _center[0] + range*_width[0];
+  Double_t hmin = _width[0];
+  for (UInt_t j=1;j<_center.size();j++) {
+    xmin = TMath::Min(xmin, _center[j] - range*_width[j]);
+    xmax = TMath::Max(xmax, _center[j] + range*_width[j]);
+    hmin = TMath::Min(hmin, _width[j]);
+  }
+  _xmin = xmin;
+  _step = hmin/4.;
+  Int_t npoints = Int_t((xmax - xmin)/_step) + 2;
+  if (npoints > maxPoints) {
+    npoints = maxPoints;
+    _step = (xmax - xmin)/(npoints - 1);
+  }
+
+  _f.resize(npoints);
+  _df.resize(npoints);
+  for (Int_t i=0;i<npoints;i++) {
+    _f[i] = sumKernels(_xmin + i*_step, &_df[i]);
+  }
+
+  // compare with the direct sum halfway between the grid points, where the
+  // interpolation is least precise; sum directly if the table is off
+  const Double_t tolerance = 1e-4;
+  Double_t fmax = 0.;
+  for (Int_t i=0;i<npoints;i++) fmax = TMath::Max(fmax, _f[i]);
+  Double_t maxError = 0.;
+  for (Int_t i=0;i<npoints-1;i++) {
+    Double_t mass = _xmin + (i + 0.5)*_step;
+    maxError = TMath::Max(maxError, TMath::Abs(evaluate(mass) - sumKernels(mass, 0)));
+  }
+  if (maxError > tolerance*fmax) {
+    std::cerr << "getLikelihood: interpolation of " << hist << " in " << fname << " is off by "
+	      << maxError/fmax << " of the peak density, using the kernel sum" << std::endl;
+    _f.clear();
+    _df.clear();
+  }
+}
+
+Double_t LikelihoodTable::sumKernels(Double_t mass, Double_t *derivative) const {
+
+  Double_t prob = 0.;
+  Double_t dprob = 0.;
+  for (UInt_t j=0;j<_center.size();j++) {
+    Double_t hj = _width[j];
+    Double_t density = _norm[j]*TMath::Exp(-(mass-_center[j])*(mass-_center[j])/2/hj/hj);
+    prob += density;
+    dprob -= density*(mass-_center[j])/hj/hj;
+  }
+  if (derivative) *derivative = dprob;
   return prob;
 }
 
+Double_t LikelihoodTable::evaluate(Double_t mass) const {
+
+  if (_f.size() < 2) return sumKernels(mass, 0);
+
+  Double_t x = (mass - _xmin)/_step;
+  if (x < 0. || x >= _f.size() - 1) return sumKernels(mass, 0);
+
+  Int_t i = Int_t(x);
+  Double_t u = x - i;
+  Double_t u2 = u*u;
+  Double_t u3 = u2*u;
+  return (2*u3 - 3*u2 + 1)*_f[i] + (u3 - 2*u2 + u)*_step*_df[i]
+    + (-2*u3 + 3*u2)*_f[i+1] + (u3 - u2)*_step*_df[i+1];
+}
+
+}
+
+Double_t getLikelihood(TString fname, TString hist, Double_t mass)
+{
+  // the (file, histogram) pairs are read and tabulated on first use
+  static std::map<std::pair<TString,TString>, LikelihoodTable> tables;
+
+  std::pair<TString,TString> key(fname, hist);
+  std::map<std::pair<TString,TString>, LikelihoodTable>::iterator it = tables.find(key);
+  if (it == tables.end()) {
+    it = tables.insert(std::make_pair(key, LikelihoodTable())).first;
+    it->second.load(fname, hist);
+  }
+
+  return it->second.evaluate(mass);
+}
+
 void listMCParticles(LCCollection *colMC) {
   // a detail look into MC particles and their decay chain
   if (!colMC) {
@@ -780,12 +1061,18 @@ void listMCParticles(LCCollection *colMC) {
 
   Bool_t isOverlay(ReconstructedParticle *pfo, LCCollection *colMCTL) {
 
+  TruthContext truth;
+  truth.setEvent(0,colMCTL);
+  return isOverlay(pfo,truth);
+
+}
+
+  Bool_t isOverlay(ReconstructedParticle *pfo, const TruthContext &truth) {
+
   Bool_t iOverlay = false;
 
-  LCRelationNavigator *navMCTL = new LCRelationNavigator(colMCTL);
-  LCObjectVec vecMCTL = navMCTL->getRelatedToObjects(pfo);
-  if (vecMCTL.size() > 0) {
-    MCParticle *mcPart = dynamic_cast<MCParticle *>(vecMCTL[0]);
+  if (truth.getNumberOfLinks(pfo) > 0) {
+    MCParticle *mcPart = truth.getLinkedMCParticle(pfo,0);
     if (mcPart->isOverlay()) iOverlay = true;
   }
   
@@ -794,9 +1081,13 @@ void listMCParticles(LCCollection *colMC) {
 }
 
   void dumpJetParticles(ReconstructedParticle *jet, LCCollection *colMC, LCCollection *colMCTL) {
-    // list the particles of jets
+    TruthContext truth;
+    truth.setEvent(colMC,colMCTL);
+    dumpJetParticles(jet,truth);
+  }
 
-    LCRelationNavigator *navMCTL = new LCRelationNavigator(colMCTL);
+  void dumpJetParticles(ReconstructedParticle *jet, const TruthContext &truth) {
+    // list the particles of jets
 
     TLorentzVector lortz = TLorentzVector(jet->getMomentum(),jet->getEnergy());
     cerr << "----Particles of the Jet: (E,Px,Py,Pz) = (" << lortz.E() << "," << lortz.Px() << ","
@@ -808,9 +1099,8 @@ void listMCParticles(LCCollection *colMC) {
 	 << setw(10) << "Original" << setw(8) << "Overlay" << setw(8) << "FromSim" << endl;
     for (Int_t i=0;i<np;i++) {
       ReconstructedParticle *pfo = dynamic_cast<ReconstructedParticle *>(jet->getParticles()[i]);
-      LCObjectVec vecMCTL = navMCTL->getRelatedToObjects(pfo);
-      if (vecMCTL.size() > 0) {
-	MCParticle *mcPart = dynamic_cast<MCParticle *>(vecMCTL[0]);
+      if (truth.getNumberOfLinks(pfo) > 0) {
+	MCParticle *mcPart = truth.getLinkedMCParticle(pfo,0);
 	Int_t pdg = mcPart->getPDG();
 	Int_t nparents = mcPart->getParents().size();
 	Int_t motherpdg = 0;
@@ -843,6 +1133,12 @@ void listMCParticles(LCCollection *colMC) {
   // *******************************************************
   // *******************************************************
   Int_t getVertexComponents(LCCollection *colMC, LCCollection *colMCTL, ReconstructedParticle *vertex, Double_t energyComponents[2], Int_t nparticles[2]) {
+    TruthContext truth;
+    truth.setEvent(colMC,colMCTL);
+    return getVertexComponents(truth,vertex,energyComponents,nparticles);
+  }
+
+  Int_t getVertexComponents(const TruthContext &truth, ReconstructedParticle *vertex, Double_t energyComponents[2], Int_t nparticles[2]) {
   // calculate energies from signal particles or overlay in a vertex
   // [0]: from signal; [1]: from overlay
 
@@ -851,15 +1147,12 @@ void listMCParticles(LCCollection *colMC) {
       nparticles[i] = 0;
     }
     
-    LCRelationNavigator *navMCTL = new LCRelationNavigator(colMCTL);
-    
     Int_t np = vertex->getParticles().size();
     for (Int_t i=0;i<np;i++) {
       ReconstructedParticle *pfo = dynamic_cast<ReconstructedParticle *>(vertex->getParticles()[i]);
       Double_t energy = pfo->getEnergy();
-      LCObjectVec vecMCTL = navMCTL->getRelatedToObjects(pfo);
-      if (vecMCTL.size() > 0) {
-	MCParticle *mcPart = dynamic_cast<MCParticle *>(vecMCTL[0]);
+      if (truth.getNumberOfLinks(pfo) > 0) {
+	MCParticle *mcPart = truth.getLinkedMCParticle(pfo,0);
 	if (mcPart->isOverlay()) { // overlay
 	  energyComponents[1] += energy;
 	  nparticles[1] += 1;
@@ -891,6 +1184,12 @@ void listMCParticles(LCCollection *colMC) {
 
   }
 
+  Int_t isVertexFromOverlay( ReconstructedParticle *vertex, const TruthContext &truth) {
+    Double_t energy[2];
+    Int_t np[2];
+    return getVertexComponents(truth,vertex,energy,np);
+  }
+
   // *******************************************************
   // *******************************************************
   Double_t getJetDistance( ReconstructedParticle *i, ReconstructedParticle *j, TString algorithm, Double_t R) {
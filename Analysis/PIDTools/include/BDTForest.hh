@@ -0,0 +1,71 @@
+/*
+ * BDTForest.hh
+ *
+ * BDTForest
+ * Evaluates a boosted decision tree read from a TMVA weight file
+ * without going through TMVA::Reader. The trees are stored as flat
+ * node arrays (cut variable, cut value, children, leaf value), and
+ * the cuts and the combination of the trees follow MethodBDT, so the
+ * output is that of TMVA::Reader::EvaluateMVA.
+ *
+ * Only plain rectangular cuts are supported: weight files with input
+ * variable transformations or Fisher cuts are rejected by Load(), and
+ * the caller should fall back to TMVA::Reader for them.
+ */
+
+#ifndef BDTFOREST_HH_
+#define BDTFOREST_HH_ 1
+
+#include <string>
+#include <vector>
+
+class TXMLEngine;
+
+class BDTForest {
+public:
+  BDTForest() {};
+
+  // Read the forest of a TMVA BDT weight file. The input values are passed in
+  // the order of varNames, which are matched to the variable expressions of the
+  // weight file. Returns false if the file cannot be evaluated here.
+  bool Load(const std::string &fileName, const std::vector<std::string> &varNames);
+
+  bool IsLoaded() const { return _nTrees > 0; };
+  int GetNVariables() const { return _nInputs; };
+  int GetNTrees() const { return _nTrees; };
+
+  // MVA output for one candidate
+  double Evaluate(const float *x) const;
+
+  // MVA outputs of n candidates whose input values are stored one after the other in x.
+  // The candidates go through each tree together, which keeps the tree in cache.
+  void Evaluate(const float *x, int n, double *mva) const;
+
+  // n inputs, stored one after the other in x, for checking the forest against TMVA::Reader.
+  // Each cut variable is set to one of its cut values or to the float just below it, which
+  // are the values where a different reading of the cuts would change the output.
+  void GetProbes(int n, std::vector<float> &x) const;
+
+private:
+  bool ReadForest(TXMLEngine &xml, void *root, const std::vector<std::string> &varNames);
+  int ReadNode(TXMLEngine &xml, void *node, const std::vector<int> &inputIndex, int leafType);
+
+  // tree t spans the nodes [_treeBegin[t], _treeBegin[t+1]), its root first
+  std::vector<int> _treeBegin{};
+  std::vector<double> _boostWeight{};
+
+  // per node; _var is -1 for leaves
+  std::vector<int> _var{};
+  std::vector<float> _cut{};
+  std::vector<char> _cutType{};
+  std::vector<int> _left{};
+  std::vector<int> _right{};
+  std::vector<float> _leafValue{};
+
+  int _nInputs{};
+  int _nTrees{};
+  bool _gradBoost{};
+  double _norm{};
+};
+
+#endif
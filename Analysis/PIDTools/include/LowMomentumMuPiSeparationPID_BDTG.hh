@@ -2,6 +2,7 @@
 #define LowMomentumMuPiSeparationPID_BDTG_hh 1
 
 #include <string>
+#include <vector>
 
 #include "TLorentzVector.h"
 #include <EVENT/LCCollection.h>
@@ -10,6 +11,8 @@
 #include "EVENT/Track.h"
 #include "TMVA/Reader.h"
 
+#include "BDTForest.hh"
+
 class LowMomentumMuPiSeparationPID_BDTG{
 public:
   LowMomentumMuPiSeparationPID_BDTG(std::vector< std::string > fname);
@@ -28,7 +31,18 @@ public:
   Float_t mvaout{};
   bool _isValid{};
   EVENT::FloatVec shapes{};
-    
+
+private:
+  // output of the BDTG of momentum bin iBin (0: 0.2 GeV, ..., 18: 2.0 GeV)
+  Float_t evaluateMVA(int iBin);
+
+  // compare the forest of bin iBin with TMVA::Reader, false if they disagree
+  bool checkForest(int iBin);
+
+  // the forests read from the weight files; TMVA::Reader is used for the bins
+  // whose forest cannot be read or doesn't pass checkForest
+  std::vector<BDTForest> _forests{};
+  std::vector<TString> _methods{};
 };
 
 #endif 
@@ -0,0 +1,237 @@
+#include "BDTForest.hh"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+#include "TXMLEngine.h"
+
+
+namespace {
+
+  // what a leaf contributes, as DecisionTree::CheckEvent
+  enum { leafResponse, leafNodeType, leafPurity };
+
+  XMLNodePointer_t FindChild(TXMLEngine &xml, XMLNodePointer_t node, const char *name)
+  {
+    for (XMLNodePointer_t child = xml.GetChild(node); child; child = xml.GetNext(child)) {
+      if (!strcmp(xml.GetNodeName(child), name)) return child;
+    }
+    return 0;
+  }
+
+  // TMVA writes booleans as "True"/"False"
+  bool IsTrue(const char *value) { return value && (value[0] == 'T' || value[0] == 't' || value[0] == '1'); }
+
+  // TMVA reads Float_t attributes with operator>>, i.e. rounded once to float
+  float FloatAttr(TXMLEngine &xml, XMLNodePointer_t node, const char *name)
+  {
+    const char *value = xml.GetAttr(node, name);
+    return value ? strtof(value, 0) : 0.f;
+  }
+
+}
+
+
+bool BDTForest::Load(const std::string &fileName, const std::vector<std::string> &varNames)
+{
+  *this = BDTForest();
+
+  TXMLEngine xml;
+  XMLDocPointer_t doc = xml.ParseFile(fileName.c_str());
+  if (!doc) return false;
+
+  bool ok = ReadForest(xml, xml.DocGetRootElement(doc), varNames);
+  xml.FreeDoc(doc);
+
+  if (!ok) *this = BDTForest();
+  return ok;
+}
+
+
+bool BDTForest::ReadForest(TXMLEngine &xml, void *root, const std::vector<std::string> &varNames)
+{
+  const char *method = xml.GetAttr(root, "Method");
+  if (!method || strncmp(method, "BDT::", 5)) return false;
+
+  // classification only
+  XMLNodePointer_t info = FindChild(xml, root, "GeneralInfo");
+  for (XMLNodePointer_t n = info ? xml.GetChild(info) : 0; n; n = xml.GetNext(n)) {
+    const char *name = xml.GetAttr(n, "name");
+    const char *value = xml.GetAttr(n, "value");
+    if (name && value && !strcmp(name, "AnalysisType") && strcmp(value, "Classification")) return false;
+  }
+
+  // the options that decide how the trees are combined, with the defaults of MethodBDT
+  std::string boostType = "AdaBoost";
+  bool useYesNoLeaf = true;
+  bool useWeightedTrees = true;
+  XMLNodePointer_t options = FindChild(xml, root, "Options");
+  for (XMLNodePointer_t n = options ? xml.GetChild(options) : 0; n; n = xml.GetNext(n)) {
+    const char *name = xml.GetAttr(n, "name");
+    const char *value = xml.GetNodeContent(n);
+    if (!name || !value) continue;
+    if (!strcmp(name, "BoostType")) boostType = value;
+    else if (!strcmp(name, "UseYesNoLeaf")) useYesNoLeaf = IsTrue(value);
+    else if (!strcmp(name, "UseWeightedTrees")) useWeightedTrees = IsTrue(value);
+  }
+  _gradBoost = (boostType == "Grad");
+
+  // input variable transformations are applied by TMVA::Reader, not here
+  XMLNodePointer_t transformations = FindChild(xml, root, "Transformations");
+  if (transformations && xml.GetIntAttr(transformations, "NTransformations") > 0) return false;
+
+  // position of each variable of the weight file among the inputs
+  XMLNodePointer_t variables = FindChild(xml, root, "Variables");
+  if (!variables) return false;
+  std::vector<int> inputIndex(xml.GetIntAttr(variables, "NVar"), -1);
+  for (XMLNodePointer_t n = xml.GetChild(variables); n; n = xml.GetNext(n)) {
+    if (strcmp(xml.GetNodeName(n), "Variable")) continue;
+    int ivar = xml.GetIntAttr(n, "VarIndex");
+    const char *expression = xml.GetAttr(n, "Expression");
+    if (ivar < 0 || ivar >= int(inputIndex.size()) || !expression) return false;
+    for (unsigned i=0; i<varNames.size(); i++) {
+      if (varNames[i] == expression) inputIndex[ivar] = i;
+    }
+  }
+  for (unsigned ivar=0; ivar<inputIndex.size(); ivar++) {
+    if (inputIndex[ivar] < 0) return false;
+  }
+  _nInputs = varNames.size();
+
+  XMLNodePointer_t weights = FindChild(xml, root, "Weights");
+  if (!weights) return false;
+
+  // regression trees return the node response, the others the node type or purity
+  int analysisType = 0;
+  if (xml.HasAttr(weights, "AnalysisType")) analysisType = xml.GetIntAttr(weights, "AnalysisType");
+  else if (xml.HasAttr(weights, "TreeType")) analysisType = xml.GetIntAttr(weights, "TreeType");
+  if (analysisType != 0 && analysisType != 1) return false;
+
+  int leafType = leafPurity;
+  if (analysisType == 1) leafType = leafResponse;
+  else if (!_gradBoost && useYesNoLeaf) leafType = leafNodeType;
+
+  _treeBegin.push_back(0);
+  for (XMLNodePointer_t tree = xml.GetChild(weights); tree; tree = xml.GetNext(tree)) {
+    if (strcmp(xml.GetNodeName(tree), "BinaryTree")) continue;
+
+    XMLNodePointer_t rootNode = FindChild(xml, tree, "Node");
+    if (!rootNode || ReadNode(xml, rootNode, inputIndex, leafType) < 0) return false;
+
+    const char *boostWeight = xml.GetAttr(tree, "boostWeight");
+    _boostWeight.push_back(boostWeight ? strtod(boostWeight, 0) : 1.);
+    _treeBegin.push_back(_var.size());
+  }
+  _nTrees = _boostWeight.size();
+
+  // MethodBDT sums the boost weights in tree order
+  _norm = 0.;
+  for (int t=0; t<_nTrees; t++) {
+    if (!useWeightedTrees) _boostWeight[t] = 1.;
+    _norm += _boostWeight[t];
+  }
+
+  return _nTrees > 0;
+}
+
+
+int BDTForest::ReadNode(TXMLEngine &xml, void *node, const std::vector<int> &inputIndex, int leafType)
+{
+  const int k = _var.size();
+  _var.push_back(-1);
+  _cut.push_back(0.f);
+  _cutType.push_back(0);
+  _left.push_back(-1);
+  _right.push_back(-1);
+  _leafValue.push_back(0.f);
+
+  const int nodeType = xml.GetIntAttr(node, "nType");
+
+  if (nodeType != 0) {
+    if (leafType == leafResponse) _leafValue[k] = FloatAttr(xml, node, "res");
+    else if (leafType == leafNodeType) _leafValue[k] = nodeType;
+    else _leafValue[k] = FloatAttr(xml, node, "purity");
+    return k;
+  }
+
+  // intermediate node: a cut on one variable, Fisher cuts are not supported
+  if (xml.HasAttr(node, "NCoef") && xml.GetIntAttr(node, "NCoef") > 0) return -1;
+  const int ivar = xml.GetIntAttr(node, "IVar");
+  if (ivar < 0 || ivar >= int(inputIndex.size())) return -1;
+
+  _var[k] = inputIndex[ivar];
+  _cut[k] = FloatAttr(xml, node, "Cut");
+  _cutType[k] = xml.GetIntAttr(node, "cType") != 0;
+
+  for (XMLNodePointer_t child = xml.GetChild(node); child; child = xml.GetNext(child)) {
+    if (strcmp(xml.GetNodeName(child), "Node")) continue;
+    const char *pos = xml.GetAttr(child, "pos");
+    if (!pos) return -1;
+    int daughter = ReadNode(xml, child, inputIndex, leafType);
+    if (daughter < 0) return -1;
+    if (pos[0] == 'l') _left[k] = daughter;
+    else if (pos[0] == 'r') _right[k] = daughter;
+  }
+
+  return (_left[k] < 0 || _right[k] < 0) ? -1 : k;
+}
+
+
+double BDTForest::Evaluate(const float *x) const
+{
+  double mva;
+  Evaluate(x, 1, &mva);
+  return mva;
+}
+
+
+void BDTForest::Evaluate(const float *x, int n, double *mva) const
+{
+  for (int i=0; i<n; i++) mva[i] = 0.;
+
+  for (int t=0; t<_nTrees; t++) {
+    const int root = _treeBegin[t];
+    const double weight = _gradBoost ? 1. : _boostWeight[t];
+
+    const float *xi = x;
+    for (int i=0; i<n; i++, xi += _nInputs) {
+      int k = root;
+      // DecisionTreeNode::GoesRight: value >= cut, reversed for cut type 0
+      while (_var[k] >= 0) {
+        k = ((xi[_var[k]] >= _cut[k]) == bool(_cutType[k])) ? _right[k] : _left[k];
+      }
+      mva[i] += weight * _leafValue[k];
+    }
+  }
+
+  for (int i=0; i<n; i++) {
+    if (_gradBoost) {
+      mva[i] = 2.0/(1.0+exp(-2.0*mva[i]))-1;
+    }
+    else {
+      mva[i] = (_norm > std::numeric_limits<double>::epsilon()) ? mva[i]/_norm : 0.;
+    }
+  }
+}
+
+
+void BDTForest::GetProbes(int n, std::vector<float> &x) const
+{
+  std::vector<std::vector<float> > cuts(_nInputs);
+  for (unsigned k=0; k<_var.size(); k++) {
+    if (_var[k] >= 0) cuts[_var[k]].push_back(_cut[k]);
+  }
+
+  x.assign(n*_nInputs, 0.f);
+  for (int p=0; p<n; p++) {
+    for (int j=0; j<_nInputs; j++) {
+      if (cuts[j].empty()) continue;
+      // probes 2m and 2m+1 share the cuts, one on and one below them, and the
+      // variables run through their cuts with different strides to mix them
+      float cut = cuts[j][(unsigned(p/2)*(2*j+1) + j) % cuts[j].size()];
+      x[p*_nInputs+j] = ((p+j) % 2) ? std::nextafter(cut, -std::numeric_limits<float>::infinity()) : cut;
+    }
+  }
+}
@@ -37,6 +37,9 @@ For any comments or questions: hale.sert@desy.de
 
 #include <vector>
 #include <string>
+#include <cmath>
+#include <algorithm>
+#include <iostream>
 
 #include <EVENT/LCCollection.h>
 
@@ -90,15 +93,62 @@ LowMomentumMuPiSeparationPID_BDTG::LowMomentumMuPiSeparationPID_BDTG(std::vector
     Pvalue.push_back("20GeVP");
 
 
+    // same order as the inputs of evaluateMVA
+    std::vector<std::string> varNames;
+    varNames.push_back("Dclus");
+    varNames.push_back("EclOvPtr");
+    varNames.push_back("Rmean");
+    varNames.push_back("Rrms");
+
     TString myMethod;
+    _forests.resize(19);
     
     for(int i=0; i < 19; i++){
         myMethod = "BDTG_"+ Pvalue[i]+ "_clusterinfo";   
         weightfile = fname[i];
+        _methods.push_back(myMethod);
         reader->BookMVA( myMethod, weightfile );     
+        if( _forests[i].Load( fname[i], varNames ) && !checkForest(i) )
+          _forests[i] = BDTForest();
       }
 }
 
+bool LowMomentumMuPiSeparationPID_BDTG::checkForest(int iBin){
+
+    // inputs on and just below the cuts of the forest, where the two could differ
+    const int nProbes = 1000;
+    std::vector<float> x;
+    _forests[iBin].GetProbes(nProbes, x);
+    std::vector<double> mva(nProbes);
+    _forests[iBin].Evaluate(&x[0], nProbes, &mva[0]);
+
+    double maxDiff = 0.;
+    for(int p=0; p < nProbes; p++){
+        Dclus = x[4*p];
+        EclOvPtr = x[4*p+1];
+        Rmean = x[4*p+2];
+        Rrms = x[4*p+3];
+        maxDiff = std::max(maxDiff, std::fabs(mva[p] - reader->EvaluateMVA(_methods[iBin])));
+    }
+    Dclus = EclOvPtr = Rmean = Rrms = 0.;
+
+    if(maxDiff > 1e-6){
+        std::cerr << "LowMomentumMuPiSeparationPID_BDTG: " << _methods[iBin] << " differs from TMVA::Reader by "
+                  << maxDiff << ", using TMVA::Reader" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+Float_t LowMomentumMuPiSeparationPID_BDTG::evaluateMVA(int iBin){
+
+    if(_forests[iBin].IsLoaded()){
+        const float x[4] = { Dclus, EclOvPtr, Rmean, Rrms };
+        return _forests[iBin].Evaluate(x);
+    }
+    return reader->EvaluateMVA(_methods[iBin]);
+}
+
 Int_t LowMomentumMuPiSeparationPID_BDTG::MuPiSeparation(TLorentzVector pp, EVENT::Track* trk, EVENT::ClusterVec& cluvec){
    
     double tmpid=-1;
@@ -221,97 +271,97 @@ Int_t LowMomentumMuPiSeparationPID_BDTG::MuPiSeparation(TLorentzVector pp, EVENT
   if(shapes.size()!=0){
       if(Dclus!=0 && EclOvPtr!=0 && Rmean !=0 &&  Rrms!=0){ 
           if(0.15< pp.P() && pp.P()<= 0.25){
-              mvaout = reader->EvaluateMVA("BDTG_02GeVP_clusterinfo");
+              mvaout = evaluateMVA(0);
               if(mvaout > cut02) tmpid=1; 
               else tmpid=2;
           }
           else if(0.25< pp.P() && pp.P()<=0.35){
-              mvaout = reader->EvaluateMVA("BDTG_03GeVP_clusterinfo");
+              mvaout = evaluateMVA(1);
               if(mvaout > cut03) tmpid=1;
               else tmpid=2;
           }
           else if(0.35< pp.P() && pp.P()<=0.45){
-              mvaout = reader->EvaluateMVA("BDTG_04GeVP_clusterinfo");
+              mvaout = evaluateMVA(2);
               if(mvaout > cut04) tmpid=1;
               else tmpid=2;
           }
           else if(0.45< pp.P() && pp.P()<=0.55){
-              mvaout = reader->EvaluateMVA("BDTG_05GeVP_clusterinfo");
+              mvaout = evaluateMVA(3);
               if(mvaout > cut05) tmpid=1;
               else tmpid=2;
           }
           else if(0.55< pp.P() && pp.P()<=0.65){
-              mvaout = reader->EvaluateMVA("BDTG_06GeVP_clusterinfo");
+              mvaout = evaluateMVA(4);
               if(mvaout > cut06) tmpid=1;
               else tmpid=2;
           }
           else if(0.65< pp.P() && pp.P()<=0.75){
-              mvaout = reader->EvaluateMVA("BDTG_07GeVP_clusterinfo");
+              mvaout = evaluateMVA(5);
               if(mvaout > cut07) tmpid=1;
               else tmpid=2;
           }
           else if(0.75< pp.P() && pp.P()<=0.85){
-              mvaout = reader->EvaluateMVA("BDTG_08GeVP_clusterinfo");
+              mvaout = evaluateMVA(6);
               if(mvaout > cut08) tmpid=1;
               else tmpid=2;
           }
           else if(0.85< pp.P() && pp.P()<=0.95){
-              mvaout = reader->EvaluateMVA("BDTG_09GeVP_clusterinfo");
+              mvaout = evaluateMVA(7);
               if(mvaout > cut09) tmpid=1;
               else tmpid=2;
           }
           else if(0.95< pp.P() && pp.P()<=1.05){
-              mvaout = reader->EvaluateMVA("BDTG_10GeVP_clusterinfo");
+              mvaout = evaluateMVA(8);
               if(mvaout > cut10) tmpid=1;
               else tmpid=2;
           }
           else if(1.05< pp.P() && pp.P()<=1.15){
-              mvaout = reader->EvaluateMVA("BDTG_11GeVP_clusterinfo");
+              mvaout = evaluateMVA(9);
               if(mvaout > cut11) tmpid=1;
               else tmpid=2;
           }
           else if(1.15< pp.P() && pp.P()<=1.25){
-              mvaout = reader->EvaluateMVA("BDTG_12GeVP_clusterinfo");
+              mvaout = evaluateMVA(10);
               if(mvaout > cut12) tmpid=1;
               else tmpid=2;
           }
           else if(1.25< pp.P() && pp.P()<=1.35){
-              mvaout = reader->EvaluateMVA("BDTG_13GeVP_clusterinfo");
+              mvaout = evaluateMVA(11);
               if(mvaout > cut13) tmpid=1;
               else tmpid=2;
           }
           else if(1.35< pp.P() && pp.P()<=1.45){
-              mvaout = reader->EvaluateMVA("BDTG_14GeVP_clusterinfo");
+              mvaout = evaluateMVA(12);
               if(mvaout > cut14) tmpid=1;
               else tmpid=2;
           }
           else if(1.45< pp.P() && pp.P()<=1.55){
-              mvaout = reader->EvaluateMVA("BDTG_15GeVP_clusterinfo");
+              mvaout = evaluateMVA(13);
               if(mvaout > cut15) tmpid=1;
               else tmpid=2;
           }
           else if(1.55< pp.P() && pp.P()<=1.65){
-              mvaout = reader->EvaluateMVA("BDTG_16GeVP_clusterinfo");
+              mvaout = evaluateMVA(14);
               if(mvaout > cut16) tmpid=1;
               else tmpid=2;
           }
           else if(1.65< pp.P() && pp.P()<=1.75){
-              mvaout = reader->EvaluateMVA("BDTG_17GeVP_clusterinfo");
+              mvaout = evaluateMVA(15);
               if(mvaout > cut17) tmpid=1;
               else tmpid=2;
           }
           else if(1.75< pp.P() && pp.P()<=1.85){
-              mvaout = reader->EvaluateMVA("BDTG_18GeVP_clusterinfo");
+              mvaout = evaluateMVA(16);
               if(mvaout > cut18) tmpid=1;
               else tmpid=2;
           }
           else if(1.85< pp.P() && pp.P()<=1.95){
-              mvaout = reader->EvaluateMVA("BDTG_19GeVP_clusterinfo");
+              mvaout = evaluateMVA(17);
               if(mvaout > cut19) tmpid=1;
               else tmpid=2;
           }
           else if(1.95< pp.P() && pp.P()<=2.05){
-              mvaout = reader->EvaluateMVA("BDTG_20GeVP_clusterinfo");
+              mvaout = evaluateMVA(18);
               if(mvaout > cut20) tmpid=1;
               else tmpid=2;
           }
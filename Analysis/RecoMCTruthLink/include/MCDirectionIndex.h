@@ -0,0 +1,63 @@
+#ifndef MCDirectionIndex_h
+#define MCDirectionIndex_h 1
+
+#include <vector>
+
+#include <EVENT/LCCollection.h>
+#include <EVENT/MCParticle.h>
+
+namespace gear{
+  class Vector3D ;
+}
+
+/** MCDirectionIndex <br>
+ *  Per-event index of the momentum directions of the neutral MCParticles of a <br>
+ *  collection, bucketed in theta and phi. findClosest() returns the neutral <br>
+ *  MCParticle with the largest positive cosine between its momentum and a given <br>
+ *  direction, among those with |theta - theta(direction)| <= the theta window. <br>
+ *  Only the theta buckets inside the window are visited, and phi buckets that cannot <br>
+ *  contain a better match are skipped. The result is that of a scan of the whole <br>
+ *  collection in collection order (the first of equal matches is kept). <br>
+ *  clear() keeps the allocated memory for the next event.
+ */
+class MCDirectionIndex {
+
+ public:
+
+  MCDirectionIndex() {}
+
+  /** Remove all MCParticles */
+  void clear() ;
+
+  /** Index the neutral (|charge| <= 0.01) MCParticles of the collection */
+  void build( EVENT::LCCollection* mcpCol , double thetaWindow ) ;
+
+  int getNumberOfParticles() const { return int(_mcp.size()) ; }
+
+  /** Closest neutral MCParticle in the theta window, 0 if none - maxProd is set to its cosine */
+  EVENT::MCParticle* findClosest( const gear::Vector3D& dir , double& maxProd ) const ;
+
+ protected:
+
+  int thetaBin( double theta ) const ;
+  int phiBin( double phi ) const ;
+
+  /** Upper bound of the cosine to the direction for any theta in [thetaLow, thetaHigh] and phi distance >= dPhi */
+  static double maxCosine( double theta , double thetaLow , double thetaHigh , double dPhi ) ;
+
+  double _thetaWindow{ 0. } ;
+  int _nTheta{ 0 } ;
+  int _nPhi{ 0 } ;
+  double _thetaBinWidth{ 0. } ;
+  double _phiBinWidth{ 0. } ;
+
+  std::vector<int> _begin{ 0 } ;     // first particle of each (theta, phi) bucket, nTheta*nPhi+1 entries
+  std::vector< EVENT::MCParticle* > _mcp{} ;
+  std::vector<int> _order{} ;        // position in the collection
+  std::vector<double> _theta{} ;
+  std::vector<double> _ux{} ;        // unit momentum
+  std::vector<double> _uy{} ;
+  std::vector<double> _uz{} ;
+} ;
+
+#endif
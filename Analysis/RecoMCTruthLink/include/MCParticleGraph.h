@@ -0,0 +1,57 @@
+#ifndef MCParticleGraph_h
+#define MCParticleGraph_h 1
+
+#include <vector>
+#include <unordered_map>
+
+#include <EVENT/LCCollection.h>
+#include <EVENT/MCParticle.h>
+
+
+/** MCParticleGraph <br>
+ *  Index-based parent/daughter graph of the MCParticles of one collection. The <br>
+ *  MCParticles are numbered by their position in the collection; the parents and <br>
+ *  daughters of each particle are contiguous ranges of indices, in the order of <br>
+ *  getParents() and getDaughters(). Parents or daughters that are not in the <br>
+ *  collection are left out. clear() keeps the allocated memory for the next event.
+ */
+class MCParticleGraph {
+
+ public:
+
+  MCParticleGraph() {}
+
+  /** Remove all MCParticles */
+  void clear() ;
+
+  /** Index the MCParticles of the collection and their parents and daughters */
+  void build( EVENT::LCCollection* mcpCol ) ;
+
+  int getNumberOfParticles() const { return int(_mcp.size()) ; }
+
+  EVENT::MCParticle* getMCParticle( int i ) const { return _mcp[i] ; }
+
+  /** Index of the MCParticle, -1 if not in the collection */
+  int find( const EVENT::LCObject* mcp ) const ;
+
+  /** Range of the parents of particle i */
+  int getParentBegin( int i ) const { return _parentBegin[i] ; }
+  int getParentEnd( int i ) const { return _parentBegin[i+1] ; }
+  int getParent( int k ) const { return _parents[k] ; }
+
+  /** Range of the daughters of particle i */
+  int getDaughterBegin( int i ) const { return _daughterBegin[i] ; }
+  int getDaughterEnd( int i ) const { return _daughterBegin[i+1] ; }
+  int getDaughter( int k ) const { return _daughters[k] ; }
+
+ protected:
+
+  std::unordered_map< const EVENT::LCObject* , int > _index{} ;
+  std::vector< EVENT::MCParticle* > _mcp{} ;
+  std::vector<int> _parentBegin{ 0 } ;      // nParticles+1 entries
+  std::vector<int> _parents{} ;
+  std::vector<int> _daughterBegin{ 0 } ;    // nParticles+1 entries
+  std::vector<int> _daughters{} ;
+} ;
+
+#endif
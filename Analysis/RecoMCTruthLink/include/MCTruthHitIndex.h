@@ -0,0 +1,178 @@
+#ifndef MCTruthHitIndex_h
+#define MCTruthHitIndex_h 1
+
+#include <vector>
+#include <unordered_map>
+
+#include <EVENT/LCObject.h>
+#include <EVENT/MCParticle.h>
+
+namespace UTIL{
+  class LCRelationNavigator ;
+}
+
+/** MCTruthHitIndex <br>
+ *  Flat per-event index from reconstructed hits (TrackerHits or CalorimeterHits) <br>
+ *  to the MCParticles that created them. The MCParticles are numbered in the order <br>
+ *  in which they are added, each indexed hit owns a contiguous range of contributions <br>
+ *  (MCParticle index, weight). The index is built in two passes over the hit <-> sim <br>
+ *  hit relations: reserveContributions() for every relation, allocate(), then <br>
+ *  addContribution() in the same order. The weight is the quantity summed per <br>
+ *  MCParticle by the linker (one per SimTrackerHit, calibrated energy for calorimeter <br>
+ *  hits). clear() keeps the allocated memory for the next event.
+ */
+class MCTruthHitIndex {
+
+ public:
+
+  MCTruthHitIndex() {}
+
+  /** Remove all MCParticles and hits */
+  void clear() ;
+
+  /** Index of the MCParticle, added if not yet known - -1 for a null pointer */
+  int addMCParticle( EVENT::MCParticle* mcp ) ;
+
+  /** Index of the MCParticle, -1 if not known */
+  int findMCParticle( EVENT::MCParticle* mcp ) const ;
+
+  int getNumberOfMCParticles() const { return int(_mcp.size()) ; }
+
+  EVENT::MCParticle* getMCParticle( int mcIndex ) const { return mcIndex < 0 ? 0 : _mcp[mcIndex] ; }
+
+  /** Sort MCParticle indices by MCParticle pointer, i.e. in the order of a std::map< MCParticle* , ... > */
+  void sortByPointer( std::vector<int>& mcIndices ) const ;
+
+  /** First pass: reserve n contributions for the hit, added if not yet known - returns the hit index */
+  int reserveContributions( EVENT::LCObject* hit , int n ) ;
+
+  /** End of the first pass */
+  void allocate() ;
+
+  /** Index of the hit, -1 if not indexed */
+  int findHit( EVENT::LCObject* hit ) const ;
+
+  /** Second pass: add the next contribution of hit iHit, mcIndex -1 for a contribution without MCParticle */
+  void addContribution( int iHit , int mcIndex , double weight ) {
+    const int k = _next[iHit]++ ;
+    _mcIndex[k] = mcIndex ;
+    _weight[k]  = weight ;
+  }
+
+  int getNumberOfHits() const { return int(_begin.size()) - 1 ; }
+
+  EVENT::LCObject* getHit( int iHit ) const { return _hits[iHit] ; }
+
+  /** Range of the contributions of hit iHit */
+  int getBegin( int iHit ) const { return _begin[iHit] ; }
+  int getEnd( int iHit ) const { return _begin[iHit+1] ; }
+
+  int getMCIndex( int k ) const { return _mcIndex[k] ; }
+  double getWeight( int k ) const { return _weight[k] ; }
+
+ protected:
+
+  std::unordered_map< EVENT::MCParticle* , int > _mcpIndex{} ;
+  std::vector< EVENT::MCParticle* > _mcp{} ;
+
+  std::unordered_map< EVENT::LCObject* , int > _hitIndex{} ;
+  std::vector< EVENT::LCObject* > _hits{} ;
+  std::vector<int> _begin{ 0 } ;    // first contribution of each hit, nHits+1 entries
+  std::vector<int> _next{} ;        // next free contribution of each hit (second pass)
+  std::vector<int> _mcIndex{} ;
+  std::vector<double> _weight{} ;
+} ;
+
+
+/** MCWeightSum <br>
+ *  Dense per-MCParticle accumulator, reused for every track or cluster of an event. <br>
+ *  Only the entries that were added to are reset.
+ */
+class MCWeightSum {
+
+ public:
+
+  MCWeightSum() {}
+
+  /** Set the number of MCParticles, all sums zero */
+  void resize( int nMCP ) ;
+
+  void add( int mcIndex , double weight ) {
+    if( ! _used[mcIndex] ){
+      _used[mcIndex] = true ;
+      _indices.push_back( mcIndex ) ;
+    }
+    _sum[mcIndex] += weight ;
+  }
+
+  double get( int mcIndex ) const { return _sum[mcIndex] ; }
+
+  /** Indices of the MCParticles added to, in the order of their first addition or as sorted */
+  const std::vector<int>& getIndices() const { return _indices ; }
+
+  /** Order the indices by MCParticle pointer */
+  void sortByPointer( const MCTruthHitIndex& index ) { index.sortByPointer( _indices ) ; }
+
+  /** Zero all sums */
+  void reset() ;
+
+ protected:
+
+  std::vector<double> _sum{} ;
+  std::vector<char> _used{} ;
+  std::vector<int> _indices{} ;
+} ;
+
+
+/** HitMCRelations <br>
+ *  Mutable flat (hit, MCParticle) -> weight relations of one event, with hit and <br>
+ *  MCParticle indices of a MCTruthHitIndex. Adding an existing relation sums the <br>
+ *  weights, as the LCRelationNavigator does. A relation can be moved to another <br>
+ *  MCParticle of the same hit. The relations of each MCParticle are chained in the <br>
+ *  order they were added; a moved relation stays in the chain of its former <br>
+ *  MCParticle with MCParticle index -1. The final relations are written once by fill().
+ */
+class HitMCRelations {
+
+ public:
+
+  HitMCRelations() {}
+
+  /** Remove all relations */
+  void clear() ;
+
+  /** Add weight to the relation (iHit, mcIndex), created if it doesn't exist - returns the relation */
+  int add( int iHit , int mcIndex , float weight ) ;
+
+  /** Move relation rel, with its weight, to MCParticle mcIndex */
+  void move( int rel , int mcIndex ) ;
+
+  /** First relation of MCParticle mcIndex, -1 if none */
+  int getFirst( int mcIndex ) const { return mcIndex < int(_first.size()) ? _first[mcIndex] : -1 ; }
+
+  /** Next relation in the chain of the same MCParticle, -1 at the end */
+  int getNext( int rel ) const { return _next[rel] ; }
+
+  int getHit( int rel ) const { return _hit[rel] ; }
+  int getMCIndex( int rel ) const { return _mcIndex[rel] ; }
+  float getWeight( int rel ) const { return _weight[rel] ; }
+
+  /** Add all relations to the navigator, in the order they were created */
+  void fill( UTIL::LCRelationNavigator& nav , const MCTruthHitIndex& index ) const ;
+
+ protected:
+
+  static unsigned long long key( int iHit , int mcIndex ) {
+    return ( (unsigned long long)(unsigned)iHit << 32 ) | (unsigned)mcIndex ;
+  }
+
+  std::unordered_map< unsigned long long , int > _relIndex{} ;
+  std::vector<int> _hit{} ;
+  std::vector<int> _mcIndex{} ;
+  std::vector<float> _weight{} ;
+  std::vector<int> _next{} ;     // next relation of the same MCParticle
+  std::vector<int> _first{} ;    // first and last relation of each MCParticle
+  std::vector<int> _last{} ;
+} ;
+
+#endif
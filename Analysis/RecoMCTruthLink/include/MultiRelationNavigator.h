@@ -0,0 +1,82 @@
+#ifndef MultiRelationNavigator_h
+#define MultiRelationNavigator_h 1
+
+#include <vector>
+#include <unordered_map>
+
+#include <EVENT/LCObject.h>
+#include <EVENT/LCCollection.h>
+#include <EVENT/LCRelation.h>
+#include <LCIOSTLTypes.h>
+
+
+/** MultiRelationNavigator <br>
+ *  Read-only navigator over the LCRelations of several relation collections of one <br>
+ *  event - the collections are neither copied nor merged. index() groups the <br>
+ *  relations by their from object (and optionally by their to object) into contiguous <br>
+ *  ranges, found through a hash index. Within a range the relations keep the order <br>
+ *  of the collections, i.e. the order the LCRelationNavigator of the merged collection <br>
+ *  would give. Unlike the LCRelationNavigator, duplicate (from, to) relations are not <br>
+ *  merged. clear() keeps the allocated memory for the next event.
+ */
+class MultiRelationNavigator {
+
+ public:
+
+  MultiRelationNavigator() {}
+
+  /** Remove all collections and relations */
+  void clear() ;
+
+  /** Add a relation collection - call index() after the last one */
+  void addCollection( EVENT::LCCollection* col ) ;
+
+  int getNumberOfCollections() const { return int(_cols.size()) ; }
+
+  /** Build the from index, and the to index if requested */
+  void index( bool indexTo = false ) ;
+
+  /** All relations, in the order of the collections */
+  int getNumberOfRelations() const { return int(_rel.size()) ; }
+  EVENT::LCRelation* getRelation( int i ) const { return _rel[i] ; }
+
+  /** Range of the relations from the object, -1 if none */
+  int findFrom( EVENT::LCObject* from ) const { return _from.find( from ) ; }
+  int getFromBegin( int iFrom ) const { return _from.begin[iFrom] ; }
+  int getFromEnd( int iFrom ) const { return _from.begin[iFrom+1] ; }
+  EVENT::LCRelation* getFromRelation( int k ) const { return _from.rel[k] ; }
+
+  /** Range of the relations to the object, -1 if none (needs index(true)) */
+  int findTo( EVENT::LCObject* to ) const { return _to.find( to ) ; }
+  int getToBegin( int iTo ) const { return _to.begin[iTo] ; }
+  int getToEnd( int iTo ) const { return _to.begin[iTo+1] ; }
+  EVENT::LCRelation* getToRelation( int k ) const { return _to.rel[k] ; }
+
+  /** The objects (and weights) the object is related to, as in the LCRelationNavigator */
+  EVENT::LCObjectVec getRelatedToObjects( EVENT::LCObject* from ) const ;
+  EVENT::FloatVec getRelatedToWeights( EVENT::LCObject* from ) const ;
+
+  /** The objects (and weights) related to the object (needs index(true)) */
+  EVENT::LCObjectVec getRelatedFromObjects( EVENT::LCObject* to ) const ;
+  EVENT::FloatVec getRelatedFromWeights( EVENT::LCObject* to ) const ;
+
+ protected:
+
+  /** Relations grouped by one of their ends */
+  struct RelationRanges {
+    std::unordered_map< EVENT::LCObject* , int > slot{} ;
+    std::vector<int> begin{ 0 } ;                 // nObjects+1 entries
+    std::vector< EVENT::LCRelation* > rel{} ;
+
+    void clear() ;
+    void build( const std::vector< EVENT::LCRelation* >& relations , bool byFrom ) ;
+    int find( EVENT::LCObject* obj ) const ;
+  } ;
+
+  std::vector< EVENT::LCCollection* > _cols{} ;
+  std::vector< EVENT::LCRelation* > _rel{} ;
+  RelationRanges _from{} ;
+  RelationRanges _to{} ;
+} ;
+
+#endif
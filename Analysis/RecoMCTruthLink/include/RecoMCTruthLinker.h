@@ -7,16 +7,20 @@
 #include <IMPL/LCCollectionVec.h>
 #include "lcio.h"
 #include "EVENT/TrackerHit.h"
-//#include <UTIL/BitField64.h>
+#include <UTIL/BitField64.h>
 #include "UTIL/LCTrackerConf.h"
 #include "UTIL/ILDConf.h"
 
+#include "MCTruthHitIndex.h"
+#include "MultiRelationNavigator.h"
+#include "MCDirectionIndex.h"
+#include "MCParticleGraph.h"
+#include "StageLog.h"
 
 #include <set>
 
 
 namespace UTIL{
-  class BitField64 ;
   class LCRelationNavigator ;
 }
 
@@ -148,16 +152,19 @@ public:
   
 protected:
   
-  virtual void mergeTrackerHitRelations(LCEvent * evt);
-  virtual void mergeCaloHitRelations(LCEvent * evt);
+  /** Set up the navigators over all SimTrackerHit - TrackerHit and SimCalorimeterHit - CalorimeterHit
+   *  relation collections of the event (the collections are not copied)
+   */
+  virtual void indexTrackerHitRelations(LCEvent * evt);
+  virtual void indexCaloHitRelations(LCEvent * evt);
   
-  void keepMCParticle( MCParticle* mcp ) ; 
+  /** Flag particle iMCP of the MCParticle graph and its ancestors for the skim */
+  void keepMCParticle( int iMCP ) ; 
 
-  const LCObjectVec* getSimHits( TrackerHit* trkhit, const FloatVec* weights = NULL);
-  const LCObjectVec* getCaloHits( CalorimeterHit* calohit, const FloatVec* weights = NULL);
+  LCObjectVec getSimHits( TrackerHit* trkhit, FloatVec* weights = NULL);
+  LCObjectVec getCaloHits( CalorimeterHit* calohit, FloatVec* weights = NULL);
   
   int getDetectorID(TrackerHit* hit) {
-    static UTIL::BitField64 _encoder = UTIL::BitField64(lcio::LCTrackerCellID::encoding_string());
     _encoder.setValue(hit->getCellID0());
     return _encoder[lcio::LCTrackerCellID::subdet()];
   }
@@ -176,10 +183,32 @@ protected:
   StringVec  _colNamesTrackerHitRelations{};
   StringVec   _caloHitRelationNames{};
   
-  LCCollectionVec* _mergedTrackerHitRelCol=nullptr;
-  LCRelationNavigator* _navMergedTrackerHitRel=nullptr;
-  LCCollectionVec* _mergedCaloHitRelCol=nullptr;
-  LCRelationNavigator* _navMergedCaloHitRel=nullptr;
+  /** per-event navigators over all hit relation collections */
+  MultiRelationNavigator _trackerHitRelNav{};
+  MultiRelationNavigator _caloHitRelNav{};
+
+  /** per-event hit -> MCParticle indices, rebuilt by trackLinker and clusterLinker */
+  MCTruthHitIndex _trackerHitIndex{};
+  MCTruthHitIndex _caloHitIndex{};
+
+  /** per-event direction index of the neutral MCParticles, for clusters without MC contributions */
+  MCDirectionIndex _neutralDirectionIndex{};
+  double _neutralRecoveryThetaWindow{};
+
+  /** cell ID decoder of getDetectorID, per instance as the linking stages may run concurrently */
+  UTIL::BitField64 _encoder{ lcio::LCTrackerCellID::encoding_string() };
+
+  /** number of threads - with more than one, track and cluster linking run concurrently */
+  int _nThreads{};
+
+  /** log of the track linking, buffered while it runs in a second thread */
+  StageLog _trackLog{};
+
+  /** per-event MCParticle graph and skim flags of makeSkim - the flags are read from and
+   *  written back to the MCParticles, so all instances of the processor share them */
+  MCParticleGraph _mcpGraph{};
+  std::vector<bool> _keepMCP{};
+  std::vector<int> _keepStack{};
  
   bool _use_tracker_hit_relations{};
   
@@ -0,0 +1,53 @@
+#ifndef StageLog_h
+#define StageLog_h 1
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+/** StageLog <br>
+ *  Log output of a processing stage that may run in a second thread. streamlog is <br>
+ *  not thread safe: between startBuffering() and flush() the messages are kept <br>
+ *  with their level and only flush() writes them to streamlog, so both have to be <br>
+ *  called from the thread that owns streamlog. Which levels pass is read from <br>
+ *  streamlog when buffering starts. Otherwise the messages go to streamlog <br>
+ *  directly, as with streamlog_out. Messages are written with stagelog_out.
+ */
+class StageLog {
+
+ public:
+
+  /** the streamlog levels that can be kept */
+  enum Level { DEBUG , DEBUG0 , DEBUG1 , DEBUG2 , DEBUG3 , DEBUG4 , DEBUG5 , DEBUG6 , DEBUG7 , DEBUG8 , DEBUG9 ,
+	       MESSAGE , MESSAGE0 , MESSAGE1 , MESSAGE2 , MESSAGE3 , MESSAGE4 , MESSAGE5 , MESSAGE6 , MESSAGE7 ,
+	       MESSAGE8 , MESSAGE9 , WARNING , ERROR , nLevels } ;
+
+  StageLog() {}
+
+  /** Keep the messages from now on */
+  void startBuffering() ;
+
+  /** Write the kept messages to streamlog and stop buffering */
+  void flush() ;
+
+  /** True if a message of this level is written */
+  bool write( Level level ) ;
+
+  /** Stream for a message of this level - call after write() */
+  std::ostream& out( Level level ) ;
+
+ protected:
+
+  bool _buffering{false} ;
+  bool _pass[nLevels]{} ;
+
+  std::ostringstream _text{} ;
+  std::vector<Level> _levels{} ;                 // level of each kept message
+  std::vector<std::string::size_type> _begin{} ; // start of each kept message in _text
+} ;
+
+
+#define stagelog_out( stagelog , MLEVEL ) if( (stagelog).write( StageLog::MLEVEL ) ) (stagelog).out( StageLog::MLEVEL )
+
+#endif
@@ -0,0 +1,181 @@
+#include "MCDirectionIndex.h"
+
+#include <cmath>
+#include <algorithm>
+
+#include "gearimpl/Vector3D.h"
+
+namespace {
+  const int    maxThetaBins = 180 ;
+  const int    nPhiBins     = 32 ;
+  const double boundMargin  = 1e-9 ;  // rounding allowance of the bucket bounds
+}
+
+
+void MCDirectionIndex::clear(){
+
+  _begin.assign( 1 , 0 ) ;
+  _mcp.clear() ;
+  _order.clear() ;
+  _theta.clear() ;
+  _ux.clear() ;
+  _uy.clear() ;
+  _uz.clear() ;
+}
+
+
+void MCDirectionIndex::build( EVENT::LCCollection* mcpCol , double thetaWindow ){
+
+  clear() ;
+
+  _thetaWindow = thetaWindow ;
+
+  // theta buckets about as wide as the window, so that a query visits two or three of them
+  _nTheta = thetaWindow > 0. ? int( std::ceil( M_PI / thetaWindow ) ) : maxThetaBins ;
+  _nTheta = std::max( 1 , std::min( maxThetaBins , _nTheta ) ) ;
+  _nPhi   = nPhiBins ;
+  _thetaBinWidth = M_PI / _nTheta ;
+  _phiBinWidth   = 2. * M_PI / _nPhi ;
+
+  // collect the neutrals, particles at rest have no direction and never match
+  std::vector< EVENT::MCParticle* > mcp ;
+  std::vector<int> order ;
+  std::vector<int> bucket ;
+  std::vector<double> theta , ux , uy , uz ;
+
+  int nMCP = mcpCol->getNumberOfElements() ;
+
+  for( int j=0 ; j < nMCP ; ++j ){
+
+    EVENT::MCParticle* p = dynamic_cast<EVENT::MCParticle*>( mcpCol->getElementAt( j ) ) ;
+
+    if( std::fabs( p->getCharge() ) > 0.01 ) continue ;
+
+    gear::Vector3D mom( p->getMomentum()[0] , p->getMomentum()[1] , p->getMomentum()[2] ) ;
+
+    if( mom.r() == 0. ) continue ;
+
+    gear::Vector3D unit = mom.unit() ;
+
+    mcp.push_back( p ) ;
+    order.push_back( j ) ;
+    theta.push_back( mom.theta() ) ;
+    ux.push_back( unit.x() ) ;
+    uy.push_back( unit.y() ) ;
+    uz.push_back( unit.z() ) ;
+    bucket.push_back( thetaBin( mom.theta() ) * _nPhi + phiBin( mom.phi() ) ) ;
+  }
+
+  // bucket the particles, keeping the collection order within a bucket
+  _begin.assign( _nTheta * _nPhi + 1 , 0 ) ;
+
+  for( unsigned i=0 ; i < bucket.size() ; ++i ) _begin[ bucket[i] + 1 ]++ ;
+  for( unsigned b=1 ; b < _begin.size() ; ++b ) _begin[b] += _begin[b-1] ;
+
+  std::vector<int> next( _begin.begin() , _begin.end() - 1 ) ;
+
+  _mcp.resize( mcp.size() ) ;
+  _order.resize( mcp.size() ) ;
+  _theta.resize( mcp.size() ) ;
+  _ux.resize( mcp.size() ) ;
+  _uy.resize( mcp.size() ) ;
+  _uz.resize( mcp.size() ) ;
+
+  for( unsigned i=0 ; i < bucket.size() ; ++i ){
+
+    const int k = next[ bucket[i] ]++ ;
+
+    _mcp[k]   = mcp[i] ;
+    _order[k] = order[i] ;
+    _theta[k] = theta[i] ;
+    _ux[k]    = ux[i] ;
+    _uy[k]    = uy[i] ;
+    _uz[k]    = uz[i] ;
+  }
+}
+
+
+EVENT::MCParticle* MCDirectionIndex::findClosest( const gear::Vector3D& dir , double& maxProd ) const {
+
+  maxProd = 0. ;
+
+  if( _mcp.empty() ) return 0 ;
+
+  const double recTheta = dir.theta() ;
+  const double recPhi   = dir.phi() ;
+  const gear::Vector3D recUnit = dir.unit() ;
+
+  const double thetaLow  = std::max( 0.   , recTheta - _thetaWindow ) ;
+  const double thetaHigh = std::min( M_PI , recTheta + _thetaWindow ) ;
+  const int iThetaLow  = thetaBin( thetaLow ) ;
+  const int iThetaHigh = thetaBin( thetaHigh ) ;
+
+  const int iPhi0 = phiBin( recPhi ) ;
+
+  int best = -1 ;
+
+  // phi buckets from the one of the direction outwards: 0, +1, -1, +2, -2, ...
+  for( int s=0 ; s < _nPhi ; ++s ){
+
+    const int iPhi = ( iPhi0 + ( s % 2 ? 1 : -1 ) * ( (s+1) / 2 ) + _nPhi ) % _nPhi ;
+
+    double dPhi = std::fabs( recPhi - ( -M_PI + ( iPhi + 0.5 ) * _phiBinWidth ) ) ;
+    if( dPhi > M_PI ) dPhi = 2. * M_PI - dPhi ;
+    dPhi = std::max( 0. , dPhi - 0.5 * _phiBinWidth ) ;
+
+    if( maxCosine( recTheta , thetaLow , thetaHigh , dPhi ) < maxProd - boundMargin ) continue ;
+
+    for( int iTheta = iThetaLow ; iTheta <= iThetaHigh ; ++iTheta ){
+
+      const int b = iTheta * _nPhi + iPhi ;
+
+      for( int k = _begin[b] ; k < _begin[b+1] ; ++k ){
+
+        if ( std::fabs( recTheta - _theta[k] ) > _thetaWindow ) continue ;
+
+        double prod = gear::Vector3D( _ux[k] , _uy[k] , _uz[k] ).dot( recUnit ) ;
+
+        // as the scan in collection order: strictly larger, or equal and earlier
+        if( prod > maxProd || ( prod == maxProd && prod > 0. && _order[k] < _order[best] ) ){
+          maxProd = prod ;
+          best = k ;
+        }
+      }
+    }
+  }
+
+  return best < 0 ? 0 : _mcp[best] ;
+}
+
+
+int MCDirectionIndex::thetaBin( double theta ) const {
+
+  int i = int( theta / _thetaBinWidth ) ;
+
+  return std::max( 0 , std::min( _nTheta - 1 , i ) ) ;
+}
+
+
+int MCDirectionIndex::phiBin( double phi ) const {
+
+  int i = int( ( phi + M_PI ) / _phiBinWidth ) ;
+
+  return std::max( 0 , std::min( _nPhi - 1 , i ) ) ;
+}
+
+
+double MCDirectionIndex::maxCosine( double theta , double thetaLow , double thetaHigh , double dPhi ){
+
+  // cos(angle) <= cos(theta) cos(t) + sin(theta) sin(t) cos(dPhi) = A cos(t) + B sin(t), maximal at t = atan2(B,A)
+  const double A = std::cos( theta ) ;
+  const double B = std::sin( theta ) * std::cos( dPhi ) ;
+
+  double bound = std::max( A * std::cos( thetaLow  ) + B * std::sin( thetaLow  ) ,
+                           A * std::cos( thetaHigh ) + B * std::sin( thetaHigh ) ) ;
+
+  const double tMax = std::atan2( B , A ) ;
+
+  if( tMax > thetaLow && tMax < thetaHigh ) bound = std::max( bound , std::sqrt( A*A + B*B ) ) ;
+
+  return bound ;
+}
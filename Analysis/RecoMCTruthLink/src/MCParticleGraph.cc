@@ -0,0 +1,61 @@
+#include "MCParticleGraph.h"
+
+
+void MCParticleGraph::clear(){
+
+  _index.clear() ;
+  _mcp.clear() ;
+  _parentBegin.assign( 1 , 0 ) ;
+  _parents.clear() ;
+  _daughterBegin.assign( 1 , 0 ) ;
+  _daughters.clear() ;
+}
+
+
+void MCParticleGraph::build( EVENT::LCCollection* mcpCol ){
+
+  clear() ;
+
+  int nMCP = mcpCol->getNumberOfElements() ;
+
+  _mcp.reserve( nMCP ) ;
+  _index.reserve( nMCP ) ;
+
+  for( int i=0 ; i < nMCP ; ++i ){
+
+    EVENT::MCParticle* mcp = dynamic_cast<EVENT::MCParticle*>( mcpCol->getElementAt( i ) ) ;
+
+    _mcp.push_back( mcp ) ;
+    _index.insert( std::make_pair( (const EVENT::LCObject*) mcp , i ) ) ;
+  }
+
+  _parentBegin.reserve( nMCP + 1 ) ;
+  _daughterBegin.reserve( nMCP + 1 ) ;
+
+  for( int i=0 ; i < nMCP ; ++i ){
+
+    const EVENT::MCParticleVec& parents = _mcp[i]->getParents() ;
+
+    for( unsigned k=0 ; k < parents.size() ; ++k ){
+      int iParent = find( parents[k] ) ;
+      if( iParent >= 0 ) _parents.push_back( iParent ) ;
+    }
+    _parentBegin.push_back( _parents.size() ) ;
+
+    const EVENT::MCParticleVec& daughters = _mcp[i]->getDaughters() ;
+
+    for( unsigned k=0 ; k < daughters.size() ; ++k ){
+      int iDaughter = find( daughters[k] ) ;
+      if( iDaughter >= 0 ) _daughters.push_back( iDaughter ) ;
+    }
+    _daughterBegin.push_back( _daughters.size() ) ;
+  }
+}
+
+
+int MCParticleGraph::find( const EVENT::LCObject* mcp ) const {
+
+  std::unordered_map< const EVENT::LCObject* , int >::const_iterator it = _index.find( mcp ) ;
+
+  return it != _index.end() ? it->second : -1 ;
+}
@@ -0,0 +1,167 @@
+#include "MCTruthHitIndex.h"
+
+#include <algorithm>
+#include <functional>
+
+#include <UTIL/LCRelationNavigator.h>
+
+
+void MCTruthHitIndex::clear(){
+
+  _mcpIndex.clear() ;
+  _mcp.clear() ;
+
+  _hitIndex.clear() ;
+  _hits.clear() ;
+  _begin.assign( 1 , 0 ) ;
+  _next.clear() ;
+  _mcIndex.clear() ;
+  _weight.clear() ;
+}
+
+
+int MCTruthHitIndex::addMCParticle( EVENT::MCParticle* mcp ){
+
+  if( mcp == 0 ) return -1 ;
+
+  std::pair< std::unordered_map< EVENT::MCParticle* , int >::iterator , bool > ins =
+    _mcpIndex.insert( std::make_pair( mcp , int(_mcp.size()) ) ) ;
+
+  if( ins.second ) _mcp.push_back( mcp ) ;
+
+  return ins.first->second ;
+}
+
+
+int MCTruthHitIndex::findMCParticle( EVENT::MCParticle* mcp ) const {
+
+  std::unordered_map< EVENT::MCParticle* , int >::const_iterator it = _mcpIndex.find( mcp ) ;
+
+  return it != _mcpIndex.end() ? it->second : -1 ;
+}
+
+
+void MCTruthHitIndex::sortByPointer( std::vector<int>& mcIndices ) const {
+
+  const std::vector< EVENT::MCParticle* >& mcp = _mcp ;
+
+  std::sort( mcIndices.begin() , mcIndices.end() ,
+             [&mcp]( int a , int b ){ return std::less< EVENT::MCParticle* >()( mcp[a] , mcp[b] ) ; } ) ;
+}
+
+
+int MCTruthHitIndex::reserveContributions( EVENT::LCObject* hit , int n ){
+
+  std::pair< std::unordered_map< EVENT::LCObject* , int >::iterator , bool > ins =
+    _hitIndex.insert( std::make_pair( hit , getNumberOfHits() ) ) ;
+
+  // during the first pass _begin[i+1] holds the number of contributions of hit i
+  if( ins.second ){
+    _hits.push_back( hit ) ;
+    _begin.push_back( 0 ) ;
+  }
+
+  _begin[ ins.first->second + 1 ] += n ;
+
+  return ins.first->second ;
+}
+
+
+void MCTruthHitIndex::allocate(){
+
+  for( unsigned i=1 ; i < _begin.size() ; ++i ){
+    _begin[i] += _begin[i-1] ;
+  }
+
+  _next.assign( _begin.begin() , _begin.end() - 1 ) ;
+
+  _mcIndex.resize( _begin.back() ) ;
+  _weight.resize( _begin.back() ) ;
+}
+
+
+int MCTruthHitIndex::findHit( EVENT::LCObject* hit ) const {
+
+  std::unordered_map< EVENT::LCObject* , int >::const_iterator it = _hitIndex.find( hit ) ;
+
+  return it != _hitIndex.end() ? it->second : -1 ;
+}
+
+
+void MCWeightSum::resize( int nMCP ){
+
+  _sum.assign( nMCP , 0. ) ;
+  _used.assign( nMCP , false ) ;
+  _indices.clear() ;
+}
+
+
+void MCWeightSum::reset(){
+
+  for( unsigned i=0 ; i < _indices.size() ; ++i ){
+    _sum[ _indices[i] ] = 0. ;
+    _used[ _indices[i] ] = false ;
+  }
+  _indices.clear() ;
+}
+
+
+void HitMCRelations::clear(){
+
+  _relIndex.clear() ;
+  _hit.clear() ;
+  _mcIndex.clear() ;
+  _weight.clear() ;
+  _next.clear() ;
+  _first.clear() ;
+  _last.clear() ;
+}
+
+
+int HitMCRelations::add( int iHit , int mcIndex , float weight ){
+
+  std::pair< std::unordered_map< unsigned long long , int >::iterator , bool > ins =
+    _relIndex.insert( std::make_pair( key( iHit , mcIndex ) , int(_hit.size()) ) ) ;
+
+  const int rel = ins.first->second ;
+
+  if( ! ins.second ){
+    _weight[rel] += weight ;
+    return rel ;
+  }
+
+  _hit.push_back( iHit ) ;
+  _mcIndex.push_back( mcIndex ) ;
+  _weight.push_back( weight ) ;
+  _next.push_back( -1 ) ;
+
+  if( mcIndex >= int(_first.size()) ){
+    _first.resize( mcIndex + 1 , -1 ) ;
+    _last.resize( mcIndex + 1 , -1 ) ;
+  }
+  if( _last[mcIndex] < 0 ) _first[mcIndex] = rel ;
+  else                     _next[ _last[mcIndex] ] = rel ;
+  _last[mcIndex] = rel ;
+
+  return rel ;
+}
+
+
+void HitMCRelations::move( int rel , int mcIndex ){
+
+  _relIndex.erase( key( _hit[rel] , _mcIndex[rel] ) ) ;
+  _mcIndex[rel] = -1 ;
+
+  add( _hit[rel] , mcIndex , _weight[rel] ) ;
+}
+
+
+void HitMCRelations::fill( UTIL::LCRelationNavigator& nav , const MCTruthHitIndex& index ) const {
+
+  for( unsigned rel=0 ; rel < _hit.size() ; ++rel ){
+
+    if( _mcIndex[rel] < 0 ) continue ;  // moved
+
+    nav.addRelation( index.getHit( _hit[rel] ) , index.getMCParticle( _mcIndex[rel] ) , _weight[rel] ) ;
+  }
+}
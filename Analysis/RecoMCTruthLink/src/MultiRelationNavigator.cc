@@ -0,0 +1,129 @@
+#include "MultiRelationNavigator.h"
+
+
+void MultiRelationNavigator::clear(){
+
+  _cols.clear() ;
+  _rel.clear() ;
+  _from.clear() ;
+  _to.clear() ;
+}
+
+
+void MultiRelationNavigator::addCollection( EVENT::LCCollection* col ){
+
+  _cols.push_back( col ) ;
+}
+
+
+void MultiRelationNavigator::index( bool indexTo ){
+
+  _rel.clear() ;
+
+  for( unsigned i=0 ; i < _cols.size() ; ++i ){
+    for( int j=0, jN=_cols[i]->getNumberOfElements() ; j < jN ; ++j ){
+      _rel.push_back( static_cast<EVENT::LCRelation*>( _cols[i]->getElementAt( j ) ) ) ;
+    }
+  }
+
+  _from.build( _rel , true ) ;
+
+  if( indexTo ) _to.build( _rel , false ) ;
+  else          _to.clear() ;
+}
+
+
+EVENT::LCObjectVec MultiRelationNavigator::getRelatedToObjects( EVENT::LCObject* from ) const {
+
+  EVENT::LCObjectVec objects ;
+
+  int iFrom = findFrom( from ) ;
+  if( iFrom >= 0 ){
+    for( int k = getFromBegin( iFrom ) ; k < getFromEnd( iFrom ) ; ++k ) objects.push_back( _from.rel[k]->getTo() ) ;
+  }
+  return objects ;
+}
+
+
+EVENT::FloatVec MultiRelationNavigator::getRelatedToWeights( EVENT::LCObject* from ) const {
+
+  EVENT::FloatVec weights ;
+
+  int iFrom = findFrom( from ) ;
+  if( iFrom >= 0 ){
+    for( int k = getFromBegin( iFrom ) ; k < getFromEnd( iFrom ) ; ++k ) weights.push_back( _from.rel[k]->getWeight() ) ;
+  }
+  return weights ;
+}
+
+
+EVENT::LCObjectVec MultiRelationNavigator::getRelatedFromObjects( EVENT::LCObject* to ) const {
+
+  EVENT::LCObjectVec objects ;
+
+  int iTo = findTo( to ) ;
+  if( iTo >= 0 ){
+    for( int k = getToBegin( iTo ) ; k < getToEnd( iTo ) ; ++k ) objects.push_back( _to.rel[k]->getFrom() ) ;
+  }
+  return objects ;
+}
+
+
+EVENT::FloatVec MultiRelationNavigator::getRelatedFromWeights( EVENT::LCObject* to ) const {
+
+  EVENT::FloatVec weights ;
+
+  int iTo = findTo( to ) ;
+  if( iTo >= 0 ){
+    for( int k = getToBegin( iTo ) ; k < getToEnd( iTo ) ; ++k ) weights.push_back( _to.rel[k]->getWeight() ) ;
+  }
+  return weights ;
+}
+
+
+void MultiRelationNavigator::RelationRanges::clear(){
+
+  slot.clear() ;
+  begin.assign( 1 , 0 ) ;
+  rel.clear() ;
+}
+
+
+void MultiRelationNavigator::RelationRanges::build( const std::vector< EVENT::LCRelation* >& relations , bool byFrom ){
+
+  clear() ;
+
+  // count the relations of each object, objects numbered in order of appearance
+  std::vector<int> relSlot( relations.size() ) ;
+
+  for( unsigned i=0 ; i < relations.size() ; ++i ){
+
+    EVENT::LCObject* obj = byFrom ? relations[i]->getFrom() : relations[i]->getTo() ;
+
+    std::pair< std::unordered_map< EVENT::LCObject* , int >::iterator , bool > ins =
+      slot.insert( std::make_pair( obj , int(begin.size()) - 1 ) ) ;
+
+    if( ins.second ) begin.push_back( 0 ) ;
+
+    relSlot[i] = ins.first->second ;
+    begin[ relSlot[i] + 1 ]++ ;
+  }
+
+  for( unsigned s=1 ; s < begin.size() ; ++s ) begin[s] += begin[s-1] ;
+
+  // place the relations, keeping their order within each object
+  std::vector<int> next( begin.begin() , begin.end() - 1 ) ;
+
+  rel.resize( relations.size() ) ;
+  for( unsigned i=0 ; i < relations.size() ; ++i ){
+    rel[ next[ relSlot[i] ]++ ] = relations[i] ;
+  }
+}
+
+
+int MultiRelationNavigator::RelationRanges::find( EVENT::LCObject* obj ) const {
+
+  std::unordered_map< EVENT::LCObject* , int >::const_iterator it = slot.find( obj ) ;
+
+  return it != slot.end() ? it->second : -1 ;
+}
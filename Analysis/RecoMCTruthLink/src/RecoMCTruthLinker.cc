@@ -22,7 +22,10 @@
 
 #include <math.h>
 #include <map>
+#include <unordered_map>
 #include <algorithm>
+#include <thread>
+#include <exception>
 
 #ifdef MARLIN_USE_AIDA
 #include <marlin/AIDAProcessor.h>
@@ -38,10 +41,10 @@ using namespace marlin ;
 RecoMCTruthLinker aRecoMCTruthLinker;
 
 
+// flags particles kept in a skim on the MCParticle itself, so it is shared by all
+// RecoMCTruthLinker instances of the job
 struct MCPKeep :  public LCIntExtension<MCPKeep> {} ;
 
-typedef std::map< MCParticle* , int > MCPMap ;
-
 typedef std::map< Track* , int > TrackMap ;
 
 typedef std::map< MCParticle* , double > MCPMapDouble ;
@@ -276,6 +279,20 @@ RecoMCTruthLinker::RecoMCTruthLinker() : Processor("RecoMCTruthLinker") {
                               bool(false)
                             ) ;
 
+  registerProcessorParameter( "NeutralRecoveryThetaWindow" ,
+                              "Clusters without MC contributions are linked to the neutral MCParticle closest in "
+                              "direction within this window in theta [rad]"  ,
+                              _neutralRecoveryThetaWindow,
+                              double(0.3)
+                            ) ;
+
+  registerProcessorParameter( "NumberOfThreads" ,
+                              "Number of threads - with 2 or more the track linking runs concurrently with the "
+                              "cluster and calorimeter hit linking, its log output follows that of the cluster linking"  ,
+                              _nThreads,
+                              int(1)
+                            ) ;
+
     
   
 }
@@ -346,16 +363,6 @@ void RecoMCTruthLinker::processEvent( LCEvent * evt ) {
   if( ! haveTracks ) {
     streamlog_out( DEBUG9 ) << " Track collection : " << _trackCollectionName 
     << " not found - cannot create relation " << std::endl ;
-    
-    
-  } else {  //if ( haveTracks ) {
-    
-      trackLinker( evt,  mcpCol ,  trackCol  ,  &ttrlcol , &trtlcol);
-
-      if (_OutputTrackTruthRelation ) 
-         evt->addCollection(  ttrlcol  , _trackMCTruthLinkName  ) ;
-      if (_OutputTruthTrackRelation ) 
-         evt->addCollection(  trtlcol  , _mCTruthTrackLinkName  ) ;
   }
   
   // find cluster to MCParticle relations and the updated calohit to MCParticle relations.
@@ -377,10 +384,61 @@ void RecoMCTruthLinker::processEvent( LCEvent * evt ) {
   }
   
   
-  if( haveTracks && haveClusters ) {
+  if( haveTracks && haveClusters && _nThreads > 1 ) {
+    
+    // the track and the cluster linking read disjoint inputs and fill disjoint members:
+    // the track linking runs in a second thread. All their input collections are looked
+    // up here first, so that the two only read the event.
+    
+    StringVec inputNames( _simTrkHitCollectionNames ) ;
+    inputNames.insert( inputNames.end() , _simCaloHitCollectionNames.begin() , _simCaloHitCollectionNames.end() ) ;
+    inputNames.insert( inputNames.end() , _colNamesTrackerHitRelations.begin() , _colNamesTrackerHitRelations.end() ) ;
+    inputNames.insert( inputNames.end() , _caloHitRelationNames.begin() , _caloHitRelationNames.end() ) ;
+    
+    for( unsigned i=0 ; i < inputNames.size() ; ++i ){
+      try{ evt->getCollection( inputNames[i] ) ; } catch(DataNotAvailableException&) {}
+    }
+    
+    std::exception_ptr trackError , clusterError ;
+    
+    // streamlog isn't thread safe: the messages of the track linking are kept and
+    // written after those of the cluster linking, once both are done
+    _trackLog.startBuffering() ;
     
-    clusterLinker( evt, mcpCol ,  clusterCol, 
-		   &ctrlcol , &trclcol , &chittrlcol );
+    std::thread trackStage( [&]() {
+        try{ trackLinker( evt,  mcpCol ,  trackCol  ,  &ttrlcol , &trtlcol); }
+        catch(...){ trackError = std::current_exception() ; }
+      } ) ;
+    
+    try{ clusterLinker( evt, mcpCol ,  clusterCol, &ctrlcol , &trclcol , &chittrlcol ); }
+    catch(...){ clusterError = std::current_exception() ; }
+    
+    trackStage.join() ;
+    
+    _trackLog.flush() ;
+    
+    if( trackError ) std::rethrow_exception( trackError ) ;
+    if( clusterError ) std::rethrow_exception( clusterError ) ;
+    
+  } else {
+    
+    if( haveTracks ) 
+      trackLinker( evt,  mcpCol ,  trackCol  ,  &ttrlcol , &trtlcol);
+    
+    if( haveTracks && haveClusters ) 
+      clusterLinker( evt, mcpCol ,  clusterCol, 
+		     &ctrlcol , &trclcol , &chittrlcol );
+  }
+  
+  if( haveTracks ) {
+    
+      if (_OutputTrackTruthRelation ) 
+         evt->addCollection(  ttrlcol  , _trackMCTruthLinkName  ) ;
+      if (_OutputTruthTrackRelation ) 
+         evt->addCollection(  trtlcol  , _mCTruthTrackLinkName  ) ;
+  }
+  
+  if( haveTracks && haveClusters ) {
     
     if (_OutputClusterTruthRelation )   evt->addCollection(  ctrlcol  , _clusterMCTruthLinkName  ) ;
     if (_OutputTruthClusterRelation )   evt->addCollection(  trclcol  , _mCTruthClusterLinkName );
@@ -431,11 +489,9 @@ void RecoMCTruthLinker::processEvent( LCEvent * evt ) {
   if(!_OutputCalohitRelation) { delete chittrlcol; }
   if(!_OutputTruthRecoRelation ) { delete trplcol ; }
 
-  //cleanup relationNavigators and transient collections
-  delete _navMergedTrackerHitRel; _navMergedTrackerHitRel = nullptr;
-  delete _navMergedCaloHitRel; _navMergedCaloHitRel = nullptr;
-  delete _mergedCaloHitRelCol; _mergedCaloHitRelCol = nullptr;
-  delete _mergedTrackerHitRelCol; _mergedTrackerHitRelCol = nullptr;
+  //cleanup relation navigators
+  _trackerHitRelNav.clear() ;
+  _caloHitRelNav.clear() ;
 
   
 }
@@ -444,8 +500,8 @@ void RecoMCTruthLinker::trackLinker(   LCEvent * evt, LCCollection* mcpCol ,  LC
 
 
   
-  // merge all the SimTrackerHit - TrackerHit relations into on collection and set up the combined navigator
-  mergeTrackerHitRelations(evt);
+  // set up the combined navigator over all the SimTrackerHit - TrackerHit relations
+  indexTrackerHitRelations(evt);
   
 
   LCRelationNavigator trackTruthRelNav(LCIO::TRACK , LCIO::MCPARTICLE  ) ;
@@ -454,8 +510,10 @@ void RecoMCTruthLinker::trackLinker(   LCEvent * evt, LCCollection* mcpCol ,  LC
   // weight is the realtive number of hits from a given MCParticle on the track
   LCRelationNavigator truthTrackRelNav(LCIO::MCPARTICLE , LCIO::TRACK  ) ;
  
-  //========== fill a map with #SimTrackerHits per MCParticle ==================
-  MCPMap simHitMap ;  //  counts total simhits for every MCParticle
+  _trackerHitIndex.clear() ;
+
+  //========== count #SimTrackerHits per MCParticle ============================
+  std::vector<int> simHitCount ;  //  counts total simhits for every MCParticle (by index)
   for( unsigned i=0,iN=_simTrkHitCollectionNames.size() ; i<iN ; ++i){
     
     const LCCollection* col = 0 ;
@@ -464,18 +522,67 @@ void RecoMCTruthLinker::trackLinker(   LCEvent * evt, LCCollection* mcpCol ,  LC
       for( int j=0, jN= col->getNumberOfElements() ; j<jN ; ++j ) {
         
         SimTrackerHit* simHit = (SimTrackerHit*) col->getElementAt( j ) ; 
-        MCParticle* mcp = simHit->getMCParticle() ;
-        simHitMap[ mcp ] ++ ;
+        int mcIndex = _trackerHitIndex.addMCParticle( simHit->getMCParticle() ) ;
+        if( mcIndex < 0 ) continue ;
+        if( mcIndex >= int(simHitCount.size()) ) simHitCount.resize( mcIndex + 1 , 0 ) ;
+        simHitCount[ mcIndex ] ++ ;
     }
   }    
   //===========================================================================
 
+  //========== index TrackerHit -> MCParticles of its SimTrackerHits ===========
+  // one contribution of weight 1 per SimTrackerHit, in the order of the relations (or raw hits)
+  if( _use_tracker_hit_relations ) {
+
+    int nRel = _trackerHitRelNav.getNumberOfRelations() ;
+
+    for( int j=0 ; j < nRel ; ++j ){
+      LCRelation* rel = _trackerHitRelNav.getRelation( j ) ;
+      _trackerHitIndex.reserveContributions( rel->getFrom() , 1 ) ;
+    }
+    _trackerHitIndex.allocate() ;
+
+    for( int j=0 ; j < nRel ; ++j ){
+      LCRelation* rel = _trackerHitRelNav.getRelation( j ) ;
+      SimTrackerHit* simHit = dynamic_cast<SimTrackerHit*>( rel->getTo() ) ;
+      _trackerHitIndex.addContribution( _trackerHitIndex.findHit( rel->getFrom() ) ,
+                                        _trackerHitIndex.addMCParticle( simHit->getMCParticle() ) , 1. ) ;
+    }
+
+  } else {
+
+    std::vector<TrackerHit*> rawHitOwners ;
+
+    for( int i=0, iN=trackCol->getNumberOfElements() ; i<iN ; ++i ){
+      const TrackerHitVec& trkHits = dynamic_cast<Track*>( trackCol->getElementAt(i) )->getTrackerHits() ;
+      for( TrackerHitVec::const_iterator hitIt = trkHits.begin() ; hitIt != trkHits.end() ; ++hitIt ) {
+        if( _trackerHitIndex.findHit( *hitIt ) >= 0 ) continue ;
+        _trackerHitIndex.reserveContributions( *hitIt , (*hitIt)->getRawHits().size() ) ;
+        rawHitOwners.push_back( *hitIt ) ;
+      }
+    }
+    _trackerHitIndex.allocate() ;
+
+    for( unsigned i=0 ; i < rawHitOwners.size() ; ++i ){
+      const LCObjectVec& simHits = rawHitOwners[i]->getRawHits() ;
+      for( LCObjectVec::const_iterator objIt = simHits.begin() ; objIt != simHits.end() ; ++objIt ) {
+        SimTrackerHit* simHit = dynamic_cast<SimTrackerHit*>( *objIt ) ;
+        _trackerHitIndex.addContribution( i , _trackerHitIndex.addMCParticle( simHit->getMCParticle() ) , 1. ) ;
+      }
+    }
+  }
+  simHitCount.resize( _trackerHitIndex.getNumberOfMCParticles() , 0 ) ;
+
+  MCWeightSum mcpHits ;  // hits per true particle on the current track
+  mcpHits.resize( _trackerHitIndex.getNumberOfMCParticles() ) ;
+  //===========================================================================
+
   // loop over reconstructed tracks
   int nTrack = trackCol->getNumberOfElements() ;
   
   int ifoundch =0;
   
-  streamlog_out( DEBUG6 ) << " *** Sorting out Track<->MCParticle using simHit<->MCParticle." << std::endl;
+  stagelog_out( _trackLog , DEBUG6 ) << " *** Sorting out Track<->MCParticle using simHit<->MCParticle." << std::endl;
 
   for(int i=0;i<nTrack;++i){
     
@@ -485,7 +592,7 @@ void RecoMCTruthLinker::trackLinker(   LCEvent * evt, LCCollection* mcpCol ,  LC
     // this track is made of, wich sim hits each of the seen hits came from,
     // and finally which true particle actually created each sim hit
     
-    MCPMap mcpMap ;  // mcpMap is a map seen <-> true particle
+    mcpHits.reset() ;  // mcpHits maps seen <-> true particle
     
     int nSimHit = 0 ;
     
@@ -495,25 +602,28 @@ void RecoMCTruthLinker::trackLinker(   LCEvent * evt, LCCollection* mcpCol ,  LC
       
       TrackerHit* hit = * hitIt ; // ... and a seen hit ... 
       
-      const LCObjectVec& simHits  = _use_tracker_hit_relations ? *(this->getSimHits(hit)) : hit->getRawHits() ;
+      int iHit = _trackerHitIndex.findHit( hit ) ;
+      if( iHit < 0 ) {
+        if( _trackerHitRelNav.getNumberOfCollections() != 0 ) this->getSimHits(hit) ;  // warns about the missing relation
+        continue ;
+      }
+      int nSim = _trackerHitIndex.getEnd( iHit ) - _trackerHitIndex.getBegin( iHit ) ;
       MCParticle* mcp2 = 0;       
-      for( LCObjectVec::const_iterator objIt = simHits.begin() ; objIt != simHits.end() ; ++objIt ) {
+      for( int k = _trackerHitIndex.getBegin( iHit ) ; k < _trackerHitIndex.getEnd( iHit ) ; ++k ) {
         
-
-        SimTrackerHit* simHit = dynamic_cast<SimTrackerHit*>( *objIt ) ; // ...and a sim hit ...
- 
-        MCParticle* mcp = simHit->getMCParticle() ; // ... and a true particle !
-        if ( simHits.size() > 1 ) {
+        int mcIndex = _trackerHitIndex.getMCIndex( k ) ;  // ...a sim hit and a true particle !
+        MCParticle* mcp = _trackerHitIndex.getMCParticle( mcIndex ) ;
+        if ( nSim > 1 ) {
           if ( mcp2 != 0 && mcp2 != mcp ) { 
   	    //  In  this case, the mcp:s will count double !!
-            streamlog_out( DEBUG3 ) << " ghost/double " << mcp << " " << mcp2 << " " << hit->getCellID0() <<std::endl;
+            stagelog_out( _trackLog , DEBUG3 ) << " ghost/double " << mcp << " " << mcp2 << " " << hit->getCellID0() <<std::endl;
           }
           mcp2=mcp;
         }       
         if ( mcp != 0 ) {
-          mcpMap[ mcp ]++ ;   // count the hit caused by this true particle
+          mcpHits.add( mcIndex , _trackerHitIndex.getWeight( k ) ) ;   // count the hit caused by this true particle
         } else {
-          streamlog_out( WARNING ) << " tracker SimHit without MCParticle ?!   " <<  std::endl ;
+          stagelog_out( _trackLog , WARNING ) << " tracker SimHit without MCParticle ?!   " <<  std::endl ;
         }
         
         ++nSimHit ; // total hit count
@@ -524,15 +634,15 @@ void RecoMCTruthLinker::trackLinker(   LCEvent * evt, LCCollection* mcpCol ,  LC
     
     if( nSimHit == 0 ){
       
-      streamlog_out( WARNING ) << " No simulated tracker hits found. Set UseTrackerHitRelations to true in steering file to enable using TrackerHit relations if they are available." <<  std::endl ;
-      streamlog_out( WARNING ) << trk->id() <<" " << i << " " << trk->getTrackerHits().size()  <<  std::endl ; 
+      stagelog_out( _trackLog , WARNING ) << " No simulated tracker hits found. Set UseTrackerHitRelations to true in steering file to enable using TrackerHit relations if they are available." <<  std::endl ;
+      stagelog_out( _trackLog , WARNING ) << trk->id() <<" " << i << " " << trk->getTrackerHits().size()  <<  std::endl ; 
  
       for( TrackerHitVec::const_iterator hitIt = trkHits.begin() ; hitIt != trkHits.end() ; ++hitIt ) { 
       
         TrackerHit* hit = * hitIt ; // ... and a seen hit ... 
-	streamlog_out( WARNING ) << hit->getPosition()[0]  <<  " " <<  hit->getPosition()[1]  <<  " " <<  hit->getPosition()[2]  <<  " " << std::endl ;       
-        const LCObjectVec& simHits  = *(this->getSimHits(hit)) ;
-	streamlog_out( WARNING ) <<  simHits.size()  <<  std::endl ; 
+	stagelog_out( _trackLog , WARNING ) << hit->getPosition()[0]  <<  " " <<  hit->getPosition()[1]  <<  " " <<  hit->getPosition()[2]  <<  " " << std::endl ;       
+        const LCObjectVec& simHits  = this->getSimHits(hit) ;
+	stagelog_out( _trackLog , WARNING ) <<  simHits.size()  <<  std::endl ; 
       }
       continue ;  // won't find a particle 
     }
@@ -549,32 +659,35 @@ void RecoMCTruthLinker::trackLinker(   LCEvent * evt, LCCollection* mcpCol ,  LC
     MCPhits.reserve( 1000 ) ;
     int ifound = 0;
     
-    for( MCPMap::iterator it = mcpMap.begin() ;   // iterate trough the map, map->first is the
-        it != mcpMap.end() ; ++it ){             // true particle, map->second is the number of
-                                                 // times this true particle got mapped, ie. the
-                                                 // number of hits it produced.
+    mcpHits.sortByPointer( _trackerHitIndex ) ;  // same order as the former std::map< MCParticle* , int >
+
+    for( unsigned m=0 ; m < mcpHits.getIndices().size() ; ++m ){  // iterate trough the true particles and
+                                                                    // the number of times each got mapped,
+                                                                    // ie. the number of hits it produced.
       
+      MCParticle* tmcp = _trackerHitIndex.getMCParticle( mcpHits.getIndices()[m] ) ;
+      int tmcpHits = int( mcpHits.get( mcpHits.getIndices()[m] ) ) ;
       
-      mother = ( it->first->getParents().size()!=0  ? dynamic_cast<MCParticle*>(it->first->getParents()[0])  : 0 )  ; // mother of the true particle.
+      mother = ( tmcp->getParents().size()!=0  ? dynamic_cast<MCParticle*>(tmcp->getParents()[0])  : 0 )  ; // mother of the true particle.
       
-      if ( _using_particle_gun || it->first->getGeneratorStatus() == 1 ) {  // genstat 1 particle, ie. it is a bona fide
-                                                                            // creating true particle: enter it into the list,
-                                                                            // and note how many hits it produced.
-        theMCPs.push_back( it->first ) ;  
-        MCPhits.push_back( it->second ) ; 
+      if ( _using_particle_gun || tmcp->getGeneratorStatus() == 1 ) {  // genstat 1 particle, ie. it is a bona fide
+                                                                       // creating true particle: enter it into the list,
+                                                                       // and note how many hits it produced.
+        theMCPs.push_back( tmcp ) ;  
+        MCPhits.push_back( tmcpHits ) ; 
         ifound++;
 
       } else {  // not genstat 1. Wat should we do with it ?
 
         if ( mother != 0 ) { // if it has a parent, save it
 
-          theMCPs.push_back(it->first);  
-          MCPhits.push_back(it->second); 
+          theMCPs.push_back( tmcp );  
+          MCPhits.push_back( tmcpHits ); 
           ifound++;
           
         } else {
 
-          streamlog_out( WARNING ) << " track has hit(s) from a non-generator particle with no parents ?!! "  << std::endl;
+          stagelog_out( _trackLog , WARNING ) << " track has hit(s) from a non-generator particle with no parents ?!! "  << std::endl;
         }           
       }
     } // end of loop over map
@@ -600,14 +713,14 @@ void RecoMCTruthLinker::trackLinker(   LCEvent * evt, LCCollection* mcpCol ,  LC
       
       trackTruthRelNav.addRelation(   trk , theMCPs[iii] , weight ) ;
       
-      int Total_SimHits_forMCP = simHitMap[ theMCPs[iii] ];
+      int Total_SimHits_forMCP = simHitCount[ _trackerHitIndex.findMCParticle( theMCPs[iii] ) ];
       
       float inv_weight = float(MCPhits[iii]  ) / Total_SimHits_forMCP  ;
       
       truthTrackRelNav.addRelation(   theMCPs[iii] , trk , inv_weight ) ;
 
       
-      streamlog_out( DEBUG4 ) << "    track " << trk->id() << " has " << MCPhits[iii]  << " hits of "
+      stagelog_out( _trackLog , DEBUG4 ) << "    track " << trk->id() << " has " << MCPhits[iii]  << " hits of "
       << nSimHit << " SimHits ("
       << nHit <<    " TrackerHits) "
       << " weight = " << weight << " , "
@@ -626,8 +739,8 @@ void RecoMCTruthLinker::trackLinker(   LCEvent * evt, LCCollection* mcpCol ,  LC
   } 
   //  seen-true relation complete. add the collection
 
-  streamlog_out( DEBUG6 ) << " *** Sorting out Track<->MCParticle : DONE " << std::endl;
-  streamlog_out( DEBUG6 ) << " *** track linking complete, create collection " << std::endl;
+  stagelog_out( _trackLog , DEBUG6 ) << " *** Sorting out Track<->MCParticle : DONE " << std::endl;
+  stagelog_out( _trackLog , DEBUG6 ) << " *** track linking complete, create collection " << std::endl;
   
   *trtlcol = truthTrackRelNav.createLCCollection() ;
   *ttrlcol = trackTruthRelNav.createLCCollection() ;
@@ -643,7 +756,7 @@ void RecoMCTruthLinker::clusterLinker(  LCEvent * evt,  LCCollection* mcpCol ,
   
   
   
-  mergeCaloHitRelations(evt);
+  indexCaloHitRelations(evt);
   LCRelationNavigator clusterTruthRelNav(LCIO::CLUSTER , LCIO::MCPARTICLE  ) ;
   LCRelationNavigator truthClusterRelNav( LCIO::MCPARTICLE  , LCIO::CLUSTER ) ;
   LCRelationNavigator chitTruthRelNav(LCIO::CALORIMETERHIT , LCIO::MCPARTICLE  ) ;
@@ -651,7 +764,20 @@ void RecoMCTruthLinker::clusterLinker(  LCEvent * evt,  LCCollection* mcpCol ,
   
   Remap_as_you_go remap_as_you_go ;  // map from true tracks linked to hits to 
                                      // those that really should have been linked
-  MCPMapDouble simHitMapEnergy ;  //  counts total simhits for every MCParticle
+  std::vector<double> simHitEnergy ;  //  sums total simhit energy for every MCParticle (by index)
+  HitMCRelations chitTruthRelations ;  // calo hit <-> (re-mapped) MCParticle, written to chitTruthRelNav at the end
+
+  //========== index CalorimeterHit -> (re-mapped) MCParticles, first pass =======
+  // one contribution per MC contribution of each related sim hit, in the order of the relations
+  _caloHitIndex.clear() ;
+
+  for( int j=0, jN=_caloHitRelNav.getNumberOfRelations() ; j < jN ; ++j ){
+    LCRelation* rel = _caloHitRelNav.getRelation( j ) ;
+    SimCalorimeterHit* simHit = dynamic_cast<SimCalorimeterHit*>( rel->getTo() ) ;
+    _caloHitIndex.reserveContributions( rel->getFrom() , simHit->getNMCContributions() ) ;
+  }
+  _caloHitIndex.allocate() ;
+  //===========================================================================
 
 
   streamlog_out( DEBUG6 ) << " *** Sorting out simHit<->MCParticle connections, and find corresponding calo hits " << std::endl;
@@ -694,10 +820,12 @@ void RecoMCTruthLinker::clusterLinker(  LCEvent * evt,  LCCollection* mcpCol ,
       for( int j=0, jN= col->getNumberOfElements() ; j<jN ; ++j ) {
        
         SimCalorimeterHit* simHit = (SimCalorimeterHit*) col->getElementAt( j ) ; 
-        LCObjectVec caloHits  = _navMergedCaloHitRel->getRelatedFromObjects(simHit);
-        if (   caloHits.size() == 0 ) { continue ;}
-        if (   caloHits.size() != 1 ) { streamlog_out( DEBUG9 ) << " Sim hit with nore than one calo hit ? " << std::endl; }
-        CalorimeterHit* caloHit = dynamic_cast<CalorimeterHit*>(caloHits[0]);
+        int iTo = _caloHitRelNav.findTo( simHit ) ;
+        if (   iTo < 0 ) { continue ;}
+        const int nCaloHits = _caloHitRelNav.getToEnd( iTo ) - _caloHitRelNav.getToBegin( iTo ) ;
+        if (   nCaloHits != 1 ) { streamlog_out( DEBUG9 ) << " Sim hit with nore than one calo hit ? " << std::endl; }
+        CalorimeterHit* caloHit = dynamic_cast<CalorimeterHit*>( _caloHitRelNav.getToRelation( _caloHitRelNav.getToBegin( iTo ) )->getFrom() );
+        int iCaloHit = _caloHitIndex.findHit( caloHit ) ;
         double calib_factor = caloHit->getEnergy()/simHit->getEnergy();
 
 
@@ -705,7 +833,7 @@ void RecoMCTruthLinker::clusterLinker(  LCEvent * evt,  LCCollection* mcpCol ,
 	streamlog_out( DEBUG4 ) << "  ================= " << std::endl;
 	streamlog_out( DEBUG4 ) << "    Treating hit " << j << " sim hit id " << simHit->id() << " calo hit id " 
                                 << caloHit->id() << " nb contributions " << simHit->getNMCContributions() << std::endl;
-	streamlog_out( DEBUG3 ) << "      ncalo hits : " << caloHits.size() << " calib factor " << calib_factor 
+	streamlog_out( DEBUG3 ) << "      ncalo hits : " << nCaloHits << " calib factor " << calib_factor 
                                 << " position " << simHit->getPosition()[0] << " " << 
                                                                simHit->getPosition()[1] << " " << 
                                                                simHit->getPosition()[2] << " " << std::endl;
@@ -1087,14 +1215,45 @@ void RecoMCTruthLinker::clusterLinker(  LCEvent * evt,  LCCollection* mcpCol ,
           // decided which mcp this sim-hit should be associated to :
 	  //	already_known:          
 
-          simHitMapEnergy[ mcp ] += e ;
-          chitTruthRelNav.addRelation(  caloHit , mcp , e ) ;
+          int mcIndex = _caloHitIndex.addMCParticle( mcp ) ;
+          if( mcIndex >= int(simHitEnergy.size()) ) simHitEnergy.resize( mcIndex + 1 , 0. ) ;
+          simHitEnergy[ mcIndex ] += e ;
+          chitTruthRelations.add( iCaloHit , mcIndex , e ) ;
 
         } // mc-contributon-to-simHit loop
       }
     }
   } // sim-calo-hits loop   
 
+  //========== index CalorimeterHit -> (re-mapped) MCParticles, second pass ======
+  // weight = calibrated energy, MCParticles re-mapped as decided above
+  for( int j=0, jN=_caloHitRelNav.getNumberOfRelations() ; j < jN ; ++j ){
+    LCRelation* rel = _caloHitRelNav.getRelation( j ) ;
+    CalorimeterHit* hit = dynamic_cast<CalorimeterHit*>( rel->getFrom() ) ;
+    SimCalorimeterHit* simHit = dynamic_cast<SimCalorimeterHit*>( rel->getTo() ) ;
+    int iHit = _caloHitIndex.findHit( hit ) ;
+
+    double calib_factor = hit->getEnergy()/simHit->getEnergy();
+    for(int k=0;k<simHit->getNMCContributions() ;k++){
+      MCParticle* mcp = simHit->getParticleCont( k ) ;
+      double e  = simHit->getEnergyCont( k ) * calib_factor;
+      if ( mcp != 0 ) {
+        Remap_as_you_go::const_iterator remapped = remap_as_you_go.find(mcp) ;
+        if( remapped != remap_as_you_go.end() ) mcp = remapped->second ;
+      } else {
+        streamlog_out( DEBUG7 ) <<"      simhit = "<< simHit << " has no creator " <<std::endl;
+      }
+      _caloHitIndex.addContribution( iHit , _caloHitIndex.addMCParticle( mcp ) , e ) ;
+    }
+  }
+  simHitEnergy.resize( _caloHitIndex.getNumberOfMCParticles() , 0. ) ;
+
+  MCWeightSum mcpEnergy ;  // hit-energy per true particle in the current cluster
+  mcpEnergy.resize( _caloHitIndex.getNumberOfMCParticles() ) ;
+
+  std::vector<int> hitCluster( _caloHitIndex.getNumberOfHits() , -1 ) ;  // cluster of each indexed calo hit
+  //===========================================================================
+
   streamlog_out( DEBUG6 ) << " *** Sorting out simHit<->MCParticle connections : DONE " << std::endl;
   streamlog_out( DEBUG6 ) << " *** Sorting out Cluster<->MCParticle using simHit<->MCParticle, re-assigning the latter in some rare cases." << std::endl;
 
@@ -1119,7 +1278,7 @@ void RecoMCTruthLinker::clusterLinker(  LCEvent * evt,  LCCollection* mcpCol ,
 
   for(int i=0;i<nCluster;i++){
     
-    MCPMapDouble mcpEnergy ;
+    mcpEnergy.reset() ;
     double eTot = 0 ;
     Cluster* clu = dynamic_cast<Cluster*> ( clusterCol->getElementAt(i) ) ;
 
@@ -1153,45 +1312,32 @@ void RecoMCTruthLinker::clusterLinker(  LCEvent * evt,  LCCollection* mcpCol ,
       ecalohitsum+= hit->getEnergy();       
       
       
-      const LCObjectVec& simHits  = *(this->getCaloHits(hit)) ;
+      // the sim hits of the calo hit and their (re-mapped) true contributors, from the flat index
+      int iHit = _caloHitIndex.findHit( hit ) ;
+      if( iHit >= 0 ) hitCluster[ iHit ] = i ;
+      if( iHit < 0 && _caloHitRelNav.getNumberOfCollections() != 0 ) this->getCaloHits(hit) ;  // reports the missing relation
+
+      int ncontrib = ( iHit < 0 ? 0 : _caloHitIndex.getEnd( iHit ) - _caloHitIndex.getBegin( iHit ) ) ;
 
       streamlog_out( DEBUG4 ) << std::endl;
-      streamlog_out( DEBUG4 ) <<"     Treating hit = "<< hit->id() << " e " << hit->getEnergy()<< " nb sim hits : " <<
-	simHits.size() << std::endl;
+      streamlog_out( DEBUG4 ) <<"     Treating hit = "<< hit->id() << " e " << hit->getEnergy()<< " nb contributions : " <<
+	ncontrib << std::endl;
 
       double ehit = 0.0; 
-      int nsimhit = 0;        
-      for( LCObjectVec::const_iterator objIt = simHits.begin() ;
-          objIt != simHits.end() ; ++objIt ){
+      for( int k = ( iHit < 0 ? 0 : _caloHitIndex.getBegin( iHit ) ) ; k < ( iHit < 0 ? 0 : _caloHitIndex.getEnd( iHit ) ) ; ++k ){
         
-        SimCalorimeterHit* simHit = dynamic_cast<SimCalorimeterHit*>( *objIt ) ; // ... and a sim hit ....
-        
-        double calib_factor = hit->getEnergy()/simHit->getEnergy();
-        streamlog_out( DEBUG3 ) <<"     simhit = "<< simHit->id() << " has " << simHit->getNMCContributions() 
-                                << " contributors " << std::endl;
-        nsimhit++;
-        for(int j=0;j<simHit->getNMCContributions() ;j++){
-          
-          MCParticle* mcp = simHit->getParticleCont( j ) ;
-          double e  = simHit->getEnergyCont( j ) * calib_factor;
-          streamlog_out( DEBUG3 ) <<"     true contributor = "<< mcp->id() << " e: " << e 
-                                  <<" mapped to " <<remap_as_you_go.find(mcp)->second->id() << std::endl;
-          if ( mcp == 0 ) {
-            streamlog_out( DEBUG7 ) <<"      simhit = "<< simHit << " has no creator " <<std::endl;
-            // streamlog_out( DEBUG7 ) <<"         true contributor = "<< mcp << " e: " << e 
-            //    <<" mapped to " <<remap_as_you_go.find(mcp)->second << std::endl;
-            continue ; 
-          }
-          mcp=remap_as_you_go.find(mcp)->second;
-          mcpEnergy[ mcp ] +=  e ;// count the hit-energy caused by this true particle
-          eTot += e ;             // total energy
-          ehit+= e;
-        } // mc-contributon-to-simHit loop
-      } // simHit loop 
+        int mcIndex = _caloHitIndex.getMCIndex( k ) ;
+        double e  = _caloHitIndex.getWeight( k ) ;
+        if ( mcIndex < 0 ) continue ;  // sim hit contribution without creator
+        streamlog_out( DEBUG3 ) <<"     true contributor mapped to "<< _caloHitIndex.getMCParticle( mcIndex )->id() << " e: " << e << std::endl;
+        mcpEnergy.add( mcIndex , e ) ;// count the hit-energy caused by this true particle
+        eTot += e ;             // total energy
+        ehit+= e;
+      } // mc-contributon-to-simHit loop
 
       streamlog_out( DEBUG4 )<< "     summed contributed e: " << ehit << " ratio : " << ehit/hit->getEnergy()
-                             << " nsimhit " << nsimhit <<std::endl;
-      if ( nsimhit == 0 ) {
+                             << " ncontrib " << ncontrib <<std::endl;
+      if ( iHit < 0 ) {
         
         streamlog_out( DEBUG5 ) << " Warning: no simhits for calohit " << hit << 
              ". Will have to guess true particle ... " << std::endl;
@@ -1259,22 +1405,25 @@ void RecoMCTruthLinker::clusterLinker(  LCEvent * evt,  LCCollection* mcpCol ,
     
     mother = 0;
     
-    for( MCPMapDouble::iterator it = mcpEnergy.begin() ;  // iterate trough the map.
-        it != mcpEnergy.end() ; ++it ){
-      if ( it->first == 0 ) {   // ( if == 0, this cluster contains some (but not all) sim-hits with unknown origin.
+    mcpEnergy.sortByPointer( _caloHitIndex ) ;  // same order as the former std::map< MCParticle* , double >
+
+    for( unsigned m=0 ; m < mcpEnergy.getIndices().size() ; ++m ){  // iterate trough the true particles.
+      MCParticle* cmcp = _caloHitIndex.getMCParticle( mcpEnergy.getIndices()[m] ) ;
+      double cmcpE = mcpEnergy.get( mcpEnergy.getIndices()[m] ) ;
+      if ( cmcp == 0 ) {   // ( if == 0, this cluster contains some (but not all) sim-hits with unknown origin.
                                 //   If *all* sim-hits would have had unknown origin, we would already have "continue":ed above)
 	streamlog_out( MESSAGE ) << " SimHit with unknown origin in cluster " << clu << " ( " << clu->id() << " ) " << std::endl;
 	continue;
       }  
                                             
-      if (it->first->getGeneratorStatus() == 1 ) {  // genstat 1 particle, ie. it is a bona fide
+      if (cmcp->getGeneratorStatus() == 1 ) {  // genstat 1 particle, ie. it is a bona fide
                                                     // creating true particle: enter it into 
                                                     // the list, and note how much energy it 
                                                     // contributed.
-        theMCPs.push_back(it->first);  MCPes.push_back(it->second); ifound++;
+        theMCPs.push_back(cmcp);  MCPes.push_back(cmcpE); ifound++;
       } else { // not genstat 1. What should we do with it ?
-        if (  it->first->getParents().size() != 0 ) { 
-         mother= dynamic_cast<MCParticle*>(it->first->getParents()[0]);
+        if (  cmcp->getParents().size() != 0 ) { 
+         mother= dynamic_cast<MCParticle*>(cmcp->getParents()[0]);
         } else { 
          mother = 0 ; 
         }
@@ -1285,10 +1434,10 @@ void RecoMCTruthLinker::clusterLinker(  LCEvent * evt,  LCCollection* mcpCol ,
             // ... and is of a type we want to
             // save (it's mother is in _pdgSet) 
             // -> also a bona fide creator.
-            theMCPs.push_back(it->first);  MCPes.push_back(it->second); ifound++;
+            theMCPs.push_back(cmcp);  MCPes.push_back(cmcpE); ifound++;
           } else { // else: if the mother is a BS, add to the  moreMCPs-list, further treated below,
                    //  otherwise keep as a bona fide creator.
-            streamlog_out( DEBUG2 ) << " case 1 for "<< it->first->id() << 
+            streamlog_out( DEBUG2 ) << " case 1 for "<< cmcp->id() << 
             "(morefound=" << morefound << ")" << 
 	      " mother: " << mother->id() <<
             " gs "  <<mother->getGeneratorStatus()<< 
@@ -1296,22 +1445,22 @@ void RecoMCTruthLinker::clusterLinker(  LCEvent * evt,  LCCollection* mcpCol ,
             " bs "  << mother->isBackscatter() << 
             " pdg " <<mother->getPDG() <<std::endl;
             if (  mother->isBackscatter() == 1 ) {
-              moreMCPs.push_back(it->first);  moreMCPes.push_back(it->second); morefound++;
+              moreMCPs.push_back(cmcp);  moreMCPes.push_back(cmcpE); morefound++;
             } else {
-              theMCPs.push_back(it->first);  MCPes.push_back(it->second); ifound++;
+              theMCPs.push_back(cmcp);  MCPes.push_back(cmcpE); ifound++;
             }
           }
         } else { // not genstat 1, no mother ?! Also add to the  moreMCPs-list.
-          streamlog_out( DEBUG6 ) << " case 2 for "<< it->first->id() << 
+          streamlog_out( DEBUG6 ) << " case 2 for "<< cmcp->id() << 
           "(morefound=" << morefound << ")" << std::endl;
-          moreMCPs.push_back(it->first);  moreMCPes.push_back(it->second); morefound++;
+          moreMCPs.push_back(cmcp);  moreMCPes.push_back(cmcpE); morefound++;
         }          
       }
       
       
-      if( it->second > eMax  ){
+      if( cmcpE > eMax  ){
         
-        eMax = it->second ;
+        eMax = cmcpE ;
       }
     }
     
@@ -1346,6 +1495,7 @@ void RecoMCTruthLinker::clusterLinker(  LCEvent * evt,  LCCollection* mcpCol ,
     
     mother = 0;
     for (int iii=0 ; iii<morefound ; iii++ ) {
+      bool reattributed = false ;
       if (  moreMCPs[iii]->getParents().size() != 0 ) { 
         mother= dynamic_cast<MCParticle*>(moreMCPs[iii]->getParents()[0]); 
         streamlog_out( DEBUG2 ) << "   iii: " << iii << " mother: " << mother->id()  <<std::endl; 
@@ -1367,8 +1517,8 @@ void RecoMCTruthLinker::clusterLinker(  LCEvent * evt,  LCCollection* mcpCol ,
       " bye "<<moreMCPs[iii]->hasLeftDetector () <<
       " stop "<<moreMCPs[iii]->isStopped () <<  std::endl;
       
-      while ( mother!= 0 &&  mother->getGeneratorStatus() !=2 ) { // back-track to the 
-                                                                  // beginning of the chain
+      while ( !reattributed && mother!= 0 &&  mother->getGeneratorStatus() !=2 ) { // back-track to the 
+                                                                                   // beginning of the chain
         
         streamlog_out( DEBUG2 ) << "       mother "<< mother->id() << 
         " gs " << mother->getGeneratorStatus() << 
@@ -1396,37 +1546,31 @@ void RecoMCTruthLinker::clusterLinker(  LCEvent * evt,  LCCollection* mcpCol ,
               "(iii= "<<iii <<")" << kkk << 
               " to be related to "<<mother->id() <<
               " add e : " <<  moreMCPes[iii] << std::endl;
-            LCObjectVec hitvec = chitTruthRelNav.getRelatedFromObjects(moreMCPs[iii]);
-            FloatVec evec=chitTruthRelNav.getRelatedFromWeights(moreMCPs[iii]);
-	    int one_mod_done = 0;
-            for ( unsigned lll=0 ; lll<hitvec.size() ; lll++ ) {
-                 CalorimeterHit* hit  = dynamic_cast<CalorimeterHit*>(hitvec[lll]);
-                 for( CalorimeterHitVec::const_iterator hitIt = cluHits.begin() ;
-                            hitIt != cluHits.end() ; ++hitIt ) { 
-                   if (  *hitIt == hit ) { // ... a calo seen hit ...
-                     chitTruthRelNav.removeRelation(  hit ,moreMCPs[iii] );  
-                     chitTruthRelNav.addRelation(  hit , mother , evec[lll] ) ;
-                     one_mod_done = 1;
-                     break ; 
-                   }
-                 }
-             
+            // and move the relations of those in this cluster over to the mother
+            int moreIndex   = _caloHitIndex.findMCParticle( moreMCPs[iii] ) ;
+            int motherIndex = _caloHitIndex.findMCParticle( mother ) ;
+            for ( int rel = chitTruthRelations.getFirst( moreIndex ) ; rel >= 0 ; rel = chitTruthRelations.getNext( rel ) ) {
+              if ( chitTruthRelations.getMCIndex( rel ) != moreIndex ) continue ;  // moved away before
+              if ( hitCluster[ chitTruthRelations.getHit( rel ) ] == i ) { // ... a calo seen hit of this cluster ...
+                chitTruthRelations.move( rel , motherIndex ) ;
+                reattributed = true ;
+              }
             }
-	    if ( one_mod_done == 1 ) {
+	    if ( reattributed ) {
               MCPes[kkk]+= moreMCPes[iii]; 
-              goto endwhile;
+              break ;
             } else {
               streamlog_out( DEBUG3 ) << "        However, no hits related to the current cluster found ??" << std::endl;
             } 
             
           }
         }   
+        if ( reattributed ) break ;
         if (  mother->getParents().size() != 0 ) { 
           
           mother= dynamic_cast<MCParticle*>(mother->getParents()[0]); 
         } else { mother = 0; }
       }
-    endwhile:
       if ( mother == 0 || mother->getGeneratorStatus() ==2 ) {
         
         // no other contributing true particle found among the ancestors 
@@ -1482,7 +1626,7 @@ void RecoMCTruthLinker::clusterLinker(  LCEvent * evt,  LCCollection* mcpCol ,
       // "this cluster got wgt of all seen cluster energy the true produced"
       // (in the  other one it means:
       // "this true contributed wgt to the total seen energy of the cluster")
-      weight=(MCPes[iii]/simHitMapEnergy[theMCPs[iii]]);
+      weight=(MCPes[iii]/simHitEnergy[ _caloHitIndex.findMCParticle( theMCPs[iii] ) ]);
       truthClusterRelNav.addRelation(   theMCPs[iii] , clu , weight ) ;
       
     }
@@ -1497,44 +1641,20 @@ void RecoMCTruthLinker::clusterLinker(  LCEvent * evt,  LCCollection* mcpCol ,
   
   // (This is from the original RecoMCTruthLinker. I didn't revise it/MB)
   
+  // the neutral MCParticle directions are bucketed in theta and phi once per event
+  if( ! missingMC.empty() ) _neutralDirectionIndex.build( mcpCol , _neutralRecoveryThetaWindow ) ;
+  
   for( unsigned i=0 ; i < missingMC.size() ; ++i ) {
     
-    int nMCP  = mcpCol->getNumberOfElements() ;
-    
     Cluster* clu = missingMC[i] ;
     
     
     gear::Vector3D recP( clu->getPosition()[0] , clu->getPosition()[1] ,
                         clu->getPosition()[2] ) ;
     
-    double recTheta = recP.theta() ;
-    
     double maxProd = 0.0 ;
-    MCParticle* closestMCP = 0 ;
+    MCParticle* closestMCP = _neutralDirectionIndex.findClosest( recP , maxProd ) ;
     
-    for (int j=0; j< nMCP ; j++){
-      
-      MCParticle* mcp = dynamic_cast<MCParticle*> ( mcpCol->getElementAt( j ) ) ;
-      
-      if ( fabs( mcp->getCharge() ) > 0.01 ) {
-        continue ;
-      }
-
-      gear::Vector3D mcpP( mcp->getMomentum()[0] , mcp->getMomentum()[1] ,
-                          mcp->getMomentum()[2] ) ;
-
-      if ( fabs( recTheta - mcpP.theta() ) > 0.3 ) {// fixme : proc param...
-        continue ;
-      }
-      
-     
-      double prod  = mcpP.unit().dot(  recP.unit() ) ;
-      
-      if ( prod > maxProd ) {
-        maxProd = prod ;
-        closestMCP = mcp ;
-      }
-    }
     if ( maxProd > 0. ) {
       
       streamlog_out( DEBUG5 ) 
@@ -1571,10 +1691,36 @@ void RecoMCTruthLinker::clusterLinker(  LCEvent * evt,  LCCollection* mcpCol ,
   streamlog_out( DEBUG6 ) << " *** Cluster linking complete, create collection " << std::endl;
   *trclcol = truthClusterRelNav.createLCCollection() ;
   *ctrlcol = clusterTruthRelNav.createLCCollection() ;
+  chitTruthRelations.fill( chitTruthRelNav , _caloHitIndex ) ;
   *chittrlcol = chitTruthRelNav.createLCCollection() ;
 } 
 
 
+/** (Track or Cluster, MCParticle) -> weight of a MCParticle -> Track/Cluster link collection */
+typedef std::pair< const LCObject* , const MCParticle* > RecoTruthKey ;
+
+struct RecoTruthKeyHash {
+  size_t operator()( const RecoTruthKey& key ) const {
+    return std::hash< const void* >()( key.first ) * 31 + std::hash< const void* >()( key.second ) ;
+  }
+} ;
+
+typedef std::unordered_map< RecoTruthKey , float , RecoTruthKeyHash > RecoTruthWeights ;
+
+/** helper function to index the weights of a truth -> reco link collection; repeated links add up as in the LCRelationNavigator */
+inline void fillRecoTruthWeights( LCCollection* truthRecoCol , RecoTruthWeights& weights ){
+
+  int nRel = truthRecoCol->getNumberOfElements() ;
+
+  weights.reserve( nRel ) ;
+
+  for( int j=0 ; j < nRel ; ++j ){
+    LCRelation* rel = static_cast<LCRelation*>( truthRecoCol->getElementAt( j ) ) ;
+    weights[ RecoTruthKey( rel->getTo() , dynamic_cast<MCParticle*>( rel->getFrom() ) ) ] += rel->getWeight() ;
+  }
+}
+
+
 void RecoMCTruthLinker::particleLinker(  LCCollection* mcpCol, LCCollection* particleCol, 
                                           LCCollection* ttrlcol, LCCollection* ctrlcol,
                                           LCCollection* trtlcol, LCCollection* trclcol,
@@ -1585,8 +1731,6 @@ void RecoMCTruthLinker::particleLinker(  LCCollection* mcpCol, LCCollection* par
 
   LCRelationNavigator      trackTruthRelNav = LCRelationNavigator(  ttrlcol );
   LCRelationNavigator      clusterTruthRelNav = LCRelationNavigator(  ctrlcol );
-  LCRelationNavigator      truthTrackRelNav = LCRelationNavigator(  trtlcol );
-  LCRelationNavigator      truthClusterRelNav = LCRelationNavigator(  trclcol );
 
   LCObjectVec mcvec; 
   int nPart = particleCol->getNumberOfElements() ;
@@ -1731,40 +1875,34 @@ void RecoMCTruthLinker::particleLinker(  LCCollection* mcpCol, LCCollection* par
   // "this cluster got wgt of all seen cluster energy the true produced"
   // (in the  other one it means:
   // "this true contributed wgt to the total seen energy of the cluster")
-  LCObjectVec partvec; 
-  static FloatVec www_clu ;
-  static FloatVec www_trk ;
-  LCObjectVec cluvec_t;
-  LCObjectVec trkvec_t;
-  ClusterVec cluvec_p;
-  TrackVec trkvec_p;
+  // The truth -> cluster and truth -> track weights are looked up per
+  // (cluster/track, MCParticle) pair, built once from the link collections.
+  RecoTruthWeights cluTruthWeights ;
+  RecoTruthWeights trkTruthWeights ;
+  fillRecoTruthWeights( trclcol , cluTruthWeights ) ;
+  fillRecoTruthWeights( trtlcol , trkTruthWeights ) ;
+
   int nMCP  = mcpCol->getNumberOfElements() ;
   for(int i=0;i< nMCP;i++){
     MCParticle* mcp =dynamic_cast<MCParticle*> ( mcpCol->getElementAt( i ) ) ;
-    partvec  = particleTruthRelNav.getRelatedFromObjects(mcp);
-    cluvec_t = truthClusterRelNav.getRelatedToObjects(mcp);
-    www_clu  = truthClusterRelNav.getRelatedToWeights(mcp);
-    trkvec_t = truthTrackRelNav.getRelatedToObjects(mcp);
-    www_trk  = truthTrackRelNav.getRelatedToWeights(mcp);
+    const LCObjectVec& partvec = particleTruthRelNav.getRelatedFromObjects(mcp);
 
     for ( unsigned j=0 ;  j<partvec.size() ; j++ ) {
       ReconstructedParticle* msp = dynamic_cast<ReconstructedParticle*>(partvec[j]) ;
-      cluvec_p = msp->getClusters() ;
-      trkvec_p = msp->getTracks() ;
+      const ClusterVec& cluvec_p = msp->getClusters() ;
+      const TrackVec& trkvec_p = msp->getTracks() ;
       float  c_wgt=0. ;
       for ( unsigned k=0 ; k<cluvec_p.size() ; k++ ) {
-        for ( unsigned l=0 ; l<cluvec_t.size() ; l++ ) {
-          if ( cluvec_p[k] == cluvec_t[l] ) {
-            c_wgt+=www_clu[l];
-          }
+        RecoTruthWeights::const_iterator it = cluTruthWeights.find( RecoTruthKey( cluvec_p[k] , mcp ) ) ;
+        if ( it != cluTruthWeights.end() ) {
+          c_wgt+=it->second;
         }
       }
       float  t_wgt=0. ;
       for ( unsigned k=0 ; k<trkvec_p.size() ; k++ ) {
-        for ( unsigned l=0 ; l<trkvec_t.size() ; l++ ) {
-          if ( trkvec_p[k] == trkvec_t[l] ) {
-            t_wgt+=www_trk[l];
-          }
+        RecoTruthWeights::const_iterator it = trkTruthWeights.find( RecoTruthKey( trkvec_p[k] , mcp ) ) ;
+        if ( it != trkTruthWeights.end() ) {
+          t_wgt+=it->second;
         }
       }
       float wgt=int(c_wgt*1000)*10000 + int(t_wgt*1000) ;
@@ -1781,25 +1919,42 @@ void RecoMCTruthLinker::particleLinker(  LCCollection* mcpCol, LCCollection* par
 }
 void RecoMCTruthLinker::makeSkim(   LCCollection* mcpCol ,  LCCollection* ttrlcol,  LCCollection* ctrlcol ,  LCCollectionVec** skimVec){
   
-  
-  LCRelationNavigator      trackTruthRelNav = LCRelationNavigator(  ttrlcol );
-  LCRelationNavigator      clusterTruthRelNav = LCRelationNavigator(  ctrlcol );
-  
-  
   //-------------- create skimmed MCParticle collection ------------------------
   
   //  *skimVec = new LCCollectionVec( LCIO::MCPARTICLE )  ;
   (*skimVec)->setSubset( true) ;  // flag as subset 
   
+  // the skim works on MCParticle indices: the parent/daughter graph is built once,
+  // kept and 'seen' particles are flags indexed like the collection
+  _mcpGraph.build( mcpCol ) ;
   
-  int nMCP  = mcpCol->getNumberOfElements() ;
+  int nMCP  = _mcpGraph.getNumberOfParticles() ;
+  
+  // start from the particles already kept by another RecoMCTruthLinker in this event
+  _keepMCP.assign( nMCP , false ) ;
+  for( int i=0 ; i < nMCP ; ++i ){
+    if( _mcpGraph.getMCParticle( i )->ext<MCPKeep>() == true ) _keepMCP[i] = true ;
+  }
+  
+  //  the track and cluster truth relations are the ones we created above, remember, so here we
+  //  make sure that all true particles related to seen ones (with the logic we used there)
+  //  really will be in the skimmed collection !
+  std::vector<bool> seen( nMCP , false ) ;
+  
+  LCCollection* truthRelCols[2] = { ttrlcol , ctrlcol } ;
+  for( unsigned c=0 ; c < 2 ; ++c ){
+    for( int j=0, jN=truthRelCols[c]->getNumberOfElements() ; j < jN ; ++j ){
+      int iMCP = _mcpGraph.find( static_cast<LCRelation*>( truthRelCols[c]->getElementAt( j ) )->getTo() ) ;
+      if( iMCP >= 0 ) seen[ iMCP ] = true ;
+    }
+  }
   
   for(int i=0; i< nMCP ; i++){
     
-    MCParticle* mcp = dynamic_cast<MCParticle*> ( mcpCol->getElementAt( i ) ) ;
+    MCParticle* mcp = _mcpGraph.getMCParticle( i ) ;
     
     
-    if( mcp->ext<MCPKeep>() == true ){
+    if( _keepMCP[i] ){
       
       continue ;    // particle allready in skim 
     }
@@ -1814,21 +1969,14 @@ void RecoMCTruthLinker::makeSkim(   LCCollection* mcpCol ,  LCCollection* ttrlco
       
       // keep all generated particles (complete event)
       
-      mcp->ext<MCPKeep>() = true  ;
+      _keepMCP[i] = true  ;
       
       continue ;
       
     } else { // of those created in the simulation we keep those that actually are reconstructed
              // including all parents
       
-      //  truthRelNav is the one we created above, remember, so here we make sure that all
-      //  true particles related to seen ones (with the logic we used there) really will
-      //  be in the skimmed collection !
-      
-      const LCObjectVec& trackObjects = trackTruthRelNav.getRelatedFromObjects( (LCObject*) mcp )  ;
-      const LCObjectVec& clusterObjects = clusterTruthRelNav.getRelatedFromObjects( (LCObject*) mcp )  ;
-      
-      if( trackObjects.size() > 0 || clusterObjects.size()>0){
+      if( seen[i] ){
         
         streamlog_out( DEBUG5 ) << " keep MCParticle - e :" << mcp->getEnergy()  
         << " charge: " << mcp->getCharge() 
@@ -1842,7 +1990,7 @@ void RecoMCTruthLinker::makeSkim(   LCCollection* mcpCol ,  LCCollection* ttrlco
         // keepMCParticles also flags all parents of a kept particle, guaranteeing that
         // the history of any contributor to a detected signal will be kept !
         
-        keepMCParticle( mcp ) ;
+        keepMCParticle( i ) ;
       } 
       
     } // else
@@ -1856,7 +2004,7 @@ void RecoMCTruthLinker::makeSkim(   LCCollection* mcpCol ,  LCCollection* ttrlco
   
   if(_saveBremsstrahlungPhotons){
     for(int i=0; i< nMCP ; i++){
-      MCParticle* mcp = dynamic_cast<MCParticle*> ( mcpCol->getElementAt( i ) ) ;
+      MCParticle* mcp = _mcpGraph.getMCParticle( i ) ;
       if( ( abs(mcp->getPDG()) == 22 ) && ( mcp->getEnergy() > _bremsstrahlungEnergyCut ) ){
         if( mcp->getParents().size() ){
           MCParticle* parent = mcp->getParents()[0];
@@ -1872,7 +2020,7 @@ void RecoMCTruthLinker::makeSkim(   LCCollection* mcpCol ,  LCCollection* ttrlco
             const float dz  = z - zpe;
             const float dr = sqrt(dx*dx+dy*dy+dz*dz);
             if(dr>100.){
-              keepMCParticle( mcp ) ;
+              keepMCParticle( i ) ;
             }
           }
         } 
@@ -1881,19 +2029,19 @@ void RecoMCTruthLinker::makeSkim(   LCCollection* mcpCol ,  LCCollection* ttrlco
   }
   
   
+  // daughters kept here are seen later in the same loop, so that decay chains of
+  // particles in the pdg list are followed downwards
   for(int i=0; i< nMCP ; i++){
     
-    MCParticle* mcp = dynamic_cast<MCParticle*> ( mcpCol->getElementAt( i ) ) ;
+    MCParticle* mcp = _mcpGraph.getMCParticle( i ) ;
     
     // keep the daughters of all decays in flight of particles in the pdg list (default: gamma, pi0, K0s) 
-    if( mcp->ext<MCPKeep>() == true &&  mcp->isDecayedInTracker()  ){ //&& !mcp->isStopped()  ){  
+    if( _keepMCP[i] &&  mcp->isDecayedInTracker()  ){ //&& !mcp->isStopped()  ){  
       
       unsigned thePDG = abs( mcp->getPDG() ) ;
       
       if( _pdgSet.find( thePDG ) != _pdgSet.end()  ) {
         
-        const MCParticleVec& daughters = mcp->getDaughters() ;
-        
         streamlog_out( DEBUG5 ) << " keeping daughters of particle with pdg : " << mcp->getPDG() << " : " 
         << " [" << mcp->getGeneratorStatus() << "] :";
         //                                << " e :" << mcp->getEnergy() 
@@ -1913,17 +2061,16 @@ void RecoMCTruthLinker::makeSkim(   LCCollection* mcpCol ,  LCCollection* ttrlco
         
         //      << std::endl ;
         
-        for( MCParticleVec::const_iterator dIt = daughters.begin() ;
-            dIt != daughters.end() ; ++dIt ){
-          
+        for( int k = _mcpGraph.getDaughterBegin( i ) ; k < _mcpGraph.getDaughterEnd( i ) ; ++k ){
           
-          MCParticle* dau = dynamic_cast<MCParticle*>( *dIt ) ;
+          int iDau = _mcpGraph.getDaughter( k ) ;
+          MCParticle* dau = _mcpGraph.getMCParticle( iDau ) ;
           
           if( dau->getEnergy()*1000. >  _eCutMeV ) {
             
-            (*dIt)->ext<MCPKeep>() = true ;
+            _keepMCP[iDau] = true ;
             
-            streamlog_out( DEBUG5 ) <<  (*dIt)->getPDG() << ", " ;
+            streamlog_out( DEBUG5 ) <<  dau->getPDG() << ", " ;
           }
         }
         
@@ -1937,9 +2084,11 @@ void RecoMCTruthLinker::makeSkim(   LCCollection* mcpCol ,  LCCollection* ttrlco
   
   for(int i=0; i< nMCP ; i++){
     
-    MCParticle* mcp = dynamic_cast<MCParticle*> ( mcpCol->getElementAt( i ) ) ;
-    
-    if( mcp->ext<MCPKeep>() == true ) {  
+    if( _keepMCP[i] ) {  
+      
+      MCParticle* mcp = _mcpGraph.getMCParticle( i ) ;
+      
+      mcp->ext<MCPKeep>() = true ;
       
       (*skimVec)->addElement( mcp ) ;
     }
@@ -1949,25 +2098,33 @@ void RecoMCTruthLinker::makeSkim(   LCCollection* mcpCol ,  LCCollection* ttrlco
   
 }
 
-void  RecoMCTruthLinker::keepMCParticle( MCParticle* mcp ){
+void  RecoMCTruthLinker::keepMCParticle( int iMCP ){
   
-  mcp->ext<MCPKeep>() = true  ;
+  // flag the particle and, iteratively, all its ancestors up to the ones already in the skim
+  _keepMCP[iMCP] = true  ;
   
+  _keepStack.clear() ;
+  _keepStack.push_back( iMCP ) ;
   
-  const MCParticleVec& parents = mcp->getParents() ;
-  
-  streamlog_out( DEBUG3 ) << " keepMCParticle keep particle with pdg : " << mcp->getPDG() 
-  << std::endl ;
-  
-  for( MCParticleVec::const_iterator pIt = parents.begin() ;
-      pIt != parents.end() ; ++pIt ){
+  while( ! _keepStack.empty() ){
     
-    if(  (*pIt )->ext<MCPKeep>() != true  ) { // if parent not yet in skim 
+    int i = _keepStack.back() ;
+    _keepStack.pop_back() ;
+    
+    streamlog_out( DEBUG3 ) << " keepMCParticle keep particle with pdg : " << _mcpGraph.getMCParticle( i )->getPDG() 
+    << std::endl ;
+    
+    for( int k = _mcpGraph.getParentBegin( i ) ; k < _mcpGraph.getParentEnd( i ) ; ++k ){
+      
+      int iParent = _mcpGraph.getParent( k ) ;
       
-      // add it
-      keepMCParticle(  *pIt ) ;
+      if( ! _keepMCP[iParent] ) { // if parent not yet in skim 
+        
+        // add it
+        _keepMCP[iParent] = true ;
+        _keepStack.push_back( iParent ) ;
+      }
     }
-    
   }
 }
 
@@ -2094,17 +2251,17 @@ void RecoMCTruthLinker::check( LCEvent * evt ) {
   
 }
 
-const LCObjectVec* RecoMCTruthLinker::getSimHits( TrackerHit* trkhit, const FloatVec* weights ){
+LCObjectVec RecoMCTruthLinker::getSimHits( TrackerHit* trkhit, FloatVec* weights ){
   
-  const LCObjectVec* obj = & _navMergedTrackerHitRel->getRelatedToObjects(trkhit);
+  LCObjectVec obj = _trackerHitRelNav.getRelatedToObjects(trkhit);
   
-  if( obj->empty() == false  ) { 
+  if( obj.empty() == false  ) { 
 
-    if(weights != 0 ) weights = & _navMergedTrackerHitRel->getRelatedToWeights(trkhit);
+    if(weights != 0 ) *weights = _trackerHitRelNav.getRelatedToWeights(trkhit);
     
   }
   else {
-    streamlog_out( WARNING ) << "getSimHits :  TrackerHit : " << trkhit << " has no sim hits related. CellID0 = " << 
+    stagelog_out( _trackLog , WARNING ) << "getSimHits :  TrackerHit : " << trkhit << " has no sim hits related. CellID0 = " << 
          trkhit->getCellID0() << " pos = " << trkhit->getPosition()[0] << " " << trkhit->getPosition()[1] << " " << 
          trkhit->getPosition()[2] << std::endl ;
   }
@@ -2123,7 +2280,7 @@ void RecoMCTruthLinker::end(){
 
 
 /** helper function to get collection safely */
-inline lcio::LCCollection* getCollection(lcio::LCEvent* evt, const std::string name ){
+inline lcio::LCCollection* getCollection(lcio::LCEvent* evt, const std::string name, StageLog& log ){
   
   if( name.size() == 0 )
     return 0 ;
@@ -2134,186 +2291,77 @@ inline lcio::LCCollection* getCollection(lcio::LCEvent* evt, const std::string n
     
   } catch( lcio::DataNotAvailableException& e ){
     
-    streamlog_out( DEBUG2 ) << "getCollection :  DataNotAvailableException : " << name <<  std::endl ;
+    stagelog_out( log , DEBUG2 ) << "getCollection :  DataNotAvailableException : " << name <<  std::endl ;
     
     return 0 ;
   }
 }
 
+inline lcio::LCCollection* getCollection(lcio::LCEvent* evt, const std::string name ){
+  
+  StageLog log ;   // writes to streamlog directly
+  return getCollection( evt , name , log ) ;
+}
 
-void RecoMCTruthLinker::mergeTrackerHitRelations(LCEvent * evt){
+
+void RecoMCTruthLinker::indexTrackerHitRelations(LCEvent * evt){
   
   unsigned nCol = _colNamesTrackerHitRelations.size() ;
   
-  //--- copy existing collections to a vector first
-  std::vector<LCCollection*> colVec ;
-  
+  //--- the existing collections are navigated in place, in the order of the parameter
   for( unsigned i=0; i < nCol ; ++i) {
     
-    LCCollection* col  =  getCollection ( evt , _colNamesTrackerHitRelations[i] ) ;
+    LCCollection* col  =  getCollection ( evt , _colNamesTrackerHitRelations[i] , _trackLog ) ;
     
     if( col != 0 ){ 
       
-      colVec.push_back( col ) ;
+      _trackerHitRelNav.addCollection( col ) ;
     } else {
       
-      streamlog_out(DEBUG2) << " mergeTrackerHitRelations: input collection missing : " << _colNamesTrackerHitRelations[i] << std::endl ;
+      stagelog_out( _trackLog , DEBUG2 ) << " indexTrackerHitRelations: input collection missing : " << _colNamesTrackerHitRelations[i] << std::endl ;
     }
   }
   
+  _trackerHitRelNav.index() ;
   
-   
-  streamlog_out( DEBUG2 ) <<  " mergeTrackerHitRelations: copied collection parameters ... " << std::endl ;
-
-  
-  
-  nCol = colVec.size() ;
-  
-  for( unsigned i=0; i < nCol ; ++i) {
-    
-    LCCollection* col  =  colVec[i] ;
-    
-    if( i == 0 ){
-      // copy collection flags and collection parameters from first collections
-      
-      _mergedTrackerHitRelCol = new LCCollectionVec( col->getTypeName() )  ;
-      
-      _mergedTrackerHitRelCol->setFlag( col->getFlag() ) ;
-      _mergedTrackerHitRelCol->setSubset( true );
- 
-      StringVec stringKeys ;
-      col->getParameters().getStringKeys( stringKeys ) ;
-      for(unsigned i=0; i< stringKeys.size() ; i++ ){
-        StringVec vals ;
-        col->getParameters().getStringVals(  stringKeys[i] , vals ) ;
-        _mergedTrackerHitRelCol->parameters().setValues(  stringKeys[i] , vals ) ;   
-      }
-      StringVec intKeys ;
-      col->getParameters().getIntKeys( intKeys ) ;
-      for(unsigned i=0; i< intKeys.size() ; i++ ){
-        IntVec vals ;
-        col->getParameters().getIntVals(  intKeys[i] , vals ) ;
-        _mergedTrackerHitRelCol->parameters().setValues(  intKeys[i] , vals ) ;   
-      }
-      StringVec floatKeys ;
-      col->getParameters().getFloatKeys( floatKeys ) ;
-      for(unsigned i=0; i< floatKeys.size() ; i++ ){
-        FloatVec vals ;
-        col->getParameters().getFloatVals(  floatKeys[i] , vals ) ;
-        _mergedTrackerHitRelCol->parameters().setValues(  floatKeys[i] , vals ) ;   
-      }
-
-      
-      
-    }
-    
-    int nEle = col->getNumberOfElements() ;
-    
-    for(int j=0; j < nEle ; ++j){
-      
-      _mergedTrackerHitRelCol->addElement(  col->getElementAt(j) ) ;
-      
-    }
-    
-  }    
-   
-  if( nCol != 0 ) _navMergedTrackerHitRel = new LCRelationNavigator( _mergedTrackerHitRelCol );
-  
+  stagelog_out( _trackLog , DEBUG2 ) <<  " indexTrackerHitRelations: " << _trackerHitRelNav.getNumberOfRelations() 
+                          << " relations in " << _trackerHitRelNav.getNumberOfCollections() << " collections " << std::endl ;
 }
 
 
-
-
-
-
-
-void RecoMCTruthLinker::mergeCaloHitRelations(LCEvent * evt){
+void RecoMCTruthLinker::indexCaloHitRelations(LCEvent * evt){
   
   unsigned nCol = _caloHitRelationNames.size() ;
   
-  //--- copy existing collections to a vector first
-  std::vector<LCCollection*> colVec ;
-  
+  //--- the existing collections are navigated in place, in the order of the parameter
   for( unsigned i=0; i < nCol ; ++i) {
     
     LCCollection* col  =  getCollection ( evt , _caloHitRelationNames[i] ) ;
     
     if( col != 0 ){ 
       
-      colVec.push_back( col ) ;
+      _caloHitRelNav.addCollection( col ) ;
       
     } else {
       
-      streamlog_out(DEBUG2) << " mergeCaloHitRelations: input collection missing : " << _caloHitRelationNames[i] << std::endl ;
+      streamlog_out(DEBUG2) << " indexCaloHitRelations: input collection missing : " << _caloHitRelationNames[i] << std::endl ;
     }
   }
   
+  // the sim hit -> calo hit direction is needed for the back-scatter treatment
+  _caloHitRelNav.index( true ) ;
   
-   
-  streamlog_out( DEBUG2 ) <<  " mergeCaloHitRelations: copied collection parameters ... " << std::endl ;
-
-  
-  
-  nCol = colVec.size() ;
-  
-  for( unsigned i=0; i < nCol ; ++i) {
-    
-    LCCollection* col  =  colVec[i] ;
-    
-    if( i == 0 ){
-      // copy collection flags and collection parameters from first collections
-      
-      _mergedCaloHitRelCol = new LCCollectionVec( col->getTypeName() )  ;
-      _mergedCaloHitRelCol->setFlag( col->getFlag() ) ;
-      _mergedCaloHitRelCol->setSubset( true );
- 
-      StringVec stringKeys ;
-      col->getParameters().getStringKeys( stringKeys ) ;
-      for(unsigned i=0; i< stringKeys.size() ; i++ ){
-        StringVec vals ;
-        col->getParameters().getStringVals(  stringKeys[i] , vals ) ;
-        _mergedCaloHitRelCol->parameters().setValues(  stringKeys[i] , vals ) ;   
-      }
-      StringVec intKeys ;
-      col->getParameters().getIntKeys( intKeys ) ;
-      for(unsigned i=0; i< intKeys.size() ; i++ ){
-        IntVec vals ;
-        col->getParameters().getIntVals(  intKeys[i] , vals ) ;
-        _mergedCaloHitRelCol->parameters().setValues(  intKeys[i] , vals ) ;   
-      }
-      StringVec floatKeys ;
-      col->getParameters().getFloatKeys( floatKeys ) ;
-      for(unsigned i=0; i< floatKeys.size() ; i++ ){
-        FloatVec vals ;
-        col->getParameters().getFloatVals(  floatKeys[i] , vals ) ;
-        _mergedCaloHitRelCol->parameters().setValues(  floatKeys[i] , vals ) ;   
-      }
-
-      
-      
-    }
-    
-    int nEle = col->getNumberOfElements() ;
-    
-    for(int j=0; j < nEle ; ++j){
-      
-      _mergedCaloHitRelCol->addElement(  col->getElementAt(j) ) ;
-      
-    }
-    
-  }    
-   
-  if( nCol != 0 ) _navMergedCaloHitRel = new LCRelationNavigator( _mergedCaloHitRelCol );
-  
+  streamlog_out( DEBUG2 ) <<  " indexCaloHitRelations: " << _caloHitRelNav.getNumberOfRelations() 
+                          << " relations in " << _caloHitRelNav.getNumberOfCollections() << " collections " << std::endl ;
 }
 
-const LCObjectVec* RecoMCTruthLinker::getCaloHits( CalorimeterHit* calohit, const FloatVec* weights ){
+LCObjectVec RecoMCTruthLinker::getCaloHits( CalorimeterHit* calohit, FloatVec* weights ){
   
-  const LCObjectVec* obj = & _navMergedCaloHitRel->getRelatedToObjects(calohit);
+  LCObjectVec obj = _caloHitRelNav.getRelatedToObjects(calohit);
   
-  if( obj->empty() == false  ) { 
+  if( obj.empty() == false  ) { 
 
-    if(weights != 0 ) weights = & _navMergedCaloHitRel->getRelatedToWeights(calohit);
+    if(weights != 0 ) *weights = _caloHitRelNav.getRelatedToWeights(calohit);
     
   }
   else {
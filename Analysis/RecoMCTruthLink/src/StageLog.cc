@@ -0,0 +1,70 @@
+#include "StageLog.h"
+
+#include "streamlog/streamlog.h"
+
+
+namespace{
+
+  template <class T>
+  bool passes(){ return streamlog::out.write<T>() ; }
+
+  typedef bool (*PassFunction)() ;
+
+  // in the order of StageLog::Level
+  const PassFunction passFunctions[ StageLog::nLevels ] = {
+    passes<streamlog::DEBUG> , passes<streamlog::DEBUG0> , passes<streamlog::DEBUG1> , passes<streamlog::DEBUG2> ,
+    passes<streamlog::DEBUG3> , passes<streamlog::DEBUG4> , passes<streamlog::DEBUG5> , passes<streamlog::DEBUG6> ,
+    passes<streamlog::DEBUG7> , passes<streamlog::DEBUG8> , passes<streamlog::DEBUG9> ,
+    passes<streamlog::MESSAGE> , passes<streamlog::MESSAGE0> , passes<streamlog::MESSAGE1> , passes<streamlog::MESSAGE2> ,
+    passes<streamlog::MESSAGE3> , passes<streamlog::MESSAGE4> , passes<streamlog::MESSAGE5> , passes<streamlog::MESSAGE6> ,
+    passes<streamlog::MESSAGE7> , passes<streamlog::MESSAGE8> , passes<streamlog::MESSAGE9> ,
+    passes<streamlog::WARNING> , passes<streamlog::ERROR>
+  } ;
+}
+
+
+void StageLog::startBuffering(){
+
+  for( int l=0 ; l < nLevels ; ++l ) _pass[l] = passFunctions[l]() ;
+
+  _buffering = true ;
+}
+
+
+void StageLog::flush(){
+
+  if( ! _buffering ) return ;
+
+  _buffering = false ;
+
+  const std::string text = _text.str() ;
+
+  for( unsigned i=0 ; i < _levels.size() ; ++i ){
+
+    std::string::size_type end = ( i+1 < _levels.size() ) ? _begin[i+1] : text.size() ;
+
+    // streamlog_out, with the level of the message
+    if( passFunctions[ _levels[i] ]() ) streamlog::out() << text.substr( _begin[i] , end - _begin[i] ) ;
+  }
+
+  _text.str( "" ) ;
+  _levels.clear() ;
+  _begin.clear() ;
+}
+
+
+bool StageLog::write( Level level ){
+
+  return _buffering ? _pass[level] : passFunctions[level]() ;
+}
+
+
+std::ostream& StageLog::out( Level level ){
+
+  if( ! _buffering ) return streamlog::out() ;
+
+  _levels.push_back( level ) ;
+  _begin.push_back( std::string::size_type( _text.tellp() ) ) ;
+
+  return _text ;
+}
@@ -0,0 +1,157 @@
+#ifndef INTEGRALTABLE_H
+#define INTEGRALTABLE_H 1
+
+#include <math.h>
+#include <vector>
+
+#include "RombIntSolver.h"
+
+// Include Marlin
+#include <streamlog/streamlog.h>
+
+namespace sistrip {
+
+#define NNODESMIN_T 16
+#define NNODESMAX_T 4096
+#define FCE_T(x)    (_pTemplate->*_fce)(x)
+
+//! Tabulated primitive function of a method of class T (Template class represents
+//! class whose method is to be integrated!). The primitive function F(x) = Int(a,x){f}
+//! is tabulated on equidistant nodes in interval (a,b) and interpolated by cubic
+//! Hermite polynomials, using the integrand f as the derivative at the nodes. Any
+//! definite integral within (a,b) is then obtained at the cost of two table lookups
+//! instead of a full Romberg integration. The template class doesn't have *.cpp file!
+//!
+//! @see Build
+//!
+
+template <class T> class IntegralTable {
+
+ public:
+
+//!Constructor - sets function to be tabulated
+   IntegralTable(double (T::* fce)(double), T* pTemplate) : _a(0.), _h(0.),
+                 _fce(fce), _pTemplate(pTemplate) {;}
+
+//!Destructor
+   ~IntegralTable() {;}
+
+//!This method tabulates the primitive function of fce in interval (a,b). The node
+//!values are calculated with RombIntSolver (precision eps/10) and the number of
+//!nodes is doubled until the cubic Hermite interpolation reproduces the integral
+//!from each node to the middle of the following interval with relative precision
+//!eps. This is checked at the interval midpoints only, where the Hermite error of a
+//!smooth integrand peaks, so it is an estimate rather than a strict bound: the error
+//!of the primitive function at any point is about eps times the integral over half
+//!an interval, and that of a definite integral about twice this. Integrals spanning
+//!many intervals are thus far more precise than eps, integrals within one interval
+//!only to within this absolute error. Returns the relative precision achieved at
+//!the midpoints.
+   float Build(double endPointA, double endPointB, float eps);
+
+//!Returns a definite integral of fce in interval (x0,x1) - both points expected
+//!to lie in the tabulated interval
+   double Integrate(double x0, double x1) const {return (Primitive(x1) - Primitive(x0));}
+
+//!Returns the primitive function Int(a,x){fce}
+   double Primitive(double x) const;
+
+//!Has the table been built?
+   bool isBuilt() const {return (!_F.empty());}
+
+//!Returns the number of table intervals
+   int getNIntervals() const {return (_F.empty() ? 0 : int(_F.size()) - 1);}
+
+ private:
+
+   double _a;//!<Left endpoint of the tabulated interval
+   double _h;//!<Distance of two nodes
+
+   std::vector<double> _F;//!<Primitive function at the nodes
+   std::vector<double> _f;//!<Integrand at the nodes
+
+   double (T::* _fce)(double);//!<Relative pointer to a tabulated function
+
+   T * _pTemplate;//!< Pointer to the template class
+
+}; // Class
+
+//
+// Method tabulating the primitive function in interval (a,b)
+//
+template <class T>
+float IntegralTable<T>::Build(double endPointA, double endPointB, float eps)
+{
+   RombIntSolver<T> intSolver(_fce, _pTemplate, eps/10.);
+
+   _a = endPointA;
+
+   int   nInt   = NNODESMIN_T;
+   float maxEps = 0.;
+
+   while (true) {
+
+      _h = (endPointB - endPointA)/nInt;
+
+      _F.assign(nInt+1, 0.);
+      _f.assign(nInt+1, 0.);
+
+   // Fill the nodes
+      for (int i=0; i<=nInt; i++) {
+         _f[i] = FCE_T(_a + i*_h);
+         if (i>0) _F[i] = _F[i-1] + intSolver.Integrate(_a + (i-1)*_h, _a + i*_h);
+      }
+
+   // Check precision in the middle of each interval
+      maxEps = 0.;
+      for (int i=0; i<nInt; i++) {
+
+         double xMid     = _a + (i+0.5)*_h;
+         double exact    = intSolver.Integrate(_a + i*_h, xMid);
+         double approx   = Primitive(xMid) - _F[i];
+         double relEps   = (exact != 0. ? fabs((approx - exact)/exact) : fabs(approx));
+
+         if (relEps > maxEps) maxEps = relEps;
+      }
+
+      if (maxEps < eps) break;
+
+      if (nInt >= NNODESMAX_T) {
+         streamlog_out(WARNING) << "Warning - Too many nodes in integral table, required "
+                                << "precision wasn't achieved" << std::endl;
+         break;
+      }
+      nInt *= 2;
+   }
+
+   return maxEps;
+}
+
+//
+// Primitive function - cubic Hermite interpolation between the nodes
+//
+template <class T>
+double IntegralTable<T>::Primitive(double x) const
+{
+   int nInt = _F.size() - 1;
+
+// Find the interval (points slightly outside are extrapolated from the border ones)
+   double t = (x - _a)/_h;
+   int    i = int(floor(t));
+
+   if (i<0)          i = 0;
+   if (i>nInt-1)     i = nInt-1;
+
+   t -= i;
+
+   double t2  = t*t;
+   double mt  = 1. - t;
+   double mt2 = mt*mt;
+
+   return ( (1. + 2.*t)*mt2 * _F[i]   + t*mt2*_h      * _f[i] +
+            t2*(3. - 2.*t)  * _F[i+1] + t2*(t - 1.)*_h * _f[i+1] );
+}
+
+} // Namespace
+
+#endif // INTEGRALTABLE_H
@@ -12,6 +12,7 @@
 
 #include <vector>
 #include <queue>
+#include <pthread.h>
 
 // Include CLHEP header files
 #include <CLHEP/Vector/ThreeVector.h>
@@ -20,6 +21,7 @@
 #include "StripCluster.h"
 #include "SiStripDigi.h"
 #include "SiStripGeom.h"
+#include "StripBuffer.h"
 
 // Include LCIO header files
 #include <lcio.h>
@@ -51,6 +53,7 @@ typedef       std::vector< double * >             DoubleVec;
 typedef       std::vector< LCCollection *>        LCCollectionVec;
 typedef       std::vector< std::string >          StringVec;
 typedef       std::queue < std::string >          StringQue;
+typedef       std::pair< int, StripCluster * >    StripClusterPair; // strip ID, cluster
 
 //! Marlin processor intended for cluster finding - uses digitized data worked out with SiStripDigi
 //!
@@ -89,10 +92,16 @@ class SiStripClus : public Processor
 		//!strips, are defined. Then the strips adjacent to the seeds and above _SNadjacent
 		//!threshold are extracted. Finally, clusters taken as Gaussian are calculated (if total
 		//!charge is above _SNtotal threshold) and their mean positions and sigmas are saved in either
-		//!R-Phi or Z. Finally, they are mixed into 3D cluster. (input parameter: sensor map
-		//!of strips with total integrated charge, output parameter: sensor map of clusters
-		//!found by this algorithm)
-		ClsVec findClus(SensorStripMap & sensorMap);
+		//!R-Phi or Z. Finally, they are mixed into 3D cluster. (input parameter: strips
+		//!with total integrated charge, output parameter: vector of clusters found by
+		//!this algorithm). The search in different sensors may be shared among
+		//!_nThreads threads, the clusters are then mixed in the order of sensors.
+		ClsVec findClus(StripBuffer & strips);
+		
+		//!Method searching for clusters in sensor iSensor of the strip buffer, both
+		//!strip types; the clusters are saved in _sideClusters. Strips are scanned
+		//!linearly, adjacent strips are the neighbouring indices of the buffer.
+		void findSensorClus(StripBuffer & strips, int iSensor);
 		
 		// OTHER METHODS
 		//!Method calculating hits from given clusters
@@ -102,11 +111,10 @@ class SiStripClus : public Processor
 		float * calcResolution(const int & layerID, const double & hitTheta,
 				const double & posZ);
 		
-		//!Method to update and store the Sensor strip map
+		//!Method to add the pulse to the strip buffer (compact() to be called
+		//!after all pulses are added)
 		void updateMap(TrackerPulseImpl * pulse,  
-				SensorStripMap & sensorMap );
-		//!Method to release memory of the SensorStripMap
-		void releaseMap(SensorStripMap & sensorMap);
+				StripBuffer & strips );
 		
 		// PRINT METHODS
 		//!Method printing processor parameters
@@ -151,6 +159,12 @@ class SiStripClus : public Processor
 		double _pitchRear;    //!< Pitch in the middle of the rear sensor 
 
 		std::string _subdetector;  //!< Name of the subdetector to be clusterize
+
+		StripBuffer _strips;       //!< Hit strips of all sensors (reused event by event)
+		
+		int _nThreads;             //!< Number of threads used to search for clusters
+		
+		std::vector< std::vector<StripClusterPair> > _sideClusters; //!< Clusters of each sensor side (2*sensor + strip type)
 		
 		// Root output
 #ifdef ROOT_OUTPUT
@@ -189,11 +203,16 @@ class SiStripClus : public Processor
 		int _nRun;   //!< Run number
 		int _nEvent; //!< Event number
 		
-		//
-		//! Calculated and stored the hits adjacents
-		template<class It>
-		StripChargeMap & storeHitsAdjacents( StripChargeMap & clsStripsIn, 
-				It schmap, const It & endIt, StripChargeMap & cM);
+		//! Arguments of a clustering thread
+		struct ClusThreadArgs {
+			SiStripClus * processor;
+			StripBuffer * strips;
+			int           iThread;
+			int           nThreads;
+		};
+		
+		//! Clustering thread - searches for clusters in every nThreads-th sensor
+		static void * findClusThread(void * arg);
 };
 
 } // Namespace
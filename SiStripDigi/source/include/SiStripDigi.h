@@ -91,10 +91,11 @@
 
 // Include Digi header files
 #include "DigiCluster.h"
+#include "IntegralTable.h"
 #include "SiEnergyFluct.h"
-#include "Signal.h"
 #include "SimTrackerDigiHit.h"
 #include "SiStripGeom.h"
+#include "StripBuffer.h"
 
 // Include LCIO header files
 #include <lcio.h>
@@ -135,8 +136,6 @@ typedef       std::vector< EVENT::LCCollection *>  LCCollectionVec;
 typedef const std::vector< EVENT::SimTrackerHit *> ConstSimTrackerHitVec;
 typedef       std::vector< EVENT::SimTrackerHit *> SimTrackerHitVec;
 typedef       std::vector< SimTrackerDigiHit *>    SimTrackerDigiHitVec;
-typedef       std::map< int, Signal *>             StripChargeMap;   // strip ID, signal
-typedef       std::map< int, StripChargeMap *>     SensorStripMap;   // sensor ID, strip map
 typedef       std::map<SimTrackerHit *, float>     SimHitMap;        // hit, weight
 
 //! Marlin processor intended for detailed digitization of silicon strip sensors
@@ -175,9 +174,9 @@ class SiStripDigi : public marlin::Processor
 		//!Method digitizing given SimTrackerDigiHit - takes into account all relevant
 		//!physical processes: landau fluctuations, drift, diffusion, Lorentz shift 
 		//!in magnetic field (input parameter: a pointer to digitized hit, output 
-                //!parameter: a sensor map of strips with total integrated charge and time 
-		//!when particle crossed the sensor)
-		void digitize(const SimTrackerDigiHit * hit, SensorStripMap & sensorMap);
+                //!parameter: a strip buffer, where the charge collected by each strip and
+		//!the time when particle crossed the sensor are added as deposits)
+		void digitize(const SimTrackerDigiHit * hit, StripBuffer & strips);
 		
 		
 		// OTHER METHODS
@@ -196,18 +195,38 @@ class SiStripDigi : public marlin::Processor
 		//!redistributed according the following relation: 
 		//!          Q_neigh = Q_centr * C_inter/(C_inter + C_back + C_coupl),
 		//!where neigh denotes neighbouring, centr central, inter interstrip,
-		//!back strip2backplane and coupl coupling.
-		void calcCrossTalk(SensorStripMap & sensorMap);
+		//!back strip2backplane and coupl coupling. (input parameter: compacted
+		//!strip buffer, output parameter: compacted buffer with redistributed charge)
+		void calcCrossTalk(const StripBuffer & strips, StripBuffer & stripsCrossTalk);
 		
 		//!Method generating random noise using Gaussian distribution and add this 
 		//!effect to the final results.
-		void genNoise(SensorStripMap & sensorMap);
+		void genNoise(StripBuffer & strips);
+		
+		//!Method generating noise hits, i.e. strips without signal whose noise
+		//!exceeds the threshold _noiseHitsThreshold*_elNoise. Instead of generating
+		//!noise for every strip, the number of such strips in each sensor is drawn
+		//!from the binomial distribution, the strips are placed at random and their
+		//!amplitudes are sampled from the Gaussian tail above the threshold. Cost is
+		//!then proportional to the number of noise hits, not the number of strips.
+		void genNoiseHits(StripBuffer & strips);
+		
+		//!Method sampling standard Gaussian distribution truncated below given
+		//!threshold (in units of sigma)
+		double genGaussTail(double threshold);
 		
 		//!Method transforming given SimTrackerHit into local ref. system of each 
 		//!sensor, resp. wafer, where the center is positioned such as x, y and z 
 		//!coordinates are always positive and x is in direction of thickness.
 		void transformSimHit(SimTrackerDigiHit * simDigiHit);
 		
+		//!Method tabulating, for each layer (i.e. sensor thickness), the integrals
+		//!of inverse velocity and mobility over the sensor depth, used to get the
+		//!drift time and the Lorentz shift of a cluster without Romberg integration.
+		//!The tables depend only on depth for given bias voltage, depletion voltage
+		//!and temperature; their relative precision is set by _epsTime, resp. _epsAngle.
+		void buildTransportTables();
+		
 		// GET METHODS
 		
 		//!Get method - returns ELECTRON diffusivity (parameters: electron mobility
@@ -379,7 +398,7 @@ class SiStripDigi : public marlin::Processor
                 
                 //!Method printing info about signals at each strip
                 void printStripsInfo( std::string info, 
-				const SensorStripMap & sensorMap) const;
+				const StripBuffer & strips) const;
                 
                 
                 // VARIABLES
@@ -404,10 +423,13 @@ class SiStripDigi : public marlin::Processor
 		float _elNoise;                 //!< CMS-like (common mode subtracted) noise added to the signal
 		bool  _floatStripsRPhi;         //!< Is every even strip floating in R-Phi?
 		bool  _floatStripsZ;            //!< Is every even strip floating in Z?
+		bool  _noiseHits;               //!< Simulate noise hits in strips without signal?
+		float _noiseHitsThreshold;      //!< Noise hits threshold in units of noise
 		
 		float _epsSpace;                //!< Absolute digi precision in space in um
 		float _epsAngle;                //!< Relative digi precision in Lorentz angle
 		float _epsTime;                 //!< Relative digi precision in Drift time
+		bool  _rombergIntegration;      //!< Integrate drift time + Lorentz shift for each cluster (validation mode)?
 		
 		// Digitization parameters for Landau fluctuations - set by users
 		bool   _landauFluct;            //!< Define if internal Landau fluctuations (instead of Geant4) used
@@ -438,10 +460,26 @@ class SiStripDigi : public marlin::Processor
 		
 		// Random generator
 		CLHEP::RandGauss * _genGauss;   //!< Random number generator - Gaussian distribution
+		CLHEP::HepRandomEngine * _noiseHitsEngine; //!< Random engine for noise hits
+		std::vector<int> _noiseHitStrips;          //!< Noise hit strips of current sensor
+		double _nNoiseHitsExpected;                //!< Expected number of noise hits, summed over events
+		double _nNoiseHits;                        //!< Generated number of noise hits, summed over events
+		double _noiseHitsAmplSum;                  //!< Sum of noise hit amplitudes in units of noise
+		double _nNoiseHitsAmpl;                    //!< Number of noise hit amplitudes summed
 		
 		// Simulator of Landau fluctuations in Si
 		SiEnergyFluct * _fluctuate;
 		
+		// Tabulated drift time and Lorentz shift integrals - one table per layer
+		std::vector< IntegralTable<SiStripDigi> > _elecDriftTable;    //!< Int{1/v} for electrons
+		std::vector< IntegralTable<SiStripDigi> > _holeDriftTable;    //!< Int{1/v} for holes
+		std::vector< IntegralTable<SiStripDigi> > _elecLorentzTable;  //!< Int{mobility} for electrons
+		std::vector< IntegralTable<SiStripDigi> > _holeLorentzTable;  //!< Int{mobility} for holes
+		
+		// Strips with signal - reused event by event
+		StripBuffer _strips;            //!< Charge collected by strips
+		StripBuffer _stripsCrossTalk;   //!< Charge after crosstalk
+		
 		// Root output
 #ifdef ROOT_OUTPUT_LAND		
 		TFile * _rootFile;
@@ -85,8 +85,8 @@ class SiStripGeom
 		//! Returns the input cellID0 where the field sensor is put to 0
 		virtual int cellID0withSensor0(const int & cellID0) const =0 ;
 
-		//!Encode cellID
-		//virtual int encodeCellID(short int layerID, short int ladderID, short int sensorID) const;
+		//!Encode cellID (layerID in C-type numbering)
+		virtual int encodeCellID(const int & layerID, const int & ladderID, const int & sensorID) const = 0;
 		//!Decode cellID1
 		//virtual void decodeCellID(short int & layerID, short int & ladderID, short int & sensorID, int cellID) const;
 		virtual std::map<std::string,int> decodeCellID(const UTIL::BitField64 & cellDec) const = 0;
@@ -104,6 +104,8 @@ class SiStripGeom
 		// LAYER PROPERTIES
 		//!Get number of layers
 		virtual short int getNLayers() const {return _numberOfLayers;}
+		//!Get number of layer IDs in C-type numbering 0 - n (both sides in FTD)
+		virtual short int getNLayerIDs() const {return _layerRealID.size();}
 		//!Get layer real ID
 		virtual int getLayerRealID(short int layerID) const;
 		
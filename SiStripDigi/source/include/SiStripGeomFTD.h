@@ -5,7 +5,7 @@
 #include<string>
 
 // Include CLHEP header files
-// Include CLHEP header files
+#include <CLHEP/Vector/Rotation.h>
 
 #include "SiStripGeom.h"
 
@@ -58,6 +58,9 @@ class SiStripGeomFTD: public SiStripGeom
 		//! Returns the input cellID0 where the field sensor is put to 0
 		virtual int cellID0withSensor0(const int & cellID0) const;
 
+		//!Encode cellID0 of given disk, petal and sensor - inverse of decodeCellID
+		virtual int encodeCellID(const int & diskID, const int & petalID, const int & sensorID) const;
+
 		//!Method to extract codification ID, 
 		//std::map<std::string,short int> cellIDDecProv(EVENT::SimTrackerHit * & simHit);
 		virtual std::map<std::string,int> decodeCellID(const UTIL::BitField64 & cellID) const;
@@ -169,6 +172,44 @@ class SiStripGeomFTD: public SiStripGeom
 		virtual void printSensorParams(short int layerID) const;
 
 	private:
+		//! Sensor frame - the local ref. system of one sensor given by the
+		//! (disk, petal, sensor) placement, calculated once in initGearParams
+		struct SensorFrame
+		{
+			double originX;  //!< |x| of the local origin (the sign follows the point)
+			double originY;  //!< |y| of the local origin (the sign follows the point)
+			double originZ;  //!< z of the local origin
+			CLHEP::HepRotation rotToLocal;    //!< Rotation global -> local
+			CLHEP::Hep3Vector originGlobal;   //!< Local origin used by local -> global
+			CLHEP::HepRotation rotToGlobal;   //!< Rotation local -> global
+		};
+
+		//! Fill the sensor frames and the per-disk tables
+		void buildGeometryTables();
+
+		//! Get the frame of given sensor
+		inline const SensorFrame & getSensorFrame(const int & diskID, 
+				const int & petalID, const int & sensorID) const
+		{
+			return _sensorFrames[_diskFrameBegin[diskID] + 4*petalID + sensorID - 1];
+		}
+
+		//! Get the shift of a point due to the rotation of the petal around
+		//! its center by the stereo angle (see transformPointToRotatedLocal)
+		inline const CLHEP::Hep3Vector & getRotCentreShift(const int & diskID, 
+				const int & sensorID) const
+		{
+			return _rotCentreShift[2*diskID + (sensorID > 2 ? 1 : 0)];
+		}
+
+		//! Transform point to local ref. system of given sensor frame
+		CLHEP::Hep3Vector pointToLocal(const SensorFrame & frame, const int & diskID,
+				const CLHEP::Hep3Vector & globalPoint) const;
+
+		//! Transform point from local ref. system of given sensor frame
+		CLHEP::Hep3Vector pointToGlobal(const SensorFrame & frame, const int & diskID,
+				const CLHEP::Hep3Vector & localPoint) const;
+
 		gear::FTDParameters * _ftdParams;
 		gear::FTDLayerLayout * _ftdLayer;
 		
@@ -186,6 +227,12 @@ class SiStripGeomFTD: public SiStripGeom
 		std::vector<double> _layerOuterRadius;
 		std::vector<double> _layerPetalOpAngle;
 		std::vector<double> _ladderZOffsetSign0;
+
+		// Geometry tables (see buildGeometryTables)
+		std::vector<SensorFrame> _sensorFrames;       //!< Frames of all sensors
+		std::vector<int> _diskFrameBegin;             //!< First frame of each disk
+		std::vector<double> _layerTanHalfPhi;         //!< tan of the petal semiangle
+		std::vector<CLHEP::Hep3Vector> _rotCentreShift; //!< Stereo rotation shift (2*disk + rear)
 	
 }; // Class
 
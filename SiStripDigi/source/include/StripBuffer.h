@@ -0,0 +1,164 @@
+#ifndef STRIPBUFFER_H
+#define STRIPBUFFER_H 1
+
+#include <vector>
+#include <utility>
+
+// Include LCIO header files
+#include <EVENT/SimTrackerHit.h>
+
+// Include Digi header files
+#include "SiStripGeom.h"
+
+namespace sistrip {
+
+//!
+//! StripBuffer holds the signals of all hit strips of all sensors in one event.
+//! Signals are first added as deposits (strip, charge, time and MC truth info
+//! about SimTrackerHits, in any order); compact() then merges all deposits of
+//! the same strip: the charges are summed, the time of the first deposit is
+//! kept and the weights of the same SimTrackerHit are summed. The result is
+//! stored in flat arrays (structure of arrays) ordered by sensor cellID, strip
+//! type and strip ID, so that all strips of one sensor and strip type form a
+//! contiguous index range [getBegin, getEnd), and neighbouring strips are
+//! neighbouring indices. Deposits added after compact() are merged with the
+//! existing strips by the next compact() (the existing strips act as the first
+//! deposits). The buffer is meant to be reused event by event - clear() keeps
+//! the allocated memory.
+//!
+class StripBuffer {
+
+ public:
+
+//!Constructor
+   StripBuffer() {;}
+
+//!Destructor
+   ~StripBuffer() {;}
+
+
+// FILL METHODS
+
+//!Add signal deposited at strip stripID of sensor cellID, strip type type
+   void addDeposit(int cellID, StripType type, int stripID, double charge, double time);
+
+//!Add MC truth information (SimTrackerHit, weight) to the last added deposit
+   inline void addDepositSimHit(EVENT::SimTrackerHit * simHit, float weight)
+   {
+      _depSimHit.push_back(std::make_pair(simHit, weight));
+   }
+
+//!Add MC truth information of strip i of src, weights multiplied by factor,
+//!to the last added deposit
+   void addDepositSimHits(const StripBuffer & src, int i, double factor);
+
+//!Merge all deposits (and existing strips) into strips (deposits are released)
+   void compact();
+
+//!Release all strips and deposits, the memory is kept for next use
+   void clear();
+
+//!Swap content with other buffer
+   void swap(StripBuffer & other);
+
+
+// GET METHODS - valid after compact()
+
+//!Get number of sensors with hit strips
+   inline int getNSensors() const {return _cellID.size();}
+
+//!Get cellID of sensor iSensor (sensors are ordered by cellID)
+   inline int getCellID(int iSensor) const {return _cellID[iSensor];}
+
+//!Get index of the first strip of sensor iSensor and given strip type
+   inline int getBegin(int iSensor, StripType type) const {return _sideBegin[2*iSensor + type];}
+
+//!Get index behind the last strip of sensor iSensor and given strip type
+   inline int getEnd(int iSensor, StripType type) const {return _sideBegin[2*iSensor + type + 1];}
+
+//!Get index of strip stripID of sensor cellID and given strip type, -1 if not hit
+   int findStrip(int cellID, StripType type, int stripID) const;
+
+//!Get total number of strips
+   inline int getNStrips() const {return _stripID.size();}
+
+//!Get strip ID of strip i
+   inline int getStripID(int i) const {return _stripID[i];}
+
+//!Get signal of strip i
+   inline double getCharge(int i) const {return _charge[i];}
+
+//!Set signal of strip i
+   inline void setCharge(int i, double charge) {_charge[i] = charge;}
+
+//!Update signal of strip i
+   inline void updateCharge(int i, double charge) {_charge[i] += charge;}
+
+//!Get time when signal of strip i was created
+   inline double getTime(int i) const {return _time[i];}
+
+//!Get index of the first SimTrackerHit which contributed to strip i
+   inline int getSimHitBegin(int i) const {return _simHitBegin[i];}
+
+//!Get index behind the last SimTrackerHit which contributed to strip i
+   inline int getSimHitEnd(int i) const {return _simHitBegin[i+1];}
+
+//!Get SimTrackerHit k (SimTrackerHits of one strip are ordered as in SimTrackerHitMap)
+   inline EVENT::SimTrackerHit * getSimHit(int k) const {return _simHit[k].first;}
+
+//!Get weight of SimTrackerHit k
+   inline float getSimHitWeight(int k) const {return _simHit[k].second;}
+
+//!Get MC truth information of strip i - total sum of individual weights
+   float getSimHitWeightSum(int i) const;
+
+
+ private:
+
+   typedef std::pair<EVENT::SimTrackerHit *, float> SimHitWeight;
+
+//!Sort order of deposits - sensor side (2*sensor + strip type), then strip ID
+   class DepositLess {
+    public:
+      DepositLess(const std::vector<int> & side, const std::vector<int> & stripID) : _side(side), _stripID(stripID) {;}
+      bool operator()(int a, int b) const
+      {
+         if (_side[a] != _side[b]) return _side[a] < _side[b];
+         return _stripID[a] < _stripID[b];
+      }
+    private:
+      const std::vector<int> & _side;
+      const std::vector<int> & _stripID;
+   };
+
+//!Sort order of SimTrackerHits - as in SimTrackerHitMap
+   static bool simHitLess(const SimHitWeight & a, const SimHitWeight & b);
+
+   // Deposits
+   std::vector<int>          _depCellID;      //!< Deposit - sensor cellID
+   std::vector<int>          _depType;        //!< Deposit - strip type
+   std::vector<int>          _depStripID;     //!< Deposit - strip ID
+   std::vector<double>       _depCharge;      //!< Deposit - charge
+   std::vector<double>       _depTime;        //!< Deposit - time
+   std::vector<int>          _depSimHitBegin; //!< Deposit - index of the first SimTrackerHit
+   std::vector<SimHitWeight> _depSimHit;      //!< Deposit - SimTrackerHits and weights
+
+   // Strips
+   std::vector<int>          _cellID;         //!< Sensor cellIDs (ordered)
+   std::vector<int>          _sideBegin;      //!< First strip of each sensor side (2*sensor + strip type)
+   std::vector<int>          _stripID;        //!< Strip ID
+   std::vector<double>       _charge;         //!< Strip signal
+   std::vector<double>       _time;           //!< Time when strip signal was created
+   std::vector<int>          _simHitBegin;    //!< First SimTrackerHit of each strip
+   std::vector<SimHitWeight> _simHit;         //!< SimTrackerHits and weights
+
+   // Work arrays used by compact()
+   std::vector<int>          _depSide;
+   std::vector<int>          _order;
+   std::vector<SimHitWeight> _stripSimHit;
+
+}; // Class
+
+} // Namespace
+
+#endif // STRIPBUFFER_H
@@ -1,13 +1,20 @@
 #ifndef STRIPCLUSTER_H
 #define STRIPCLUSTER_H 1
 
-#include "Signal.h"
+#include <map>
+
+// Include LCIO header files
+#include <lcio.h>
+#include <EVENT/SimTrackerHit.h>
 
 // Include CLHEP header files
 #include <CLHEP/Vector/ThreeVector.h>
 
 namespace sistrip {
 
+// Typedefs
+typedef std::map<EVENT::SimTrackerHit *, float>  SimTrackerHitMap; // Hit, weight
+
 //! This class holds all information about strip clusters, where the strip
 //! cluster is defined as a bunch of strips, where at least one strip has its
 //! signal above so-called seed threshold and other strips above threshold lower
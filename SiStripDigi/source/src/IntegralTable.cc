@@ -0,0 +1,3 @@
+#include "IntegralTable.h"
+
+namespace sistrip {}
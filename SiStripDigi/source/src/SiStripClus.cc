@@ -197,6 +197,11 @@ SiStripClus::SiStripClus() : Processor("SiStripClus")
 			_TanOfAvgHLorentzShift,
 			float(0.039) );
 
+	registerProcessorParameter( "NumberOfThreads",
+			"Number of threads used to search for clusters in different sensors",
+			_nThreads,
+			int(1) );
+
 	registerProcessorParameter( "InputCollectionName",
 			"Name of TrackerPulse input collection",
 			_inColName,
@@ -412,8 +417,8 @@ void SiStripClus::processEvent(LCEvent * event)
 		// Initialize variables
 		TrackerPulseImpl * pulse = 0;
 		
-		// Sensor map with map of hit strips (corresponding to the given sensor)
-		SensorStripMap sensorMap;
+		// Hit strips of all sensors
+		_strips.clear();
 		
 		// Get number of elements in each collection
 		int nPulses = colOfTrkPulses->getNumberOfElements();
@@ -425,16 +430,19 @@ void SiStripClus::processEvent(LCEvent * event)
 			pulse = dynamic_cast<TrackerPulseImpl*>( 
 					colOfTrkPulses->getElementAt(i) );
 			
-			// Update the sensor strip map with the pulse
-			updateMap(pulse, sensorMap);
+			// Update the strip buffer with the pulse
+			updateMap(pulse, _strips);
 		}
 		
+		// Order the strips by sensor, strip type and strip ID
+		_strips.compact();
+		
 		//
 		// Find clusters
-		ClsVec clsVec = findClus(sensorMap);
+		ClsVec clsVec = findClus(_strips);
 		
-		// Releasing memory and clearing
-		releaseMap(sensorMap);
+		// Clearing
+		_strips.clear();
 
 		//
 		// Calculate real + ghost hits from clusters - in global ref. system + 
@@ -500,252 +508,81 @@ void SiStripClus::end()
 //
 // Method searching for clusters
 //
-typedef std::pair<int,StripCluster*> StripClusterPair;
-typedef std::map<int,std::map<StripType,std::vector<StripClusterPair> > > SensorStripClusterMap;
-
-ClsVec SiStripClus::findClus(SensorStripMap & sensorMap)
+ClsVec SiStripClus::findClus(StripBuffer & strips)
 {
 	ClsVec clsVec;
 	
-	// Cluster vectors - 
-	SensorStripClusterMap clsvectFrontRear; 
-	
-	std::vector<StripType> stv;
-	stv.push_back(STRIPFRONT);
-	stv.push_back(STRIPREAR);
-	// As the sensorID was lost (see SiStripClus::updateMap method)
-	// assigning it
-	std::map<StripType,int> stSensorIDmap;
-	stSensorIDmap[STRIPFRONT] = 1;
-	stSensorIDmap[STRIPREAR]  = 3;
+	const int nSensors = strips.getNSensors();
 	
-	// Bunch of strips forming cluster
-	StripChargeMap clsStrips;
+	// Cluster vectors - one per sensor side (2*sensor + strip type)
+	_sideClusters.resize(2*nSensors);
+	for(unsigned int i=0; i<_sideClusters.size(); ++i)
+	{
+		_sideClusters[i].clear();
+	}
 	
 	//
-	// Search complete sensor map - find seeds & their neghbouring strips
-	for(SensorStripMap::iterator iterSMap = sensorMap.begin(); iterSMap!=sensorMap.end();
-			++iterSMap)
+	// Search all sensors - find seeds & their neghbouring strips. Sensors are
+	// independent (each one changes only its own strips and cluster vectors), 
+	// so they may be shared among threads
+	if(_nThreads > 1 && nSensors > 1)
 	{
-	     // Save layer ID , ...
-	     const int cellID = iterSMap->first;
-	     std::map<std::string,int> bfmap = _geometry->decodeCellID(cellID);
-	     const int layerID = bfmap["layer"];
-	     const int ladderID= bfmap["module"];
-
-             // Storing the two types of clusters
-	     for(std::vector<StripType>::iterator itST = stv.begin(); itST!= stv.end();
-			     ++itST)
-	     {
-		   StripType STRIPTYPE = *itST;
-		   for(StripChargeMap::iterator iterChMap=iterSMap->second[STRIPTYPE].begin(); 
-				     iterChMap!=iterSMap->second[STRIPTYPE].end(); iterChMap++) 
-		   {
-			const int sensorID= stSensorIDmap[STRIPTYPE];
-			
-			// Begin algorithm
-			// Zero: Save new candidate for seed strip + MC true info
-			const int seedStrip  = iterChMap->first;
-			const double seedCharge = iterChMap->second->getCharge();
-			
-			const SimTrackerHitMap & seedSimHitMap=iterChMap->second->getSimHitMap();
-			
-			if( seedCharge < (_SNseed*_CMSnoise) )
-			{
-				continue;
-			}
-			
-			// First: New cluster and its seed strip has been found 
-			clsStrips[seedStrip] = new Signal(seedCharge, 0.);
-			clsStrips[seedStrip]->updateSimHitMap(seedSimHitMap);
-			
-			// Set this charge as zero to avoid double counting
-			iterChMap->second->setCharge(0.);
-			
-			// Map ordered from lower to higher
-			// Continue searching - find left and right neighbours
-			// Taking account also the floating strips case...
-			StripChargeMap::iterator seedIt=iterSMap->second[STRIPTYPE].find(seedStrip); 
-			// Second: search for left neighbours
-			//-- Left neighbours
-			StripChargeMap::reverse_iterator lschMap(seedIt);
-			clsStrips = storeHitsAdjacents<StripChargeMap::reverse_iterator>(
-					clsStrips, lschMap, iterSMap->second[STRIPTYPE].rend(),
-					iterSMap->second[STRIPTYPE]);
-
-			// Third: search for rigth neighbours
-			//-- Right neighbours
-			StripChargeMap::iterator rschMap(++seedIt);
-			clsStrips = storeHitsAdjacents<StripChargeMap::iterator>(clsStrips, 
-					rschMap, iterSMap->second[STRIPTYPE].end(),
-					iterSMap->second[STRIPTYPE]);
-			
-			// Fourth: Calculate mean position of a new cluster
-			SimTrackerHitMap clsSimHitMap;
-			
-			// Cluster: position, charge & size
-			double    clsCharge  = 0.0;
-			
-			double xLeftSignal   = 0.0;
-			double qLeftSignal   = 0.0;
-			
-			double xRightSignal  = 0.0;
-			double qRightSignal  = 0.0;
-			
-			double qIntermSignal = 0.0;
-			
-			int stripID = 0;
-			for(StripChargeMap::iterator iterChMap2=clsStrips.begin(); 
-					iterChMap2!=clsStrips.end(); iterChMap2++) 
-			{
-			    // Current strip ID, posZ & charge
-			    stripID        = iterChMap2->first;
-			    const double stripPosYatz0= _geometry->getStripPosY(layerID, 
-					    sensorID,stripID,0.0);
-
-			    const double stripCharge = iterChMap2->second->getCharge();
-			    
-			    // Update info about MC particles which contributed
-			    const SimTrackerHitMap & simHitMap = 
-				    iterChMap2->second->getSimHitMap();
-			    
-			    if(simHitMap.size() != 0) 
-			    {
-			        for(SimTrackerHitMap::const_iterator iterSHM=simHitMap.begin();
-						iterSHM!=simHitMap.end(); ++iterSHM) 
-				{
-				     EVENT::SimTrackerHit * simHit = 
-					     dynamic_cast<EVENT::SimTrackerHit *>(iterSHM->first);
-				     float weight = iterSHM->second;
-				     if(clsSimHitMap.find(simHit)!=clsSimHitMap.end()) 
-				     {
-					     clsSimHitMap[simHit] += weight;
-				     }
-				     else
-				     {
-					     clsSimHitMap[simHit]  = weight;						
-				     }
-				}
-			    }
-			    
-			    // Get last iterator
-			    
-			    // Get leftmost signal
-			    if(iterChMap2 == clsStrips.begin()) 
-			    {
-				    xLeftSignal = stripPosYatz0;
-				    qLeftSignal = stripCharge;
-			    }
-			    
-			    // Get rightmost signal
-			    else if(iterChMap2 == --(clsStrips.end())) 
-			    {	
-				    xRightSignal = stripPosYatz0;
-				    qRightSignal = stripCharge;
-			    }
-			    // Get intermediate signal
-			    else
-			    {
-				    qIntermSignal += stripCharge;
-			    }
-			    
-			    // Update total charge
-			    clsCharge += stripCharge;
-			    
-			}
-			
-			// Number of strips being part of cluster
-			int clsSize   = clsStrips.size();
-			// Get average intermediate signal
-			if (clsSize > 2) 
-			{
-				qIntermSignal /= (clsSize - 2.0);
-			}
-			else
-			{
-				qIntermSignal  = 0.;
-			}
+		const int nThreads = (_nThreads < nSensors) ? _nThreads : nSensors;
+		
+		std::vector<pthread_t>      threads(nThreads);
+		std::vector<ClusThreadArgs> threadArgs(nThreads);
+		std::vector<bool>           threadStarted(nThreads, false);
+		
+		for(int iThread=0; iThread<nThreads; ++iThread)
+		{
+			threadArgs[iThread].processor = this;
+			threadArgs[iThread].strips    = &strips;
+			threadArgs[iThread].iThread   = iThread;
+			threadArgs[iThread].nThreads  = nThreads;
 			
-			// Building the cluster
-			double geomPitchAtz0 = _geometry->getSensorPitch(layerID,sensorID,0.0);
-			double readOutPitch = 0.;
-			if(_floatStripsZ)  // FIXME---> CAMBIAR POR mapa _floatStrips[type]
+			if(pthread_create(&threads[iThread], 0, &SiStripClus::findClusThread, 
+						&threadArgs[iThread]) == 0)
 			{
-				readOutPitch = 2.0*geomPitchAtz0;
+				threadStarted[iThread] = true;
 			}
 			else
 			{
-				readOutPitch = geomPitchAtz0;
+				// Thread couldn't be created - do its work here
+				findClusThread(&threadArgs[iThread]);
 			}
-			
-			double clsPosYatz0 = 0.0;
-			// Analog head-tail algorithm
-			// qIntermSignal >= 1/eps*qRighSignal || 1/eps*qLeftSignal 
-			//    --> if not don't use head-tail (delta electron ...) - use 
-			//        epsilon ~ 1.5
-			if( (clsSize>2) && (qLeftSignal<1.5*qIntermSignal) 
-					&& (qRightSignal<1.5*qIntermSignal) ) 
-			{
-				clsPosYatz0 = (xRightSignal + xLeftSignal)/2. 
-					+ (qRightSignal - qLeftSignal)/2./qIntermSignal * readOutPitch;
-			}
-			else  // COG algorithm
-			{
-				clsPosYatz0 = (xRightSignal*qRightSignal 
-						+ xLeftSignal*qLeftSignal)/(qRightSignal + qLeftSignal);
-			}
-	
-			
-			//
-			// Fifth: Correct mean position to Lorentz shift 
-			// As theta is Pi/2.0 --> this correction is 0: FIXME-> TO BE REMOVED
-			clsPosYatz0 += _TanOfAvgHLorentzShift 
-				* _geometry->getSensorThick(layerID)/2.
-				* cos(_geometry->getLadderTheta(layerID));
-			
-			//
-			// Sixth: Save information about new cluster
-			if(clsCharge >= (_SNtotal*_CMSnoise)) 
-			{
-			      StripCluster * pCluster = new StripCluster( layerID, 
-			           ladderID, sensorID, 
-				   Hep3Vector(_geometry->getSensorThick(layerID)/2.,
-					   clsPosYatz0, 0.0),
-				   Hep3Vector(_geometry->getSensorThick(layerID)/2., 0., 0.), 
-				   clsCharge, clsSize );
-			      pCluster->updateSimHitMap(clsSimHitMap);
-			      
-			      clsvectFrontRear[cellID][STRIPTYPE].push_back(
-					      std::pair<int,StripCluster*>(stripID,pCluster));
-			}
-			
-			// Release memory
-			for(StripChargeMap::iterator iterChMap2=clsStrips.begin(); 
-					iterChMap2!=clsStrips.end(); iterChMap2++) 
+		}
+		for(int iThread=0; iThread<nThreads; ++iThread)
+		{
+			if(threadStarted[iThread])
 			{
-				delete iterChMap2->second; //Signal pointers
+				pthread_join(threads[iThread], 0);
 			}
-			
-			// Clear content
-			clsStrips.clear();
-		   } 
-	     }  // For cluster strip type (front-rear)
-	}  // For sensor map
+		}
+	}
+	else
+	{
+		for(int iSensor=0; iSensor<nSensors; ++iSensor)
+		{
+			findSensorClus(strips, iSensor);
+		}
+	}
 	
 	
-	// Stores the hit (using the STRIPFRONT as init)
-	for(SensorStripClusterMap::iterator it = clsvectFrontRear.begin();
-			it != clsvectFrontRear.end(); ++it)
+	// Stores the hit (using the STRIPFRONT as init), sensors ordered by cellID
+	for(int iSensor=0; iSensor<nSensors; ++iSensor)
 	{
-		const int cellID = it->first;
+		const int cellID = strips.getCellID(iSensor);
 		std::map<std::string,int> bfmap = _geometry->decodeCellID(cellID);
 		const int layerID = bfmap["layer"];
 		const int ladderID= bfmap["module"];
 		
+		std::vector<StripClusterPair> & clsFront = _sideClusters[2*iSensor + STRIPFRONT];
+		std::vector<StripClusterPair> & clsRear  = _sideClusters[2*iSensor + STRIPREAR];
+		
 		// the front sensors
 		for(std::vector<StripClusterPair>::iterator 
-				itFront = it->second[STRIPFRONT].begin();
-				itFront != it->second[STRIPFRONT].end(); ++itFront)
+				itFront = clsFront.begin();
+				itFront != clsFront.end(); ++itFront)
 		{
 			const int stripIDFront = itFront->first;     
 			// Extracting the points in the edges
@@ -757,8 +594,8 @@ ClsVec SiStripClus::findClus(SensorStripMap & sensorMap)
 			
 			// Checking with the Rear sensors
 			for(std::vector<StripClusterPair>::iterator 
-					itRear = it->second[STRIPREAR].begin();
-					itRear != it->second[STRIPREAR].end(); ++itRear)
+					itRear = clsRear.begin();
+					itRear != clsRear.end(); ++itRear)
 			{
 			      const int stripIDRear = itRear->first;
 			      // Extracting the points in the edges and put them in a common
@@ -935,7 +772,7 @@ ClsVec SiStripClus::findClus(SensorStripMap & sensorMap)
 			      clsVec.push_back(pCluster3D);
 			}  // for rear sensors
 		}  // for front sensors
-	} // For cluster strip vector pairs
+	} // For sensors
 	
 /*	for(SensorStripClusterMap::iterator it = clsvectFrontRear.begin(); 
 			it != clsvectFrontRear.end(); ++it)
@@ -960,28 +797,228 @@ ClsVec SiStripClus::findClus(SensorStripMap & sensorMap)
 	*/
 
 	// Release memory
-	for(SensorStripClusterMap::iterator it = clsvectFrontRear.begin();
-			it != clsvectFrontRear.end(); ++it)
+	for(unsigned int i=0; i<_sideClusters.size(); ++i)
 	{
-              for(std::map<StripType,std::vector<StripClusterPair> >::iterator itMap = 
-			      it->second.begin();
-			      itMap != it->second.end(); ++itMap)
-	      {
-		    for(std::vector<StripClusterPair>::iterator itSCl = itMap->second.begin();
-				    itSCl != itMap->second.end(); ++itSCl)
-		    {
-			    if( itSCl->second != 0)
-			    {
-				    delete itSCl->second;
-			    }
-		    }
-	      }
+		for(std::vector<StripClusterPair>::iterator itSCl = _sideClusters[i].begin();
+				itSCl != _sideClusters[i].end(); ++itSCl)
+		{
+			if( itSCl->second != 0)
+			{
+				delete itSCl->second;
+			}
+		}
+		_sideClusters[i].clear();
 	}
 
 
 	return clsVec;
 }
 
+//
+// Method searching for clusters in one sensor (both strip types)
+//
+void SiStripClus::findSensorClus(StripBuffer & strips, int iSensor)
+{
+	std::vector<StripType> stv;
+	stv.push_back(STRIPFRONT);
+	stv.push_back(STRIPREAR);
+	
+	// Save layer ID , ...
+	const int cellID = strips.getCellID(iSensor);
+	std::map<std::string,int> bfmap = _geometry->decodeCellID(cellID);
+	const int layerID = bfmap["layer"];
+	const int ladderID= bfmap["module"];
+	
+	// Storing the two types of clusters
+	for(std::vector<StripType>::iterator itST = stv.begin(); itST!= stv.end();
+			++itST)
+	{
+		   StripType STRIPTYPE = *itST;
+		   // As the sensorID was lost (see SiStripClus::updateMap method)
+		   // assigning it
+		   const int sensorID = (STRIPTYPE == STRIPFRONT) ? 1 : 3;
+		   
+		   std::vector<StripClusterPair> & clusters = _sideClusters[2*iSensor + STRIPTYPE];
+		   
+		   // Strips are ordered from lower to higher
+		   const int iBegin = strips.getBegin(iSensor, STRIPTYPE);
+		   const int iEnd   = strips.getEnd(iSensor, STRIPTYPE);
+		   for(int iSeed=iBegin; iSeed!=iEnd; ++iSeed) 
+		   {
+			// Begin algorithm
+			// Zero: Candidate for seed strip
+			const double seedCharge = strips.getCharge(iSeed);
+			
+			if( seedCharge < (_SNseed*_CMSnoise) )
+			{
+				continue;
+			}
+			
+			// First: New cluster and its seed strip has been found 
+			// Continue searching - find left and right neighbours
+			// (neighbouring strips are neighbouring indices)
+			// Second: search for left neighbours
+			int iLeft = iSeed;
+			while( iLeft-1 >= iBegin && strips.getCharge(iLeft-1) >= (_SNadjacent*_CMSnoise) )
+			{
+				--iLeft;
+			}
+			// Third: search for rigth neighbours
+			int iRight = iSeed;
+			while( iRight+1 < iEnd && strips.getCharge(iRight+1) >= (_SNadjacent*_CMSnoise) )
+			{
+				++iRight;
+			}
+			
+			// Fourth: Calculate mean position of a new cluster
+			SimTrackerHitMap clsSimHitMap;
+			
+			// Cluster: position, charge & size
+			double    clsCharge  = 0.0;
+			
+			double xLeftSignal   = 0.0;
+			double qLeftSignal   = 0.0;
+			
+			double xRightSignal  = 0.0;
+			double qRightSignal  = 0.0;
+			
+			double qIntermSignal = 0.0;
+			
+			int stripID = 0;
+			for(int i=iLeft; i<=iRight; ++i) 
+			{
+			    // Current strip ID, posZ & charge
+			    stripID        = strips.getStripID(i);
+			    const double stripPosYatz0= _geometry->getStripPosY(layerID, 
+					    sensorID,stripID,0.0);
+
+			    const double stripCharge = strips.getCharge(i);
+			    
+			    // Set this charge as zero to avoid double counting
+			    strips.setCharge(i, 0.);
+			    
+			    // Update info about MC particles which contributed
+			    for(int k=strips.getSimHitBegin(i); k!=strips.getSimHitEnd(i); ++k) 
+			    {
+				 EVENT::SimTrackerHit * simHit = strips.getSimHit(k);
+				 float weight = strips.getSimHitWeight(k);
+				 if(clsSimHitMap.find(simHit)!=clsSimHitMap.end()) 
+				 {
+					 clsSimHitMap[simHit] += weight;
+				 }
+				 else
+				 {
+					 clsSimHitMap[simHit]  = weight;						
+				 }
+			    }
+			    
+			    // Get leftmost signal
+			    if(i == iLeft) 
+			    {
+				    xLeftSignal = stripPosYatz0;
+				    qLeftSignal = stripCharge;
+			    }
+			    
+			    // Get rightmost signal
+			    else if(i == iRight) 
+			    {	
+				    xRightSignal = stripPosYatz0;
+				    qRightSignal = stripCharge;
+			    }
+			    // Get intermediate signal
+			    else
+			    {
+				    qIntermSignal += stripCharge;
+			    }
+			    
+			    // Update total charge
+			    clsCharge += stripCharge;
+			    
+			}
+			
+			// Number of strips being part of cluster
+			int clsSize   = iRight - iLeft + 1;
+			// Get average intermediate signal
+			if (clsSize > 2) 
+			{
+				qIntermSignal /= (clsSize - 2.0);
+			}
+			else
+			{
+				qIntermSignal  = 0.;
+			}
+			
+			// Building the cluster
+			double geomPitchAtz0 = _geometry->getSensorPitch(layerID,sensorID,0.0);
+			double readOutPitch = 0.;
+			if(_floatStripsZ)  // FIXME---> CAMBIAR POR mapa _floatStrips[type]
+			{
+				readOutPitch = 2.0*geomPitchAtz0;
+			}
+			else
+			{
+				readOutPitch = geomPitchAtz0;
+			}
+			
+			double clsPosYatz0 = 0.0;
+			// Analog head-tail algorithm
+			// qIntermSignal >= 1/eps*qRighSignal || 1/eps*qLeftSignal 
+			//    --> if not don't use head-tail (delta electron ...) - use 
+			//        epsilon ~ 1.5
+			if( (clsSize>2) && (qLeftSignal<1.5*qIntermSignal) 
+					&& (qRightSignal<1.5*qIntermSignal) ) 
+			{
+				clsPosYatz0 = (xRightSignal + xLeftSignal)/2. 
+					+ (qRightSignal - qLeftSignal)/2./qIntermSignal * readOutPitch;
+			}
+			else  // COG algorithm
+			{
+				clsPosYatz0 = (xRightSignal*qRightSignal 
+						+ xLeftSignal*qLeftSignal)/(qRightSignal + qLeftSignal);
+			}
+	
+			
+			//
+			// Fifth: Correct mean position to Lorentz shift 
+			// As theta is Pi/2.0 --> this correction is 0: FIXME-> TO BE REMOVED
+			clsPosYatz0 += _TanOfAvgHLorentzShift 
+				* _geometry->getSensorThick(layerID)/2.
+				* cos(_geometry->getLadderTheta(layerID));
+			
+			//
+			// Sixth: Save information about new cluster
+			if(clsCharge >= (_SNtotal*_CMSnoise)) 
+			{
+			      StripCluster * pCluster = new StripCluster( layerID, 
+			           ladderID, sensorID, 
+				   Hep3Vector(_geometry->getSensorThick(layerID)/2.,
+					   clsPosYatz0, 0.0),
+				   Hep3Vector(_geometry->getSensorThick(layerID)/2., 0., 0.), 
+				   clsCharge, clsSize );
+			      pCluster->updateSimHitMap(clsSimHitMap);
+			      
+			      clusters.push_back(StripClusterPair(stripID,pCluster));
+			}
+		   } 
+	}  // For cluster strip type (front-rear)
+}
+
+//
+// Thread clustering every nThreads-th sensor
+//
+void * SiStripClus::findClusThread(void * arg)
+{
+	ClusThreadArgs * threadArgs = static_cast<ClusThreadArgs *>(arg);
+	
+	for(int iSensor=threadArgs->iThread; iSensor<threadArgs->strips->getNSensors(); 
+			iSensor+=threadArgs->nThreads)
+	{
+		threadArgs->processor->findSensorClus(*(threadArgs->strips), iSensor);
+	}
+	
+	return 0;
+}
+
 			//-- Right neighbours
 /*			adjCharge = 0.0;
 			goNextStrip = true;
@@ -1636,43 +1673,6 @@ std::cout << " ---- OK!!" << std::endl;
 
 // OTHER METHODS
 			
-//
-// Calculated and stored the hits adjacents
-// Template for the reverse_iterator (leftStrips) and iterator (rightStrips)
-//
-
-template<class It>
-StripChargeMap & SiStripClus::storeHitsAdjacents( StripChargeMap & clsStrips, 
-		It schMap, const It & endIt, StripChargeMap & currentMap)
-{
-	// Map ordered from lower to higher
-	double adjCharge = 0.0;
-	bool goNextStrip = true;
-	while( goNextStrip && schMap != endIt )
-	{
-		adjCharge = schMap->second->getCharge();
-		const SimTrackerHitMap & adjSimHitMap = schMap->second->getSimHitMap();
-		// Charge higher than threshold set
-		if( adjCharge >= (_SNadjacent*_CMSnoise) ) 
-		{
-			clsStrips[schMap->first] = new Signal(adjCharge, 0.);
-			clsStrips[schMap->first]->updateSimHitMap(adjSimHitMap);
-			// Set this charge as zero to avoid 
-			// double counting
-			currentMap[schMap->first]->setCharge(0.);
-			// And go on to the next strip
-			++schMap;
-		}
-		else  // Charge lower - stop searching
-		{
-			goNextStrip = false;
-		}
-	}
-
-	return clsStrips;
-}
-
-
 //
 // Method calculating hits from given clusters
 //
@@ -1938,14 +1938,13 @@ float * SiStripClus::calcResolution(const int & layerID,const double & hitTheta,
 //
 // Method to save the signal 
 // 
-// FTD stuff --> Need to change the sensorMap in order to store in the 
-//               same StripCharge map the two opposites sensors of the same disk-petal
-//               as in FTD the Hits are built using two Single side sensors of the same
-//               disk-petal
+// FTD stuff --> The two opposites sensors of the same disk-petal are stored
+//               as the same sensor (sensorID = 0) in the strip buffer, as in
+//               FTD the Hits are built using two Single side sensors of the
+//               same disk-petal
 //
-// FIXME: Returns the SensorStripMap
 void SiStripClus::updateMap(TrackerPulseImpl * pulse,  
-		SensorStripMap & sensorMap )
+		StripBuffer & strips )
 {
 	// CellID0 encodes layerID, ladderID and sensorID; 
 	// cellID1 encodes strip 
@@ -1973,33 +1972,8 @@ void SiStripClus::updateMap(TrackerPulseImpl * pulse,
 		exit(0);
 	}
 
-	Signal *signal = 0;
-
-	// Find if sensor already saved in map
-	SensorStripMap::iterator iterSMap = sensorMap.find(cellID0);
-	// If not, create map  for the sensor (cellID0)
-	if(iterSMap == sensorMap.end()) 
-	{
-		// Create map
-		sensorMap[cellID0] = new StripChargeMap[2];
-		// And update the iterator
-		iterSMap = sensorMap.find(cellID0);
-	}
-	
-	// Find if strip already saved in map
-	StripChargeMap::iterator iterChMap = iterSMap->second[stripType].find(stripID);
-	// IF not, create entry for strip, otherwise update
-	if( iterChMap == iterSMap->second[stripType].end() )
-	{
-		signal = new Signal(charge,0.0);
-		iterSMap->second[stripType][stripID] = signal;
-		// And update the iterator
-		iterChMap = iterSMap->second[stripType].find(stripID);
-	}
-	else
-	{
-		iterChMap->second->updateCharge(charge);
-	}
+	// Add the signal, signals of the same strip are summed up by compact()
+	strips.addDeposit(cellID0, stripType, stripID, charge, 0.0);
 
 	// Get MCParticles which contributed and update MCParticles
 	if(_navigatorPls != NULL) 
@@ -2016,41 +1990,13 @@ void SiStripClus::updateMap(TrackerPulseImpl * pulse,
 			EVENT::SimTrackerHit * simHit = dynamic_cast<EVENT::SimTrackerHit *>(*iterLCObjVec);
 			float                  weight = *iterFloatVec;
 			
-			iterChMap->second->updateSimHitMap(simHit, weight);
+			strips.addDepositSimHit(simHit, weight);
 		}
 	}
 	//FIXME CONTROL DE ERRORES
 	//return true;
 }
 
-void SiStripClus::releaseMap( SensorStripMap & sensorMap )
-{
-	// Release memory
-	for(SensorStripMap::iterator iterSMap=sensorMap.begin(); 
-			iterSMap!=sensorMap.end(); iterSMap++) 
-	{
-		//Array contents
-		// Strips in Front
-		for(StripChargeMap::iterator iterChMap=iterSMap->second[STRIPFRONT].begin(); 
-				iterChMap!=iterSMap->second[STRIPFRONT].end(); iterChMap++)
-		{
-			delete iterChMap->second;
-		}
-		// Strips in Rear
-		for(StripChargeMap::iterator iterChMap=iterSMap->second[STRIPREAR].begin(); 
-				iterChMap!=iterSMap->second[STRIPREAR].end(); iterChMap++)
-		{
-			delete iterChMap->second;
-		}
-		
-		// Release memory for array
-		delete [] iterSMap->second;
-	} 
-
-	// Clearing
-	sensorMap.clear();
-}
-
 // PRINT METHODS
 
 //
@@ -2075,6 +2021,7 @@ void SiStripClus::printProcessorParams() const
                            << "  S/N cut for seed strips:     " << std::setw(3) << _SNseed      << std::endl
                            << "  S/N cut for adjacent strips: " << std::setw(3) << _SNadjacent  << std::endl
                            << "  S/N cut for total charge:    " << std::setw(3) << _SNtotal     << std::endl
+                           << "  Number of threads:           " << std::setw(3) << _nThreads    << std::endl
                            << std::resetiosflags(std::ios::showpos)
 	                   		<< std::setprecision(0)
                            << std::endl;
@@ -13,6 +13,7 @@
 
 #include "SiStripGeomBuilder.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <iomanip>
 #include <math.h>
@@ -145,6 +146,16 @@ SiStripDigi::SiStripDigi() : Processor("SiStripDigi")
 			_floatStripsZ,
 			bool(false));
 	
+	registerProcessorParameter( "NoiseHits",
+			"Simulate noise hits, i.e. strips without signal with noise above NoiseHitsThreshold?",
+			_noiseHits,
+			bool(false));
+	
+	registerProcessorParameter( "NoiseHitsThreshold",
+			"Threshold for noise hits, set in units of ElectronicsNoise",
+			_noiseHitsThreshold,
+			float(3.) );
+	
 	registerProcessorParameter( "AbsoluteSpacePrecision",
 			"Absolute digitization space precision, set in microns",
 			_epsSpace,
@@ -160,6 +171,11 @@ SiStripDigi::SiStripDigi() : Processor("SiStripDigi")
 			_epsTime,
 			float(0.01) );
 	
+	registerProcessorParameter( "RombergIntegration",
+			"Integrate drift time and Lorentz shift of each cluster with Romberg method instead of using tables built at init (validation mode)",
+			_rombergIntegration,
+			bool(false));
+	
 	registerProcessorParameter( "InputCollectionName",
 			"Name of SimTrackerHit input collection",
 			_inColName,
@@ -238,8 +254,22 @@ void SiStripDigi::init()
 	_geometry->initGearParams();
 	//	_geometry -> printGearParams();  FIXME
 
+	// Tabulate drift time and Lorentz shift integrals
+	if (!_rombergIntegration)
+	{
+		buildTransportTables();
+	}
+
 	// Initialize random generator (engine, mean, sigma)
 	_genGauss = new RandGauss(new RandEngine(SEED), 0., (double)_elNoise);
+	// Noise hits get an engine with its own state: RandEngine wraps the global
+	// rand()/srand(), so a second one would reseed the engine of _genGauss
+	_noiseHitsEngine = 0;
+	if (_electronicEffects && _noiseHits) _noiseHitsEngine = new HepJamesRandom(SEED+1);
+	_nNoiseHitsExpected = 0.;
+	_nNoiseHits         = 0.;
+	_noiseHitsAmplSum   = 0.;
+	_nNoiseHitsAmpl     = 0.;
 	
 	// Print set parameters
 	printProcessorParams();
@@ -402,8 +432,8 @@ void SiStripDigi::processEvent(LCEvent * event)
 	// Process SimTrackerHit collection
 	if(colOfSimHits != 0) 
 	{
-		// Sensor map of strips with total integrated charge
-		SensorStripMap sensorMap;
+		// Strips with total integrated charge
+		_strips.clear();
 		
 		// Set collection decoder
 		CellIDDecoder<SimTrackerHit> cellIDDec(colOfSimHits);
@@ -501,9 +531,9 @@ void SiStripDigi::processEvent(LCEvent * event)
 			_magField = _geometry->transformVecToLocal(_currentLayerID, 
 					_currentLadderID, _currentSensorID, _magField);
 	
-			// Digitize the given hit and get sensor map of strips with total
-			// integrated charge and time when a particle crossed the sensor
-			digitize(simDigiHit, sensorMap);
+			// Digitize the given hit and add the charge collected by strips 
+			// and time when a particle crossed the sensor
+			digitize(simDigiHit, _strips);
 			
 			// Unset actual sensor parameters
 			_currentLayerID      = 0;
@@ -518,16 +548,25 @@ void SiStripDigi::processEvent(LCEvent * event)
 			
 		} // For - process hits
 		
+		// Sum up the charge collected by each strip
+		_strips.compact();
+		
 		// Add electronics effects
 		if(_electronicEffects)
 		{
 			// Calculate crosstalk and add this effect
-			calcCrossTalk(sensorMap);			
+			calcCrossTalk(_strips, _stripsCrossTalk);
+			_strips.swap(_stripsCrossTalk);
 			// Generate noise and add this effect
-			genNoise(sensorMap);
+			genNoise(_strips);
+			// Generate noise hits in strips without signal
+			if(_noiseHits)
+			{
+				genNoiseHits(_strips);
+			}
 		}
 		// Print final info
-		printStripsInfo("all effects included", sensorMap);
+		printStripsInfo("all effects included", _strips);
 		
 		// Strips Types to loop overt there
 		std::vector<StripType> stripTypesvect;
@@ -621,26 +660,22 @@ void SiStripDigi::processEvent(LCEvent * event)
 				colOfTrkPulses);
 
 		// TrackerPulses
-		SensorStripMap::iterator iterSMap;
-		StripChargeMap::iterator iterChMap;
-		
-	
-		for(iterSMap=sensorMap.begin(); iterSMap!=sensorMap.end(); ++iterSMap) 
+		for(int iSensor=0; iSensor<_strips.getNSensors(); ++iSensor) 
 		{
-	             int cellID = iterSMap->first;
+	             int cellID = _strips.getCellID(iSensor);
 			
 		     for(std::vector<StripType>::iterator stripTypeIt = stripTypesvect.begin();
 				     stripTypeIt != stripTypesvect.end(); ++stripTypeIt)
 		     {
 			 StripType stripType = *stripTypeIt;
-		         for(iterChMap=iterSMap->second[stripType].begin();
-					 iterChMap!=iterSMap->second[stripType].end(); ++iterChMap)
+		         for(int iStrip=_strips.getBegin(iSensor, stripType);
+					 iStrip!=_strips.getEnd(iSensor, stripType); ++iStrip)
 			 {
-			     int       stripID   = iterChMap->first;
+			     int       stripID   = _strips.getStripID(iStrip);
 			     
 			     // Create new Tracker pulse (time in ns, charge in fC), if charge 
 			     // positive, otherwise will be cut-out in clustering anyway
-			     if(iterChMap->second->getCharge() > 0.*fC) 
+			     if(_strips.getCharge(iStrip) > 0.*fC) 
 			     {
 				 TrackerPulseImpl * trkPulse = new TrackerPulseImpl();
 				
@@ -649,22 +684,21 @@ void SiStripDigi::processEvent(LCEvent * event)
 						 &cellEnc);				
 				 cellEnc.setCellID(trkPulse);
 
-				 trkPulse->setTime(iterChMap->second->getTime()/ns);
-				 trkPulse->setCharge(iterChMap->second->getCharge()/fC);
+				 trkPulse->setTime(_strips.getTime(iStrip)/ns);
+				 trkPulse->setCharge(_strips.getCharge(iStrip)/fC);
 				 trkPulse->setTrackerData(0);
 				 
 				 // Create relation from Tracker pulse to SimTrackerHit
 				 if(!_relColNamePlsToSim.empty()) 
 				 {
-				      const SimTrackerHitMap & simHitMap = iterChMap->second->getSimHitMap();
-				      float weightSum = iterChMap->second->getSimHitWeightSum();
+				      float weightSum = _strips.getSimHitWeightSum(iStrip);
 				      
-				      for(SimTrackerHitMap::const_iterator iterSHM=simHitMap.begin();
-						      iterSHM!=simHitMap.end(); ++iterSHM) 
+				      for(int k=_strips.getSimHitBegin(iStrip);
+						      k!=_strips.getSimHitEnd(iStrip); ++k) 
 				      {
 					  // Create LC relation
 					      LCRelationImpl * relation = new LCRelationImpl;
-					      SimTrackerHit  * simHit   = iterSHM->first;
+					      SimTrackerHit  * simHit   = _strips.getSimHit(k);
 					      float            weight   = 0.;
 					      
 					      // Set from TrkPulse to MCParticle
@@ -673,7 +707,7 @@ void SiStripDigi::processEvent(LCEvent * event)
 					      // Set weight
 					      if(weightSum != 0.) 
 					      {
-						   weight = float(iterSHM->second)/weightSum;
+						   weight = float(_strips.getSimHitWeight(k))/weightSum;
 					      }
 					      else
 					      {
@@ -695,20 +729,14 @@ void SiStripDigi::processEvent(LCEvent * event)
 				 // Save the pulse to the collection
 				 colOfTrkPulses->addElement(trkPulse);
 			     }
-//FIXME: que pinta esto aqui			     
-/*			     short int layerID  = 0;
-			     short int ladderID = 0;
-			     short int sensorID = 0;
-			     _geometry->decodeCellID(layerID, ladderID, sensorID, cellID);*/
-			     
-			     // Release memory
-			     delete iterChMap->second;
 			 }
 		     
 		     } // For for strips type
-		     // Release memory
-		     delete [] iterSMap->second;
 		} // For */
+		
+		// Release strips
+		_strips.clear();
+		
 		//
 		// Save the collection (vector) of pulses + relations to MC
 		event->addCollection(colOfTrkPulses, _outColName);
@@ -749,6 +777,24 @@ void SiStripDigi::end()
 	delete _geometry;
 	_geometry = 0;
 
+	// Check of the noise hit sampling: number of noise hits from the binomial
+	// and mean amplitude from the tail sampler against the Gaussian tail
+	if (_noiseHitsEngine && _nNoiseHitsAmpl > 0)
+	{
+		const double t = _noiseHitsThreshold;
+		const double meanAmplExpected = exp(-t*t/2.)/sqrt(2.*M_PI)/(0.5*erfc(t/sqrt(2.)));
+
+		streamlog_out(MESSAGE3) << std::endl
+		                        << std::setprecision(3)
+		                        << " Noise hits per event:            " << _nNoiseHits/_nEvent
+		                        << " (expected " << _nNoiseHitsExpected/_nEvent << ")" << std::endl
+		                        << " Mean noise hit amplitude [noise]: " << _noiseHitsAmplSum/_nNoiseHitsAmpl
+		                        << " (expected " << meanAmplExpected << ")" << std::endl;
+	}
+
+	delete _noiseHitsEngine;
+	_noiseHitsEngine = 0;
+
 	// CPU time end
 	_timeCPU = clock()*us - _timeCPU;
 
@@ -792,7 +838,7 @@ void SiStripDigi::end()
 // SimTrackerDigiHit, output parameter: sensor map of strips with total
 // integrated charge and time when particle crossed the sensor)
 //
-void SiStripDigi::digitize(const SimTrackerDigiHit * simDigiHit, SensorStripMap & sensorMap)
+void SiStripDigi::digitize(const SimTrackerDigiHit * simDigiHit, StripBuffer & strips)
 {
 	//
 	// Calculate electron, resp. hole, clusters from obtained hits & provide Landau fluctuations
@@ -895,14 +941,6 @@ void SiStripDigi::digitize(const SimTrackerDigiHit * simDigiHit, SensorStripMap
 		double primAtA    = 0.5*( 1. + erf( ((yorigenRot+iMinStrip*sensorPitch) - meanRot)/sigmaSqrt2) );
 		double primAtB    = 0.;
 		
-		//  Sensor map of strips with total integrated charge and time when particle 
-		//  crossed the detector
-		SensorStripMap::iterator iterSMap;
-		StripChargeMap::iterator iterChMap;
-		
-		//  Strip signal
-		Signal * signal = 0;
-		
 		//  Calculate signal at each strip and save
 		for(int i=iMinStrip; i<=iMaxStrip; ++i) 
 		{
@@ -918,64 +956,13 @@ void SiStripDigi::digitize(const SimTrackerDigiHit * simDigiHit, SensorStripMap
 			// New integration starting point
 			primAtA = primAtB;
 			
-			// Find sensor with given ID
-			iterSMap = sensorMap.find(cluster->getCellID());
-
-			// Sensor has already collected some charge
-			if(iterSMap != sensorMap.end()) 
-			{
-				// Find strip i in Z
-				iterChMap = iterSMap->second[stripType].find(i);
-				
-				// Strip i in Z has already collected some charge
-				if(iterChMap != iterSMap->second[stripType].end()) 
-				{
-					// Get signal at strip i
-					signal = iterChMap->second;
-					
-					// Update signal information (add current charge to 
-					// the total)
-					signal->updateCharge(charge);
-					
-					// Update MC truth information
-					signal->updateSimHitMap(cluster->getSimTrackerHit(), 
-							charge);
-					
-				}
-				// Strip i in Z hasn't collected any charge yet
-				else 
-				{
-					// Create signal, i.e. total charge + time when 
-					// particle crossed the detector, all corresponding 
-					// to strip i
-					signal = new Signal(charge, cluster->getTime());
-					
-					// Save MC truth information
-					signal->updateSimHitMap(cluster->getSimTrackerHit(), 
-							charge);
-					
-					// Save information about strip i in Z
-					iterSMap->second[stripType][i] = signal;
-					
-				}
-			}
-			// Sensor has not collected any charge yet
-			else 
-			{
-				// Create map of strips with total collected charge
-				StripChargeMap * stripMap = new StripChargeMap[2];
-				
-				// Create signal, i.e. total charge + time when particle crossed the
-				//detector, all corresponding to strip i
-				signal = new Signal(charge, cluster->getTime());
-				
-				// Save MC truth information
-				signal->updateSimHitMap(cluster->getSimTrackerHit(), charge);
-				
-				// Save information about strip i in Z
-				stripMap[stripType][i] = signal;
-				sensorMap[cluster->getCellID()] = stripMap;
-			}
+			// Save charge + time when particle crossed the detector at 
+			// strip i, all deposits at strip i are summed up by compact()
+			strips.addDeposit(cluster->getCellID(), StripType(stripType), i,
+					charge, cluster->getTime());
+			
+			// Save MC truth information
+			strips.addDepositSimHit(cluster->getSimTrackerHit(), charge);
 		} // Calculate signal at each strip		
 		// Release memory
 		delete cluster;
@@ -1095,9 +1082,10 @@ void SiStripDigi::calcClusters(const SimTrackerDigiHit * hit, DigiClusterVec & h
 
 //
 // Method that calculates crosstalk effect, i.e. total charge redistribution
-// (input parameter: sensor map of strips with total integrated charge)
+// (input parameter: strips with total integrated charge, output parameter:
+// strips with redistributed charge)
 //
-void SiStripDigi::calcCrossTalk(SensorStripMap & sensorMap)
+void SiStripDigi::calcCrossTalk(const StripBuffer & strips, StripBuffer & stripsCrossTalk)
 {
 	// Calculate how much charge is collected by adjacent strips
 	// If read-out pitch = geom. pitch
@@ -1105,55 +1093,45 @@ void SiStripDigi::calcCrossTalk(SensorStripMap & sensorMap)
 	// If read-out pitch = 2x geom. pitch
 	static float capFloatRatio = _capInterStrip/2./(_capInterStrip/2. + _capBackPlane + _capCoupl);
 	
-	// Iterators
-	SensorStripMap::iterator iterSMap;
-	StripChargeMap::iterator iterChMap;
-
 	short int layerID    = 0;
 	short int ladderID   = 0;
 	short int sensorID   = 0;
 
-	Signal * signal      = 0 ;
-
 	// Strips types
 	std::vector<StripType> stvec;
 	stvec.push_back(STRIPFRONT);
 	stvec.push_back(STRIPREAR);
 	
+	stripsCrossTalk.clear();
+	
         // Go through all sensors
-	for(iterSMap=sensorMap.begin(); iterSMap!=sensorMap.end(); ++iterSMap) 
+	for(int iSensor=0; iSensor<strips.getNSensors(); ++iSensor) 
 	{
+	   const int cellID = strips.getCellID(iSensor);
+	   
 	   // Find corresponding layerID
-           std::map<std::string,int> bfMap = _geometry->decodeCellID(iterSMap->first);
+           std::map<std::string,int> bfMap = _geometry->decodeCellID(cellID);
 	   layerID = bfMap["layer"];
 	   ladderID= bfMap["module"];
 	   sensorID= bfMap["sensor"];
-	   //_geometry->decodeCellID(layerID, ladderID, sensorID, iterSMap->first);
+	   //_geometry->decodeCellID(layerID, ladderID, sensorID, cellID);
 	   
-	   // Define strip map with recalculated signals
-	   StripChargeMap * stripMap = new StripChargeMap[2];
+	   const int nStrips = _geometry->getSensorNStrips(layerID,sensorID);
 	   
 	   // For all the strips types
 	   for(std::vector<StripType>::iterator itT = stvec.begin(); itT != stvec.end(); ++itT)
 	   {
 		const StripType STRIP = *itT;
-		// Read map of strips in R-Phi and save new results to recalculated strip map
-		for(iterChMap=(iterSMap->second[STRIP]).begin(); 
-				iterChMap!=(iterSMap->second[STRIP]).end(); ++iterChMap) 
+		// Read strips and save new results as deposits of recalculated strips
+		for(int i=strips.getBegin(iSensor, STRIP); i!=strips.getEnd(iSensor, STRIP); ++i) 
 		{
-			const int iStrip = iterChMap->first;
+			const int iStrip = strips.getStripID(i);
 			int iStripLeft   = iStrip - 1;
 			int iStripRight  = iStrip + 1;
 			double Kf = 0.;
 			
 			// Calculate charge redistribution
-			signal = iterChMap->second;
-			
-			const double chargeTotal = signal->getCharge();
-
-			SimTrackerHitMap simHitMapLeft;
-			SimTrackerHitMap simHitMapCentr;
-			SimTrackerHitMap simHitMapRight;
+			const double chargeTotal = strips.getCharge(i);
 
 			// Floating strip - capRatio = 0.5
 			if((_floatStripsRPhi) && (iStrip%2==1)) 
@@ -1179,80 +1157,40 @@ void SiStripDigi::calcCrossTalk(SensorStripMap & sensorMap)
 			const double chargeRight = chargeTotal*Kf;
 			const double chargeCentr   = chargeTotal - chargeLeft - chargeRight;
 			
-			// Reasigning weights to hits
-			for(SimTrackerHitMap::const_iterator iterSHM=signal->getSimHitMap().begin(); 
-					   iterSHM!=signal->getSimHitMap().end(); ++iterSHM) 
-			{
-			      simHitMapLeft[iterSHM->first]  = iterSHM->second * Kf;
-			      simHitMapCentr[iterSHM->first] = iterSHM->second * chargeCentr/chargeTotal;
-			      simHitMapRight[iterSHM->first] = iterSHM->second * Kf;
-			}
-			
 			// Time
-			const double time            = signal->getTime();
+			const double time            = strips.getTime(i);
 			// Left neighbour (crosstalk cannot go to non-existing strips, i.e. stripID >=0 && stripID < NSTRIPS
 			if( (iStripLeft)>=0 ) 
 			{
-				if(stripMap[STRIP].find(iStripLeft) != stripMap[STRIP].end()) 
-				{
-				    stripMap[STRIP][iStripLeft]->updateCharge(chargeLeft);
-				    stripMap[STRIP][iStripLeft]->updateSimHitMap(simHitMapLeft);
-				}
-				else 
-				{
-				    stripMap[STRIP][iStripLeft] = new Signal(chargeLeft, time);
-				    stripMap[STRIP][iStripLeft]->updateSimHitMap(simHitMapLeft);
-				}
+				stripsCrossTalk.addDeposit(cellID, STRIP, iStripLeft, chargeLeft, time);
+				stripsCrossTalk.addDepositSimHits(strips, i, Kf);
 			}
-			// Central strip
+			// Central strip (reasigning weights to hits)
 			if (chargeCentr!=0) 
 			{
-				if(stripMap[STRIP].find(iStrip) != stripMap[STRIP].end()) 
-				{
-			            stripMap[STRIP][iStrip]->updateCharge(chargeCentr);
-				    stripMap[STRIP][iStrip]->updateSimHitMap(simHitMapCentr);
-				}
-				else 
-				{
-				    stripMap[STRIP][iStrip] = new Signal(chargeCentr, time);
-				    stripMap[STRIP][iStrip]->updateSimHitMap(simHitMapCentr);
-				}
+				stripsCrossTalk.addDeposit(cellID, STRIP, iStrip, chargeCentr, time);
+				stripsCrossTalk.addDepositSimHits(strips, i, chargeCentr/chargeTotal);
 			}
 
 			// Right neighbour (crosstalk cannot go to non-existing strips, i.e. stripID >=0 && stripID < NSTRIPS
-			if( (iStripRight)<_geometry->getSensorNStrips(layerID,sensorID) ) 
+			if( (iStripRight)<nStrips ) 
 			{
-				if (stripMap[STRIP].find(iStripRight) != stripMap[STRIP].end()) 
-				{
-				    stripMap[STRIP][iStripRight]->updateCharge(chargeRight);
-				    stripMap[STRIP][iStripRight]->updateSimHitMap(simHitMapRight);
-				}
-				else 
-				{
-				    stripMap[STRIP][iStripRight] = new Signal(chargeRight, time);
-				    stripMap[STRIP][iStripRight]->updateSimHitMap(simHitMapRight);
-				}
+				stripsCrossTalk.addDeposit(cellID, STRIP, iStripRight, chargeRight, time);
+				stripsCrossTalk.addDepositSimHits(strips, i, Kf);
 			}
-
-			// Release memory
-			delete iterChMap->second;
 		}
 	   }
-	   
-	   // Delete previous strip map
-	   delete [] iterSMap->second;
-	   
-	   // Save new results
-	   iterSMap->second = stripMap;
 	} // For
 	
+	// Sum up redistributed charges
+	stripsCrossTalk.compact();
 }
 
 //
 // Method generating random noise using Gaussian distribution (input parameter:
-// sensor map of strips with total integrated charge)
+// strips with total integrated charge)
 //
-void SiStripDigi::genNoise(SensorStripMap & sensorMap)
+void SiStripDigi::genNoise(StripBuffer & strips)
 {
 	// Add noise, only if set nonzero!
 	if (_elNoise < 1e-4)
@@ -1260,29 +1198,119 @@ void SiStripDigi::genNoise(SensorStripMap & sensorMap)
 		return;
 	}
 	
-	// Strips type
-	std::vector<StripType> stvec;
-	stvec.push_back(STRIPFRONT);
-	stvec.push_back(STRIPREAR);
+	// Strips are ordered by sensor, strip type and strip ID
+	for(int i=0; i<strips.getNStrips(); ++i) 
+	{
+	    const double elNoise = _genGauss->fire();
+	    
+	    strips.updateCharge(i, elNoise);
+	}
+}
+
+
+//
+// Method generating noise hits in strips without signal (input parameter:
+// strips with total integrated charge)
+//
+void SiStripDigi::genNoiseHits(StripBuffer & strips)
+{
+	// Add noise, only if set nonzero!
+	if (_elNoise < 1e-4)
+	{
+		return;
+	}
+	
+	// Probability that noise of a strip exceeds the threshold
+	const double probNoiseHit = 0.5*erfc(_noiseHitsThreshold/sqrt(2.));
 	
-	for(SensorStripMap::iterator iterSMap=sensorMap.begin(); 
-			      iterSMap!=sensorMap.end(); ++iterSMap) 
+	for(short int layerID=0; layerID<_geometry->getNLayerIDs(); ++layerID)
 	{
-	    for(std::vector<StripType>::iterator itType = stvec.begin(); 
-			    itType != stvec.end(); ++itType)
-	    {
-		for(StripChargeMap::iterator iterChMap=iterSMap->second[(*itType)].begin(); 
-				iterChMap!=iterSMap->second[(*itType)].end(); 
-				++iterChMap) 
+		//FIXME: The pixel disks digitization must be done
+		//       by some other package...
+		if( abs(_geometry->getLayerRealID(layerID)) < 3 )
+		{
+			continue;
+		}
+		
+		for(short int ladderID=0; ladderID<_geometry->getNLadders(layerID); ++ladderID)
 		{
-		    const double elNoise = _genGauss->fire();
-		    
-		    iterChMap->second->updateCharge(elNoise);
+			// Sensors 1,2 - front, sensors 3,4 - rear (see digitize)
+			for(short int sensorID=1; sensorID<=4; ++sensorID)
+			{
+				const StripType stripType = (sensorID<3) ? STRIPFRONT : STRIPREAR;
+				const int cellID  = _geometry->encodeCellID(layerID, ladderID, sensorID);
+				const int nStrips = _geometry->getSensorNStrips(layerID, sensorID);
+				
+				// Number of strips above threshold
+				const int nNoiseHits = int(RandBinomial::shoot(_noiseHitsEngine, 
+							nStrips, probNoiseHit));
+				_nNoiseHitsExpected += nStrips*probNoiseHit;
+				_nNoiseHits         += nNoiseHits;
+				
+				// Place them at random (different) strips
+				_noiseHitStrips.clear();
+				while(int(_noiseHitStrips.size()) < nNoiseHits)
+				{
+					const int stripID = RandFlat::shootInt(_noiseHitsEngine, nStrips);
+					
+					std::vector<int>::iterator it = std::lower_bound(
+							_noiseHitStrips.begin(), _noiseHitStrips.end(), stripID);
+					if(it != _noiseHitStrips.end() && *it == stripID)
+					{
+						continue;
+					}
+					_noiseHitStrips.insert(it, stripID);
+					
+					// Strips with signal have got their noise already
+					if(strips.findStrip(cellID, stripType, stripID) >= 0)
+					{
+						continue;
+					}
+					
+					const double ampl = genGaussTail(_noiseHitsThreshold);
+					_noiseHitsAmplSum += ampl;
+					_nNoiseHitsAmpl++;
+
+					strips.addDeposit(cellID, stripType, stripID, ampl*_elNoise, 0.);
+				}
+			}
 		}
-	    }
 	}
+	
+	// Merge noise hits with strips
+	strips.compact();
 }
 
+//
+// Method sampling Gaussian tail above given threshold - exponential proposal
+// with rejection (C.P. Robert, Statistics and Computing 5 (1995) 121)
+//
+double SiStripDigi::genGaussTail(double threshold)
+{
+	// Low threshold - plain rejection
+	if(threshold <= 0.)
+	{
+		double x = 0.;
+		do
+		{
+			x = RandGauss::shoot(_noiseHitsEngine);
+		}
+		while(x < threshold);
+		
+		return x;
+	}
+	
+	const double lambda = (threshold + sqrt(threshold*threshold + 4.))/2.;
+	while(true)
+	{
+		const double x = threshold + RandExponential::shoot(_noiseHitsEngine, 1./lambda);
+		
+		if(RandFlat::shoot(_noiseHitsEngine) <= exp(-(x - lambda)*(x - lambda)/2.))
+		{
+			return x;
+		}
+	}
+}
 
 //
 // Method transforming given SimTrackerHit into local ref. system of each sensor, where
@@ -1357,6 +1385,49 @@ void SiStripDigi::transformSimHit(SimTrackerDigiHit * simDigiHit)
 }
 
 
+//
+// Method tabulating drift time and Lorentz shift integrals for each layer
+//
+void SiStripDigi::buildTransportTables()
+{
+	_elecDriftTable.clear();
+	_holeDriftTable.clear();
+	_elecLorentzTable.clear();
+	_holeLorentzTable.clear();
+
+	for (short int iLayer=0; iLayer<_geometry->getNLayerIDs(); ++iLayer)
+	{
+		_elecDriftTable.push_back(IntegralTable<SiStripDigi>(&SiStripDigi::getElecInvVelocity, this));
+		_holeDriftTable.push_back(IntegralTable<SiStripDigi>(&SiStripDigi::getHoleInvVelocity, this));
+		_elecLorentzTable.push_back(IntegralTable<SiStripDigi>(&SiStripDigi::getElecMobility, this));
+		_holeLorentzTable.push_back(IntegralTable<SiStripDigi>(&SiStripDigi::getHoleMobility, this));
+
+		// Integrands depend on the sensor thickness via electric field
+		_sensorThick = _geometry->getSensorThick(iLayer);
+		if (_sensorThick <= 0.)
+		{
+			continue;
+		}
+
+		float epsElecDrift   = _elecDriftTable.back().Build(0., _sensorThick, _epsTime);
+		float epsHoleDrift   = _holeDriftTable.back().Build(0., _sensorThick, _epsTime);
+		float epsElecLorentz = _elecLorentzTable.back().Build(0., _sensorThick, _epsAngle);
+		float epsHoleLorentz = _holeLorentzTable.back().Build(0., _sensorThick, _epsAngle);
+
+		streamlog_out(DEBUG2) << "SiStripDigi::buildTransportTables - layer " << iLayer
+			<< " thickness[um]: " << _sensorThick/um
+			<< " rel. precision (intervals) - drift time e/h: "
+			<< epsElecDrift << " (" << _elecDriftTable.back().getNIntervals() << ") / "
+			<< epsHoleDrift << " (" << _holeDriftTable.back().getNIntervals() << ")"
+			<< ", Lorentz shift e/h: "
+			<< epsElecLorentz << " (" << _elecLorentzTable.back().getNIntervals() << ") / "
+			<< epsHoleLorentz << " (" << _holeLorentzTable.back().getNIntervals() << ")"
+			<< std::endl;
+	}
+
+	_sensorThick = -1.;
+}
+
 // GET METHODS
 
 //
@@ -1403,6 +1474,10 @@ double SiStripDigi::getElecDriftTime(double pos)
 	{
 		return 0.;
 	}
+	else if (!_rombergIntegration && _elecDriftTable[_currentLayerID].isBuilt())
+	{
+		return (_elecDriftTable[_currentLayerID].Integrate(pos, _sensorThick));
+	}
 	else
 	{
 		return (elecIntSolver.Integrate(pos, _sensorThick));
@@ -1432,6 +1507,10 @@ double SiStripDigi::getHoleDriftTime(double pos)
 	{
 		return 0.;
 	}
+	else if (!_rombergIntegration && _holeDriftTable[_currentLayerID].isBuilt())
+	{
+		return (_holeDriftTable[_currentLayerID].Integrate(pos, 0.));
+	}
 	else 
 	{
 		return (holeIntSolver.Integrate(pos, 0.));
@@ -1521,7 +1600,15 @@ Hep3Vector SiStripDigi::getElecLorentzShift(double pos)
 	
 	if((_sensorThick - pos) >= ROUNDEPS*um) 
 	{
-		double integral = elecIntSolver.Integrate(pos, _sensorThick);
+		double integral = 0.;
+		if (!_rombergIntegration && _elecLorentzTable[_currentLayerID].isBuilt())
+		{
+			integral = _elecLorentzTable[_currentLayerID].Integrate(pos, _sensorThick);
+		}
+		else
+		{
+			integral = elecIntSolver.Integrate(pos, _sensorThick);
+		}
 		
 		shiftLorentz.setY(integral * rElec * _magField.getZ() * -1.); //????
 		shiftLorentz.setZ(integral * rElec * _magField.getY());       //????
@@ -1557,7 +1644,15 @@ Hep3Vector SiStripDigi::getHoleLorentzShift(double pos)
 	Hep3Vector shiftLorentz(0.,0.,0.);
 	if(pos >= ROUNDEPS*um) 
 	{
-		double integral = holeIntSolver.Integrate(0., pos);
+		double integral = 0.;
+		if (!_rombergIntegration && _holeLorentzTable[_currentLayerID].isBuilt())
+		{
+			integral = _holeLorentzTable[_currentLayerID].Integrate(0., pos);
+		}
+		else
+		{
+			integral = holeIntSolver.Integrate(0., pos);
+		}
 		
 		shiftLorentz.setY(integral * rHole * _magField.getZ());        //????
 		shiftLorentz.setZ(integral * rHole * _magField.getY() * -1.);  //????
@@ -1680,6 +1775,8 @@ void SiStripDigi::printProcessorParams() const
                            << "  Strip-to-backplane capacitance [pF]:   " << std::setw(6) << _capBackPlane << std::endl
                            << "  AC coupling - capacitance [pF]:        " << std::setw(6) << _capCoupl     << std::endl
                            << "  Electronics noise - ENC [fC]:          " << std::setw(6) << _elNoise/fC   << std::endl << std::endl;
+   if (_electronicEffects && _noiseHits)
+   streamlog_out(MESSAGE3) << "  Noise hits threshold [noise]:          " << std::setw(6) << _noiseHitsThreshold << std::endl << std::endl;
    if (_floatStripsRPhi)
    streamlog_out(MESSAGE3) << "  Read-out R-Phi pitch is 2x geom. pitch." << std::endl;
    if (_floatStripsZ)
@@ -1698,6 +1795,7 @@ void SiStripDigi::printProcessorParams() const
                            << "  Digi precision in space [um]:          " << std::setw(6) << _epsSpace/um  << std::endl
                            << "  Digi rel. precision in Lorentz angle:  " << std::setw(6) << _epsAngle     << std::endl
                            << "  Digi rel. precision in Drift time:     " << std::setw(6) << _epsTime      << std::endl
+                           << "  Romberg integration for each cluster:  " << std::setw(6) << _rombergIntegration << std::endl
                            << std::resetiosflags(std::ios::showpos)
 	                   		<< std::setprecision(0)
                            << std::endl;
@@ -1706,12 +1804,8 @@ void SiStripDigi::printProcessorParams() const
 //
 // Method printing info about signals at each strip
 //
-void SiStripDigi::printStripsInfo( std::string info, const SensorStripMap & sensorMap) const
+void SiStripDigi::printStripsInfo( std::string info, const StripBuffer & strips) const
 {
-	// Sensor map of strips with total integrated charge
-		SensorStripMap::const_iterator iterSMap;
-		StripChargeMap::const_iterator iterChMap;
-
 		int       cellID   = 0;
 
 		short int layerID  = 0;
@@ -1723,9 +1817,9 @@ void SiStripDigi::printStripsInfo( std::string info, const SensorStripMap & sens
 		streamlog_out(MESSAGE1) << "  Digi results - " << info
 		                        << ":"                 << std::endl;
 
-		for (iterSMap=sensorMap.begin(); iterSMap!=sensorMap.end(); ++iterSMap) {
+		for (int iSensor=0; iSensor<strips.getNSensors(); ++iSensor) {
 
-			cellID  = iterSMap->first;
+			cellID  = strips.getCellID(iSensor);
 			std::map<std::string,int> bfMap = _geometry->decodeCellID(cellID);
 			layerID = bfMap["layer"];
 			ladderID= bfMap["module"];
@@ -1740,27 +1834,27 @@ void SiStripDigi::printStripsInfo( std::string info, const SensorStripMap & sens
 			                        << std::endl;
 
 			// Strips in R-Phi
-			for (iterChMap=iterSMap->second[STRIPRPHI].begin(); iterChMap!=iterSMap->second[STRIPRPHI].end(); ++iterChMap) {
+			for (int i=strips.getBegin(iSensor, STRIPRPHI); i!=strips.getEnd(iSensor, STRIPRPHI); ++i) {
 
-				stripID = iterChMap->first;
+				stripID = strips.getStripID(i);
 			   streamlog_out(MESSAGE1) << "    Strip number in R-Phi: "    << stripID
 			                           << std::setiosflags(std::ios::fixed | std::ios::internal )
                                     << std::setprecision(2)
-			                           << " Total charge [fC]: "  << iterChMap->second->getCharge() / fC
-			                           //<< " Generation time [ns]: " << iterChMap->second->getTime()/ns
+			                           << " Total charge [fC]: "  << strips.getCharge(i) / fC
+			                           //<< " Generation time [ns]: " << strips.getTime(i)/ns
 			                           << std::setprecision(0)
 			                           << std::endl;
 			}
 
 			// Strips in Z
-         for (iterChMap=iterSMap->second[STRIPZ].begin(); iterChMap!=iterSMap->second[STRIPZ].end(); ++iterChMap) {
+         for (int i=strips.getBegin(iSensor, STRIPZ); i!=strips.getEnd(iSensor, STRIPZ); ++i) {
 
-            stripID = iterChMap->first;
+            stripID = strips.getStripID(i);
             streamlog_out(MESSAGE1) << "    Strip number in Z: "    << stripID
                                     << std::setiosflags(std::ios::fixed | std::ios::internal )
                                     << std::setprecision(2)
-                                    << " Total charge [fC]: "  << iterChMap->second->getCharge() / fC
-                                    //<< " Generation time [ns]: " << iterChMap->second->getTime()/ns
+                                    << " Total charge [fC]: "  << strips.getCharge(i) / fC
+                                    //<< " Generation time [ns]: " << strips.getTime(i)/ns
                                     << std::setprecision(0)
                                     << std::endl;
          }
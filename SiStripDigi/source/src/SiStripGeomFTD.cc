@@ -189,6 +189,107 @@ void SiStripGeomFTD::initGearParams()
 			_sensorNStripsInFront.end());
 	_sensorNStripsInRear.insert(_sensorNStripsInRear.end(),_sensorNStripsInRear.begin(),
 		_sensorNStripsInRear.end());
+
+	buildGeometryTables();
+}
+
+//
+// Method filling the geometry tables: the frame of every sensor (local origin
+// and rotations) and the per-disk constants used by the strip methods, so that
+// the transformations don't need to query gear for every point. The gear layout
+// only describes the positive-z disks, the negative-z frames are their mirror
+// images.
+//
+void SiStripGeomFTD::buildGeometryTables()
+{
+	const int nLayerIDs = getNLayerIDs();
+
+	_sensorFrames.clear();
+	_diskFrameBegin.assign(nLayerIDs+1,0);
+	_layerTanHalfPhi.resize(nLayerIDs);
+	_rotCentreShift.resize(2*nLayerIDs);
+
+	for(int diskID = 0; diskID < nLayerIDs; ++diskID)
+	{
+		const int gearDiskID = diskID % _numberOfLayers;
+		const int zsign = abs(getLayerRealID(diskID))/getLayerRealID(diskID);
+		const double sensorthickness = _sensorThick[diskID];
+		const double rinner = _layerRadius[diskID];
+
+		for(int petalID = 0; petalID < _numberOfLadders[diskID]; ++petalID)
+		{
+			const double phi0 = _ftdLayer->getPhiPetalCd(gearDiskID,petalID);
+			const double phi  = getLadderPhi(diskID,petalID);
+			const double theta= getLadderTheta(diskID); // ALWAYS M_PI/2.0
+
+			for(int sensorID = 1; sensorID <= 4; ++sensorID)
+			{
+				SensorFrame frame;
+
+				// Z of the sensor: sensor 3 and 4 displaced to the trapezoid 
+				// farest the IP, sensor 1 and 2 to the trapezoid facing the IP
+				const double zsensorCd = zsign*fabs(_ftdLayer->getSensitiveZposition(
+							gearDiskID,petalID,sensorID)*mm);
+				double zsensor = zsensorCd+zsign*sensorthickness/2.0;
+				if( sensorID < 3 )
+				{
+					zsensor = zsensorCd-zsign*sensorthickness/2.0;
+				}
+
+				// Global -> local: origin over the smallest side of the trapezoid
+				frame.originX = rinner*fabs(cos(phi0));
+				frame.originY = rinner*fabs(sin(phi0));
+				frame.originZ = zsensor;
+
+				// Rotation: sensors 1,2 z-positive and 3,4 z-negative share
+				// the same transformation, as well as 3,4 z-positive and 1,2
+				// z-negative
+				double rotZangle = -phi0;
+				double rotYangle = -M_PI/2.0;
+				if( (sensorID < 3 && zsign > 0) || 
+						(sensorID > 2 && zsign < 0) )
+				{
+					rotZangle = M_PI-phi0;
+					rotYangle = M_PI/2.0;
+				}
+				frame.rotToLocal = CLHEP::HepRotation();
+				frame.rotToLocal.rotateZ(rotZangle);
+				frame.rotToLocal.rotateY(rotYangle);
+
+				// Local -> global
+				frame.originGlobal = CLHEP::Hep3Vector(rinner*cos(phi),
+						rinner*sin(phi),zsensor);
+
+				rotZangle = -phi;
+				rotYangle = -theta;
+				if( (sensorID < 3 && zsign > 0) || 
+						(sensorID > 2 && zsign < 0) )
+				{
+					rotZangle = M_PI-phi;
+					rotYangle = theta;
+				}
+				frame.rotToGlobal = CLHEP::HepRotation();
+				frame.rotToGlobal.rotateY(-rotYangle);
+				frame.rotToGlobal.rotateZ(-rotZangle);
+
+				_sensorFrames.push_back(frame);
+			}
+		}
+		_diskFrameBegin[diskID+1] = _sensorFrames.size();
+
+		_layerTanHalfPhi[diskID] = tan(_layerHalfPhi[diskID]);
+
+		// Rotation of the petal around its centre by the stereo angle
+		for(int side = 0; side < 2; ++side)
+		{
+			const CLHEP::Hep3Vector centre(0.0,getSensorWidthMax(diskID)/2.0,
+					getSensorLength(diskID)/2.0);
+			CLHEP::Hep3Vector rotcentre(centre);
+			rotcentre.rotateX(-getStereoAngle(diskID,1+2*side));
+
+			_rotCentreShift[2*diskID+side] = rotcentre-centre;
+		}
+	}
 }
 
 
@@ -225,6 +326,24 @@ int SiStripGeomFTD::cellID0withSensor0(const int & cellID0) const
 	return cellDec.lowWord();
 }
 
+//
+// Encode cellID0 of given disk, petal and sensor (C-type numbering)
+int SiStripGeomFTD::encodeCellID(const int & diskID, const int & petalID, 
+		const int & sensorID) const
+{
+	UTIL::BitField64 cellEnc(LCTrackerCellID::encoding_string());
+
+	const int realLayer = getLayerRealID(diskID);
+
+	cellEnc["subdet"] = ILDDetID::FTD;
+	cellEnc["side"]   = abs(realLayer)/realLayer;
+	cellEnc["layer"]  = abs(realLayer);
+	cellEnc["module"] = petalID+1;  // Note that we want to keep the geant4 style
+	cellEnc["sensor"] = sensorID;
+
+	return cellEnc.lowWord();
+}
+
 //
 // Decode Strip type and Strip ID (CellID1) (int version)
 std::pair<StripType,int> SiStripGeomFTD::decodeStripID(const int & cellID1) const
@@ -360,85 +479,53 @@ double SiStripGeomFTD::getLadderOffsetX(const short int & layerID) const
 //
 CLHEP::Hep3Vector SiStripGeomFTD::transformPointToLocal(short int diskID, short int petalID, short int sensorID, const CLHEP::Hep3Vector & globalPoint)
 {
-	// Initialize local point
-	CLHEP::Hep3Vector localPoint(globalPoint);
-
-	// Phi Angle of the Petal (on the centroid of the petal with respect the x-axis)
-	const double phi0 = _ftdLayer->getPhiPetalCd(diskID,petalID);
-	
-	// 
-	// RECALL: ftd gear have the convention mm (distance), here we have cm
-	// 
-
-	// Extract the Z of the sensor: diferent position depending the sensor
-	const double zsensorCd = _ftdLayer->getSensitiveZposition(diskID,petalID,sensorID)*mm;
-	const int zsign = (int)(zsensorCd/fabs(zsensorCd));
-	const double sensorthickness = _ftdLayer->getSensitiveThickness(diskID)*mm;
-	// Sensor 3 and 4: Displacing to the trapezoid farest the IP
-	double zsensor = zsensorCd+zsign*sensorthickness/2.0;
-	// Sensor 1 and 2: Displacing to the trapezoid facing the IP
-	if( sensorID < 3 )
-	{
-		zsensor = zsensorCd-zsign*sensorthickness/2.0;
-	}
-	
-	// And the X and Y CentroiD position: over the smallest side of the trapezoid
-	const int xsign = (int)(fabs(globalPoint.getX())/globalPoint.getX());
-	const double xsensorCd = xsign*(_ftdLayer->getSensitiveRinner(diskID)*mm)*
-		fabs(cos(phi0));
-
-	const int ysign = (int)(fabs(globalPoint.getY())/globalPoint.getY());
-	const double ysensorCd = ysign*(_ftdLayer->getSensitiveRinner(diskID)*mm)*
-		fabs(sin(phi0));
-
-	// The (0,0,0) position of LFR
-	CLHEP::Hep3Vector localOrigin(xsensorCd, ysensorCd, zsensor);
-
-	// Translating the globalPoint to the local Origin
-	localPoint -= localOrigin;
-	
-	// Perform rotation to get the system local: 
-	//  Z-positives sensors 1,2 |
-	//  Z-negatives sensors 3,4 |-- Same transformation
-	//
-	//  Z-positives sensors 3,4 | ---> La antigua
-	//  Z-negatives sensors 1,2 |-- Same transformation
-	double rotZangle = -phi0;
-	double rotYangle = -M_PI/2.0;
-	if( (sensorID < 3 && zsign > 0) || 
-			(sensorID > 2 && zsign < 0) )
-	{
-		rotZangle = M_PI-phi0;
-		rotYangle = M_PI/2.0;
-	}
-	localPoint.rotateZ(rotZangle);
-	localPoint.rotateY(rotYangle);
+	const SensorFrame & frame = getSensorFrame(diskID,petalID,sensorID);
 
-	// Avoiding X,Y and Z negative values--> displacing from the
-        // centroid to the edge
-        const double longtrapezoidedge = _ftdLayer->getSensitiveLengthMax(diskID)*mm;
-	localPoint += CLHEP::Hep3Vector(0.0,longtrapezoidedge/2.,0.0); 
+	CLHEP::Hep3Vector localPoint = pointToLocal(frame,diskID,globalPoint);
 	
 	streamlog_out(DEBUG4) << 
 		"============================================\n" 
 		<< "SiStripGeomFTD::transformPointToLocal \n" 
 		<< " Sensor ID (C-vector style): \n "
 		<< "   DISK: "<<diskID<<" PETAL: "<<petalID<<" SENSOR: " << sensorID << "\n"
-		<< "   Petal Phi: " << phi0*180.0/M_PI << "\n"
+		<< "   Petal Phi: " << _ftdLayer->getPhiPetalCd(diskID % _numberOfLayers,petalID)*180.0/M_PI << "\n"
 		<< std::setprecision(3) 
-		<< " Origen of Local frame [mm]: (" << xsensorCd/mm <<","
-			<< ysensorCd/mm << "," << zsensor/mm << ")\n"
+		<< " Origen of Local frame [mm]: (" << frame.originX/mm <<","
+			<< frame.originY/mm << "," << frame.originZ/mm << ")\n"
 		<< " Hit (Global ref. frame) [mm]:" << globalPoint/mm << "\n"
 		<< " Hit (Local ref. frame)  [mm]:" << localPoint/mm << "\n" 
-		<< " Maximum dimensions: x < " << sensorthickness/mm 
-			<<  ", y < " << longtrapezoidedge/mm << ", z < " 
-			<<  _ftdLayer->getSensitiveWidth(diskID)*mm/mm << " [mm]\n"
+		<< " Maximum dimensions: x < " << _sensorThick[diskID]/mm 
+			<<  ", y < " << _sensorWidth[diskID]/mm << ", z < " 
+			<<  _sensorLength[diskID]/mm << " [mm]\n"
 		<< "============================================" << std::endl;
 	
 	// Return space point in local ref. system
 	return localPoint;
 }
 
+//
+// Transforming given point from global ref. system to the local ref. system
+// of the given sensor frame
+//
+CLHEP::Hep3Vector SiStripGeomFTD::pointToLocal(const SensorFrame & frame, const int & diskID,
+		const CLHEP::Hep3Vector & globalPoint) const
+{
+	// The X and Y CentroiD position: over the smallest side of the trapezoid
+	// (taken in the quadrant of the point)
+	const double xsensorCd = (globalPoint.getX() < 0.) ? -frame.originX : frame.originX;
+	const double ysensorCd = (globalPoint.getY() < 0.) ? -frame.originY : frame.originY;
+
+	// Translating the globalPoint to the local Origin and rotating
+	CLHEP::Hep3Vector localPoint = frame.rotToLocal*(globalPoint - 
+			CLHEP::Hep3Vector(xsensorCd,ysensorCd,frame.originZ));
+
+	// Avoiding X,Y and Z negative values--> displacing from the
+	// centroid to the edge
+	localPoint.setY(localPoint.getY()+_sensorWidth[diskID]/2.);
+
+	return localPoint;
+}
+
 //
 // Method transforming given vector from global ref. system to local ref. system
 // (parameters: layerID, ladderID, sensorID and vector in global ref. system)
@@ -446,28 +533,8 @@ CLHEP::Hep3Vector SiStripGeomFTD::transformPointToLocal(short int diskID, short
 CLHEP::Hep3Vector SiStripGeomFTD::transformVecToLocal(short int diskID, short int petalID,
 		short int sensorID, const CLHEP::Hep3Vector & globalVec)
 {
-	// Initialize local vector
-	CLHEP::Hep3Vector localVec(globalVec);
-
-	const double phi0 = _ftdLayer->getPhiPetalCd(diskID,petalID);
-	// Extract z-sign and 
-	const int realLayerID = getLayerRealID(diskID);
-	const int zsign = abs(realLayerID)/realLayerID;
-	// Sensors 3,4 z-positive and 1,2 z-negative
-	double rotZangle = -phi0;
-	double rotYangle = -M_PI/2.0;
-	// Sensors 1,2 z-positive and 3,4 z-negative
-	if( (sensorID < 3 && zsign > 0) || 
-			(sensorID > 2 && zsign < 0) )
-	{
-		rotZangle = M_PI-phi0;
-		rotYangle = M_PI/2.0;
-	}
-	localVec.rotateZ(rotZangle);
-	localVec.rotateY(rotYangle);
-	
 	// Return vector in local ref. system
-	return localVec;
+	return getSensorFrame(diskID,petalID,sensorID).rotToLocal*globalVec;
 }
 
 //
@@ -534,75 +601,18 @@ CLHEP::HepMatrix SiStripGeomFTD::transformMatxToLocal(short int layerID, short i
 CLHEP::Hep3Vector SiStripGeomFTD::transformPointToGlobal(short int diskID, 
 		short int petalID, short int sensorID, const CLHEP::Hep3Vector & localPoint)
 {
-	// Initialize global point
-	CLHEP::Hep3Vector globalPoint(localPoint);
-
-	// Calculate rotation angles
-	double theta = getLadderTheta(diskID);  // ALWAYS M_PI/2.0
-	double phi   = getLadderPhi(diskID, petalID);
-	
-	// Taking account of the z-side
-	const int realLayerID = getLayerRealID(diskID);
-	const int zsign = abs(realLayerID)/realLayerID;
-	double rotZangle = -phi;
-	double rotYangle = -theta;
-	if( (sensorID < 3 && zsign > 0) || 
-			(sensorID > 2 && zsign < 0) )
-	{
-		rotZangle = M_PI-phi;
-		rotYangle = theta;
-	}
-	
-	// Perform translation - to the center of a petal (in local frame)
-	// Note that the center of the petal we decide defining in the back face
-	// of the sensor
-	const double xlocalCd = 0.0; // Already in the back face_ftdLayer->getSensitiveThickness(diskID)*mm;
-	const double ylocalCd = _ftdLayer->getSensitiveLengthMax(diskID)/2.0*mm;
-	const double zlocalCd = 0.0; // already in the low edge of the petal (see ysensorCd)
-	
-	globalPoint -= CLHEP::Hep3Vector(xlocalCd,ylocalCd,zlocalCd);
+	const SensorFrame & frame = getSensorFrame(diskID,petalID,sensorID);
 
-	// Perform rotation - with respect to the local centre of a ladder
-	globalPoint.rotateY(-rotYangle);
-	globalPoint.rotateZ(-rotZangle);
-	// Now we have the vector in global coordinates from the center of the petal
-	// to the hit 
-	
-	// Find (0,0,0) position of local coordinate system (in global coord.)
-	// Extract the Z of the sensor
-	const double zsensorCd = _ftdLayer->getSensitiveZposition(diskID,petalID,sensorID)*mm;
-	const double sensorthickness = _ftdLayer->getSensitiveThickness(diskID)*mm;
-	// Sensor 3 and 4: Displacing to the trapezoid farest the IP
-	double zsensor = zsensorCd+zsign*sensorthickness/2.0;
-	// Sensor 1 and 2: Displacing to the trapezoid facing the IP
-	if( sensorID < 3 )
-	{
-		zsensor = zsensorCd-zsign*sensorthickness/2.0;
-	}
-	/* OLD
-	// Sensors 3 and 4: Displacing to the backed the IP face
-	double zsensorback = zsensor+zsign*sensorthickness/2.0;
-	if( sensorID < 3 )
-	{
-		zsensorback = zsensor-zsign*sensorthickness/2.0;
-	} END OLD*/
-	// And the X and Y CentroiD position: over the smallest side of the trapezoid
-	const double xsensorCd = _ftdLayer->getSensitiveRinner(diskID)*mm*cos(phi);
-	const double ysensorCd = _ftdLayer->getSensitiveRinner(diskID)*mm*sin(phi);
-	CLHEP::Hep3Vector localOrigin(xsensorCd,ysensorCd,zsensor);
-	
-	// Perform translation - to the global system
-	globalPoint += localOrigin;
+	CLHEP::Hep3Vector globalPoint = pointToGlobal(frame,diskID,localPoint);
 	
 	streamlog_out(DEBUG4) << 
 		"============================================\n" 
 		<< "SiStripGeomFTD::transformPointToGlobal \n" 
 		<< " Sensor ID (C-vector style): \n "
 		<< "   DISK: "<<diskID<<" PETAL: "<<petalID<<" SENSOR: " << sensorID << "\n"
-		<< "   Petal Phi: " << phi*180.0/M_PI << "\n"
+		<< "   Petal Phi: " << getLadderPhi(diskID,petalID)*180.0/M_PI << "\n"
 		<< std::setprecision(3) 
-		<< " Origen of Local frame [mm]: (" << xsensorCd/mm <<","
-			<< ysensorCd/mm << "," << zsensor/mm << ")\n"
+		<< " Origen of Local frame [mm]: " << frame.originGlobal/mm << "\n"
 		<< " Hit (Global ref. frame) [mm]:" << globalPoint/mm << "\n"
 		<< " Hit (Local ref. frame)  [mm]:" << localPoint/mm << "\n" 
 		<< "============================================" << std::endl;
@@ -611,6 +621,23 @@ CLHEP::Hep3Vector SiStripGeomFTD::transformPointToGlobal(short int diskID,
 	return globalPoint;
 }
 
+//
+// Transforming given point from the local ref. system of the given sensor frame
+// to global ref. system
+//
+CLHEP::Hep3Vector SiStripGeomFTD::pointToGlobal(const SensorFrame & frame, const int & diskID,
+		const CLHEP::Hep3Vector & localPoint) const
+{
+	// Perform translation - to the center of a petal (in local frame), the
+	// center of the petal is defined in the back face of the sensor and in
+	// the low edge of the petal
+	CLHEP::Hep3Vector globalPoint(localPoint);
+	globalPoint.setY(globalPoint.getY()-_sensorWidth[diskID]/2.0);
+
+	// Perform rotation and translation - to the global system
+	return frame.rotToGlobal*globalPoint + frame.originGlobal;
+}
+
 //
 // Method transforming given vector from local ref. system to global ref. system
 // (parameters: layerID, ladderID, sensorID and vector in local ref. system)
@@ -618,29 +645,8 @@ CLHEP::Hep3Vector SiStripGeomFTD::transformPointToGlobal(short int diskID,
 CLHEP::Hep3Vector SiStripGeomFTD::transformVecToGlobal(short int diskID, short int petalID, 
 		short int sensorID, const CLHEP::Hep3Vector & localVec)
 {
-	// Initialize global vector
-	CLHEP::Hep3Vector globalVec(localVec);
-
-	
-	// Calculate rotation angles
-	double theta = getLadderTheta(diskID); // ALWAYS PI/2
-	double phi   = getLadderPhi(diskID, petalID);
-	
-	const int realLayerID = getLayerRealID(diskID);
-	const int zsign = abs(realLayerID)/realLayerID;
-	double rotZangle = -phi;
-	double rotYangle = -theta;
-	if( (sensorID < 3 && zsign > 0) || 
-			(sensorID > 2 && zsign < 0) )
-	{
-		rotZangle = M_PI-phi;
-		rotYangle = theta;
-	}
-	globalVec.rotateY(-rotYangle);
-	globalVec.rotateZ(-rotZangle);
-	
 	// Return vector in global ref. system
-	return globalVec;
+	return getSensorFrame(diskID,petalID,sensorID).rotToGlobal*localVec;
 }
 
 //
@@ -707,14 +713,11 @@ CLHEP::HepMatrix SiStripGeomFTD::transformMatxToGlobal(short int layerID, short
 bool SiStripGeomFTD::isPointInsideSensor (short int diskID, short int petalID, 
 		short int sensorID, const CLHEP::Hep3Vector & point) const
 {
-	// Angle defining the petals
-	const double phi0 = _ftdLayer->getPhiHalfDistance(diskID);
-
-	// Calculate the maximum of each axis
-	const double xmax = _ftdLayer->getSensitiveThickness(diskID)*mm;
-	const double ygap = (_ftdLayer->getSensitiveWidth(diskID)*mm - point.getZ())*tan(phi0);
-	const double ymax = _ftdLayer->getSensitiveLengthMax(diskID)*mm-ygap;
-	const double zmax = _ftdLayer->getSensitiveWidth(diskID)*mm;
+	// Calculate the maximum of each axis (the petal semiangle defines the gap)
+	const double xmax = _sensorThick[diskID];
+	const double ygap = (_sensorLength[diskID] - point.getZ())*_layerTanHalfPhi[diskID];
+	const double ymax = _sensorWidth[diskID]-ygap;
+	const double zmax = _sensorLength[diskID];
 
 	bool isIn = true;
 	// Boundary set +- epsilon
@@ -971,7 +974,7 @@ int SiStripGeomFTD::getStripID(const int & diskID, const int & sensorID,
 		zRot = pointRot.getZ();
 		// Put the strip 0 in the edge of the petal (recall
 		// the y=0 of the local system begins in the long edge)
-		const double tanPhi = tan(_ftdLayer->getPhiHalfDistance(diskID));
+		const double tanPhi = _layerTanHalfPhi[diskID];
 		yorigen = (getSensorLength(diskID)-pointRot.getZ())*tanPhi;
 
 		stripID = floor((posRPhiRot-yorigen)/sensPitch);
@@ -1064,7 +1067,7 @@ double SiStripGeomFTD::getSensorPitch(const int & diskID, const int & sensorID,
 	
 	// Changing reference system: rotate the petal in its centroid point
 	// to obtain the strips with the stereo angle
-	const double tanPhi = tan(_ftdLayer->getPhiHalfDistance(diskID));
+	const double tanPhi = _layerTanHalfPhi[diskID];
 	CLHEP::Hep3Vector point = transformPointToRotatedLocal( diskID, sensorID,
 			CLHEP::Hep3Vector(0.,0.0,posZ) );
 
@@ -1096,7 +1099,7 @@ double SiStripGeomFTD::getStripPosY(const int & diskID, const int & sensorID,
 	const double zPosPrime = transformPointToRotatedLocal( diskID,
 			sensorID, CLHEP::Hep3Vector(0.0,0.0,posZ) ).getZ();
 	// Extract origen of the sensitive part
-	const double tanPhi = tan(_ftdLayer->getPhiHalfDistance(diskID));
+	const double tanPhi = _layerTanHalfPhi[diskID];
 	const double yorigen = (getSensorLength(diskID)-zPosPrime)*tanPhi;
 
 	// Get pitch (da el pitch teniendo en cuenta lo que tiene que tener)
@@ -1135,37 +1138,12 @@ double SiStripGeomFTD::getStripPosY(const int & diskID, const int & sensorID,
 CLHEP::Hep3Vector SiStripGeomFTD::transformPointToRotatedLocal(const int & diskID, 
 		const int & sensorID, const CLHEP::Hep3Vector & point) const
 {
-	CLHEP::Hep3Vector pointPrime(point);
-
-	const double stAngle = getStereoAngle(diskID,sensorID);
-
 	// Changing reference system: rotate the petal in its centroid point
-	// to obtain the strips with the stereo angle
-	double ycentre = getSensorWidthMax(diskID)/2.0;
-	const double zcentre = getSensorLength(diskID)/2.0;
-
-	// The centre of the rotation
-	CLHEP::Hep3Vector rotcentre(0.0,ycentre,zcentre);
-	// Translating Zpos to the new ref. system
-	pointPrime -= rotcentre;
-
-	// Now we have the hit point from the system placed in the centre
-	// of the sensor and rotated the stereo angle
-
-	// We need to return to the local ref. frame (defined along this code)
-	// placed in a petal 'rotated'
-	rotcentre.rotateX(-stAngle);
-	// And extract the point in that system
-	pointPrime += rotcentre;
-
-	// Rotating the vector to the new coordinate system--->NOOO
-	//pointPrime.rotateX(-stAngle);
-	// Consistency Check
-	/*CLHEP::Hep3Vector Orig(0.,0.,0.);
-	Orig = CLHEP::Hep3Vector(0.0,ycentre,zcentre)-rotcentre;
-	std::cout << "To-- pointPrime+O =? P :" << pointPrime + Orig << " =? " << point << std::endl;*/
-	
-	return pointPrime;
+	// to obtain the strips with the stereo angle. The point is moved to the
+	// system placed in the centre of the sensor and then back to the local
+	// ref. frame of the rotated petal - the shift of both translations is
+	// tabulated (see buildGeometryTables)
+	return point + getRotCentreShift(diskID,sensorID);
 }
 
 //
@@ -1175,29 +1153,7 @@ CLHEP::Hep3Vector SiStripGeomFTD::transformPointToRotatedLocal(const int & diskI
 CLHEP::Hep3Vector SiStripGeomFTD::transformPointFromRotatedLocal(const int & diskID, 
 		const int & sensorID, const CLHEP::Hep3Vector & pointPrime) const
 {
-	CLHEP::Hep3Vector point(pointPrime);
-	
-	const double stAngle = getStereoAngle(diskID,sensorID);
-	
-	// center of the petal
-	double ycentre = getSensorWidthMax(diskID)/2.0;
-	const double zcentre = getSensorLength(diskID)/2.0;
-
-	CLHEP::Hep3Vector rotcentre(0.0,ycentre,zcentre);
-	rotcentre.rotateX(-stAngle);
-
-	// Positioning in the center of the rotating frame
-	point -= rotcentre;
-	
-	// And positioning in the origin
-	point += CLHEP::Hep3Vector(0.0,ycentre,zcentre);
-
-/*	// Consistency Check
-	CLHEP::Hep3Vector Orig(0.,0.,0.);
-	Orig = CLHEP::Hep3Vector(0.0,ycentre,zcentre)-rotcentre;
-	std::cout << " pointPrime+O =? P :" << pointPrime + Orig << " =? " << point << std::endl;*/
-	
-	return point;
+	return pointPrime - getRotCentreShift(diskID,sensorID);
 }
 
 // PRINT METHODS
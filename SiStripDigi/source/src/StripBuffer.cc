@@ -0,0 +1,251 @@
+#include "StripBuffer.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace sistrip {
+
+//
+// Add signal deposited at given strip
+//
+void StripBuffer::addDeposit(int cellID, StripType type, int stripID, double charge, double time)
+{
+	_depCellID.push_back(cellID);
+	_depType.push_back(type);
+	_depStripID.push_back(stripID);
+	_depCharge.push_back(charge);
+	_depTime.push_back(time);
+	_depSimHitBegin.push_back(_depSimHit.size());
+}
+
+//
+// Add MC truth information of strip i of another buffer to the last deposit
+//
+void StripBuffer::addDepositSimHits(const StripBuffer & src, int i, double factor)
+{
+	for(int k=src.getSimHitBegin(i); k<src.getSimHitEnd(i); ++k)
+	{
+		_depSimHit.push_back(std::make_pair(src.getSimHit(k),
+					float(src.getSimHitWeight(k) * factor)));
+	}
+}
+
+//
+// Merge deposits into strips
+//
+void StripBuffer::compact()
+{
+	// Existing strips become the first deposits
+	if(!_stripID.empty())
+	{
+		const int nStrips = _stripID.size();
+
+		for(unsigned int d=0; d<_depSimHitBegin.size(); ++d)
+		{
+			_depSimHitBegin[d] += _simHit.size();
+		}
+		_depSimHitBegin.insert(_depSimHitBegin.begin(), _simHitBegin.begin(), _simHitBegin.end()-1);
+		_depSimHit.insert(_depSimHit.begin(), _simHit.begin(), _simHit.end());
+
+		_depStripID.insert(_depStripID.begin(), _stripID.begin(), _stripID.end());
+		_depCharge.insert(_depCharge.begin(), _charge.begin(), _charge.end());
+		_depTime.insert(_depTime.begin(), _time.begin(), _time.end());
+
+		_depCellID.insert(_depCellID.begin(), nStrips, 0);
+		_depType.insert(_depType.begin(), nStrips, 0);
+		for(unsigned int side=0; side+1<_sideBegin.size(); ++side)
+		{
+			for(int i=_sideBegin[side]; i<_sideBegin[side+1]; ++i)
+			{
+				_depCellID[i] = _cellID[side/2];
+				_depType[i]   = side%2;
+			}
+		}
+	}
+
+	const int nDep = _depStripID.size();
+
+	// Sensors ordered by cellID
+	_cellID = _depCellID;
+	std::sort(_cellID.begin(), _cellID.end());
+	_cellID.erase(std::unique(_cellID.begin(), _cellID.end()), _cellID.end());
+
+	// Order deposits by sensor side and strip, deposits of the same strip
+	// keep the order in which they were added
+	_depSide.resize(nDep);
+	_order.resize(nDep);
+	for(int d=0; d<nDep; ++d)
+	{
+		const int iSensor = std::lower_bound(_cellID.begin(), _cellID.end(),
+				_depCellID[d]) - _cellID.begin();
+		_depSide[d] = 2*iSensor + _depType[d];
+		_order[d]   = d;
+	}
+	std::stable_sort(_order.begin(), _order.end(), DepositLess(_depSide, _depStripID));
+
+	// Fill strips
+	_sideBegin.assign(2*_cellID.size() + 1, 0);
+	_stripID.clear();
+	_charge.clear();
+	_time.clear();
+	_simHitBegin.clear();
+	_simHit.clear();
+
+	int j = 0;
+	while(j < nDep)
+	{
+		const int dFirst = _order[j];
+
+		double charge = _depCharge[dFirst];
+		_stripSimHit.clear();
+
+		// All deposits of the same strip
+		int jEnd = j;
+		while(jEnd < nDep && _depSide[_order[jEnd]] == _depSide[dFirst] &&
+				_depStripID[_order[jEnd]] == _depStripID[dFirst])
+		{
+			const int d = _order[jEnd];
+			if(jEnd != j)
+			{
+				charge += _depCharge[d];
+			}
+
+			const int kEnd = (d+1 < nDep) ? _depSimHitBegin[d+1] : int(_depSimHit.size());
+			for(int k=_depSimHitBegin[d]; k<kEnd; ++k)
+			{
+				_stripSimHit.push_back(_depSimHit[k]);
+			}
+			++jEnd;
+		}
+
+		// Sum weights of the same SimTrackerHit
+		std::stable_sort(_stripSimHit.begin(), _stripSimHit.end(), simHitLess);
+
+		_simHitBegin.push_back(_simHit.size());
+		for(unsigned int k=0; k<_stripSimHit.size(); ++k)
+		{
+			if(k>0 && _stripSimHit[k].first == _simHit.back().first)
+			{
+				_simHit.back().second += _stripSimHit[k].second;
+			}
+			else
+			{
+				_simHit.push_back(_stripSimHit[k]);
+			}
+		}
+
+		_stripID.push_back(_depStripID[dFirst]);
+		_charge.push_back(charge);
+		_time.push_back(_depTime[dFirst]);
+		_sideBegin[_depSide[dFirst] + 1]++;
+
+		j = jEnd;
+	}
+	_simHitBegin.push_back(_simHit.size());
+
+	for(unsigned int s=1; s<_sideBegin.size(); ++s)
+	{
+		_sideBegin[s] += _sideBegin[s-1];
+	}
+
+	// Release deposits
+	_depCellID.clear();
+	_depType.clear();
+	_depStripID.clear();
+	_depCharge.clear();
+	_depTime.clear();
+	_depSimHitBegin.clear();
+	_depSimHit.clear();
+}
+
+//
+// Release content
+//
+void StripBuffer::clear()
+{
+	_depCellID.clear();
+	_depType.clear();
+	_depStripID.clear();
+	_depCharge.clear();
+	_depTime.clear();
+	_depSimHitBegin.clear();
+	_depSimHit.clear();
+
+	_cellID.clear();
+	_sideBegin.assign(1, 0);
+	_stripID.clear();
+	_charge.clear();
+	_time.clear();
+	_simHitBegin.assign(1, 0);
+	_simHit.clear();
+}
+
+//
+// Swap content
+//
+void StripBuffer::swap(StripBuffer & other)
+{
+	_depCellID.swap(other._depCellID);
+	_depType.swap(other._depType);
+	_depStripID.swap(other._depStripID);
+	_depCharge.swap(other._depCharge);
+	_depTime.swap(other._depTime);
+	_depSimHitBegin.swap(other._depSimHitBegin);
+	_depSimHit.swap(other._depSimHit);
+
+	_cellID.swap(other._cellID);
+	_sideBegin.swap(other._sideBegin);
+	_stripID.swap(other._stripID);
+	_charge.swap(other._charge);
+	_time.swap(other._time);
+	_simHitBegin.swap(other._simHitBegin);
+	_simHit.swap(other._simHit);
+}
+
+//
+// Find strip
+//
+int StripBuffer::findStrip(int cellID, StripType type, int stripID) const
+{
+	std::vector<int>::const_iterator itCell = std::lower_bound(_cellID.begin(), _cellID.end(), cellID);
+	if(itCell == _cellID.end() || *itCell != cellID)
+	{
+		return -1;
+	}
+	const int iSensor = itCell - _cellID.begin();
+
+	std::vector<int>::const_iterator itEnd   = _stripID.begin() + getEnd(iSensor, type);
+	std::vector<int>::const_iterator itStrip = std::lower_bound(_stripID.begin() + getBegin(iSensor, type),
+			itEnd, stripID);
+	if(itStrip == itEnd || *itStrip != stripID)
+	{
+		return -1;
+	}
+
+	return itStrip - _stripID.begin();
+}
+
+//
+// Get MC truth information - sum of weights
+//
+float StripBuffer::getSimHitWeightSum(int i) const
+{
+	float weightSum = 0;
+
+	for(int k=getSimHitBegin(i); k<getSimHitEnd(i); ++k)
+	{
+		weightSum += getSimHitWeight(k);
+	}
+
+	return weightSum;
+}
+
+//
+// SimTrackerHits ordered by pointer - the same order as in SimTrackerHitMap
+//
+bool StripBuffer::simHitLess(const SimHitWeight & a, const SimHitWeight & b)
+{
+	return std::less<EVENT::SimTrackerHit *>()(a.first, b.first);
+}
+
+} // Namespace
@@ -42,6 +42,8 @@
  *                     coveriance matric of TrackerHits.
  *   PointResolutionZ:    default(0.001440) : resolution value assigned to 
  *                     coveriance matric of TrackerHits.
+ *   NumberOfThreads: default(1) : number of threads used to cluster 
+ *                     pixel hits of different ladders.
  *   
  * <br>
  * @author Akiya Miyamoto, KEK: 2010-04-19
@@ -59,10 +61,18 @@ class TTree;
 class TFile;
 
 typedef std::pair<unsigned int, unsigned int> FPCCDHitLoc_t;
-typedef std::map<FPCCDHitLoc_t, FPCCDPixelHit*>  FPCCDLadderHit_t;
+// Pixel hits of one ladder, sorted by (xi, zeta): each xi forms a sparse row.
+typedef std::vector<FPCCDPixelHit*>  FPCCDLadderHit_t;
 typedef std::vector<FPCCDPixelHit*> FPCCDCluster_t;
 typedef std::vector<FPCCDCluster_t*> FPCCDClusterVec_t;
 
+// SimTrackerHit indices (order IDs) of the clusters of one ladder, in one flat array.
+// Cluster ic uses index[begin[ic]] ... index[begin[ic+1]-1], sorted and unique.
+struct FPCCDClusterLinks_t {
+  std::vector<int> index{};
+  std::vector<unsigned int> begin{};
+};
+
 
 // =================================================================
 class FPCCDClustering : public marlin::Processor, public marlin::EventModifier {
@@ -102,11 +112,15 @@ class FPCCDClustering : public marlin::Processor, public marlin::EventModifier {
   void InitGeometry();
 
  protected:
-  // Make clusters in a ladder
-  void makeClustersInALadder( int layer, FPCCDLadderHit_t &ladderHit, FPCCDClusterVec_t &cvec);
+  // Make clusters in a ladder. ladderHit has to be sorted by (xi, zeta).
+  // Only reads processor parameters, so ladders can be clustered concurrently.
+  void makeClustersInALadder( int layer, const FPCCDLadderHit_t &ladderHit, FPCCDClusterVec_t &cvec) const;
+
+  // Collect the SimTrackerHit indices of each cluster of a ladder.
+  static void collectClusterLinks( const FPCCDClusterVec_t &cvec, FPCCDClusterLinks_t &links );
 
-  // Make TrackerHit from clusters
-  void makeTrackerHit(LCCollection* STHcol, int layer, int ladder, FPCCDClusterVec_t &cvec, std::multimap< std::pair<int,int>, SimTrackerHit*> relMap, LCCollectionVec* relCol, LCCollectionVec* trkHitVec);
+  // Make TrackerHit from clusters. simHits is the SimTrackerHit collection indexed by order ID.
+  void makeTrackerHit(int layer, int ladder, FPCCDClusterVec_t &cvec, const FPCCDClusterLinks_t &links, const std::vector<SimTrackerHit*> &simHits, LCCollectionVec* relCol, LCCollectionVec* trkHitVec);
 
   void EnergyDigitizer(FPCCDPixelHit* aHit);
 protected:
@@ -136,6 +150,7 @@ protected:
   double _electronNoiseRate{};
   int _electronsPerStep{};
   int _nbitsForEdep{};
+  int _nThreads{};
 
   int _ranSeed{};
   gsl_rng* _rng{};
@@ -47,6 +47,10 @@
  *   Debug : default(0). : if 1, print debug information
  *   FPCCD_PixelSize : default(0.005) : FPCCD pixel size, which is used 
  *                     digitization
+ *   CompactPixelFormat : default(false) : if true, VTXPixelHits is written 
+ *                     in the compact format of FPCCDPixelCodec
+ *   CompactPixelFormat_EdepStep(keV) : default(0.01) : energy step used to
+ *                     quantise the energy deposit in the compact format
  *  
  * <br>
  * @author Akiya Miyamoto, KEK: 2010-04-19
@@ -67,6 +71,12 @@ typedef struct {
   int xi;
   int zeta;
 }   FPCCDID_t;
+
+typedef struct {
+  int xi;
+  int zeta;
+  double edep;
+}   FPCCDPixelDeposit_t;
   
 
 // =================================================================
@@ -115,14 +125,14 @@ class FPCCDDigitizer : public marlin::Processor, public marlin::EventModifier {
   void        getInOutPosOnLadder( int layer, gear::Vector3D* outpos, gear::Vector3D* inpos, gear::Vector3D* pos,gear::Vector3D* mom);
   void getInOutPosOfHelixOnLadder( int layer, gear::Vector3D* outpos, gear::Vector3D* inpos, gear::Vector3D* pos,gear::Vector3D* mom, gear::Vector3D* BField,float charge);
   void           ModifyIntoLadder( gear::Vector3D* bemodifiedpos,const int layer,gear::Vector3D* pos,gear::Vector3D* mom);
-  void             makeCandidates( std::pair<const gear::Vector3D*,int> edge, std::pair<int,int>* cand_array, int layer);
   void             makeNewSimTHit( IMPL::SimTrackerHitImpl* simthit, gear::Vector3D* newpos, gear::Vector3D* newmom, int layer, int ladder, double newPathLength);
   bool          inSensitiveRegion( gear::Vector3D* pos, int layer);
   
-  gear::Vector3D* getLocalPos(const gear::Vector3D* pos, const int layer,const int ladder);
-  std::vector<std::pair<const gear::Vector3D*, int> > getIntersectionOfTrkAndPix(const int layer,gear::Vector3D* top,gear::Vector3D* bottom);
-  std::map< std::pair< int, int>*, double> getLocalPixel(IMPL::SimTrackerHitImpl* simthit, std::vector<std::pair<const gear::Vector3D*, int> > edgeofpixel);
-  std::pair< int, int>* FindPixel(std::pair<const gear::Vector3D*, int> f_fst, std::pair<const gear::Vector3D*, int> f_nxt, int f_layer);
+  gear::Vector3D getLocalPos(const gear::Vector3D* pos, const int layer,const int ladder);
+
+  // Walk along the straight path from inpos to outpos through the pixel grid of the ladder
+  // and store the energy deposit of each crossed pixel in deposits, in the order of crossing.
+  void getLocalPixel(IMPL::SimTrackerHitImpl* simthit, int layer, const gear::Vector3D& inpos, const gear::Vector3D& outpos, std::vector<FPCCDPixelDeposit_t>& deposits);
   
  protected:
 
@@ -199,6 +209,11 @@ class FPCCDDigitizer : public marlin::Processor, public marlin::EventModifier {
   float _pointResoRPhi{}, _pointResoZ{};
   
   bool _isSignal{};
+
+  bool _compactPixelFormat{};
+  double _compactEdepStep{};
+
+  std::vector<FPCCDPixelDeposit_t> _pixelDeposits{}; // reused for every SimTrackerHit
   
 // Variables to store geometry information 
   int _nLayer{};  // Number of layers
@@ -0,0 +1,86 @@
+#ifndef FPCCDPixelCodec_h
+#define FPCCDPixelCodec_h 1
+
+#include "lcio.h"
+#include <EVENT/LCCollection.h>
+#include <EVENT/LCGenericObject.h>
+#include <IMPL/LCCollectionVec.h>
+#include <string>
+#include <vector>
+
+class FPCCDData;
+class FPCCDPixelHit;
+
+/** ======= FPCCDPixelCodec ========== <br>
+ *
+ * Compact encoding of FPCCD pixel hits, used to pass the VTXPixelHits collection
+ * from FPCCDDigitizer to FPCCDClustering and anaPix with a smaller event size
+ * than FPCCDData::packPixelHits.
+ *
+ * One LCGenericObject is written per ladder with hits:
+ *   int[0] = format version, int[1] = layer, int[2] = ladder, int[3] = number of
+ *   pixel hits, int[4] = number of bytes; int[5...] = byte stream packed 4 bytes
+ *   per int.  float[0] = energy step (GeV) used to quantise the energy deposit.
+ *
+ * Pixel hits are sorted by (xi, zeta) and grouped in runs of consecutive zeta
+ * in one xi row. Each run is stored as varints: xi difference to the previous run,
+ * zeta of the first pixel (relative to the end of the previous run in the same
+ * row), run length. Then for each pixel: quality and number of order IDs,
+ * the energy deposit in units of the energy step, and the order IDs as zig-zag
+ * differences to the previous order ID.
+ *
+ * The collection parameter FPCCDPixelFormat is set to "compact". unpackPixelHits
+ * reads either format, so readers do not need to know which one was written.
+ */
+class FPCCDPixelCodec {
+
+ public:
+  /** Fill the pixel hits of all layers and ladders of pxHits into col,
+   *  with energy deposits rounded to multiples of edepStep (GeV).
+   */
+  static void packPixelHits( FPCCDData &pxHits, int nLayer, int maxLadder,
+                             double edepStep, IMPL::LCCollectionVec &col );
+
+  /** Read pixel hits from col into pxHits. Collections written by
+   *  FPCCDData::packPixelHits are passed to FPCCDData::unpackPixelHits.
+   *  Returns the number of pixel hits.
+   */
+  static int unpackPixelHits( EVENT::LCCollection &col, FPCCDData &pxHits );
+
+  /** True if col was written by packPixelHits of this class. */
+  static bool isCompact( EVENT::LCCollection &col );
+
+  static const std::string FormatParameter;
+  static const std::string CompactFormat;
+  static const int Version = 1;
+
+ private:
+  /** Append bytes to a vector of 32 bit words */
+  class ByteWriter {
+  public:
+    ByteWriter( std::vector<unsigned int> &words ) : _words(words) {}
+    void putByte( unsigned int byte );
+    void putVarint( unsigned int value );
+    void putSigned( int value ) { putVarint( ((unsigned int)value << 1) ^ (unsigned int)(value >> 31) ); }
+    unsigned int nBytes() const { return _nBytes; }
+  private:
+    std::vector<unsigned int> &_words;
+    unsigned int _nBytes{};
+  };
+
+  /** Read bytes back from the int values of an LCGenericObject */
+  class ByteReader {
+  public:
+    ByteReader( const EVENT::LCGenericObject *obj, int firstWord ) : _obj(obj), _firstWord(firstWord) {}
+    unsigned int getByte();
+    unsigned int getVarint();
+    int getSigned() { unsigned int v = getVarint(); return (int)(v >> 1) ^ -(int)(v & 1); }
+  private:
+    const EVENT::LCGenericObject *_obj;
+    int _firstWord;
+    unsigned int _pos{};
+    unsigned int _word{};
+  };
+};
+
+#endif
@@ -8,6 +8,7 @@ set 0.
 #include "FPCCDClustering.h"
 #include "FPCCDPixelHit.h"
 #include "FPCCDData.h"
+#include "FPCCDPixelCodec.h"
 
 #include <iostream>
 
@@ -32,7 +33,8 @@ set 0.
 #include <vector>
 #include <list>
 #include <utility>
-#include <stack>
+#include <set>
+#include <thread>
 
 #include "TFile.h"
 #include "TTree.h"
@@ -53,6 +55,42 @@ using namespace std ;
 
 FPCCDClustering aFPCCDClustering ;
 
+namespace
+{
+  // Ordering of pixel hits in a ladder: rows of xi, zeta inside a row
+  bool lessXiZeta( const FPCCDPixelHit* a, const FPCCDPixelHit* b )
+  {
+    if( a->getXiID() != b->getXiID() ) { return a->getXiID() < b->getXiID(); }
+    return a->getZetaID() < b->getZetaID();
+  }
+
+  bool lessThanLoc( const FPCCDPixelHit* a, const FPCCDHitLoc_t &loc )
+  {
+    if( (unsigned int)a->getXiID() != loc.first ) { return (unsigned int)a->getXiID() < loc.first; }
+    return (unsigned int)a->getZetaID() < loc.second;
+  }
+
+  // Root of a pixel in the union-find forest, with path halving
+  unsigned int findRoot( std::vector<unsigned int> &parent, unsigned int i )
+  {
+    while( parent[i] != i ) {
+      parent[i] = parent[parent[i]];
+      i = parent[i];
+    }
+    return i;
+  }
+
+  // Merge two trees. The smaller index becomes the root, so that the root of a
+  // cluster is always its first pixel in (xi, zeta) order.
+  void unite( std::vector<unsigned int> &parent, unsigned int i, unsigned int j )
+  {
+    unsigned int ri = findRoot( parent, i );
+    unsigned int rj = findRoot( parent, j );
+    if( ri < rj ) { parent[rj] = ri; }
+    else if( rj < ri ) { parent[ri] = rj; }
+  }
+}
+
 // =====================================================================
 FPCCDClustering::FPCCDClustering() : Processor("FPCCDClustering") {
 
@@ -257,6 +295,11 @@ FPCCDClustering::FPCCDClustering() : Processor("FPCCDClustering") {
       _remove_pixelhits_collection,
       bool(false)); 
 
+  registerProcessorParameter( "NumberOfThreads",
+      "Number of threads used to cluster the pixel hits of different ladders",
+      _nThreads,
+      int(1)); 
+
   // Input collections
   registerInputCollection( LCIO::SIMTRACKERHIT,
       "VTXCollectionName" , 
@@ -503,7 +546,7 @@ void FPCCDClustering::modifyEvent( LCEvent * evt )
 
     if( pHitCol != 0 && STHcol != 0){    
       FPCCDData theData(_nLayer, _maxLadder);  // prepare object to make pixelhits
-      int nhit=theData.unpackPixelHits(*pHitCol);//This unpacks LCGenericObjectVec made in FPCCDDigitizer (precisely, FPCCDData).
+      int nhit=FPCCDPixelCodec::unpackPixelHits(*pHitCol, theData);//This unpacks LCGenericObjectVec made in FPCCDDigitizer (FPCCDData or compact format).
       //And return number of pixel hits generated by one simtrackerhit in FPCCDDigitizer.
       if( _debug >= 2 ) { LCTOOLS::dumpEvent( evt ) ;}
 
@@ -808,15 +851,33 @@ void FPCCDClustering::modifyEvent( LCEvent * evt )
 void FPCCDClustering::makeTrackerHitVec(FPCCDData* pHitData, LCCollection* STHcol, LCCollectionVec* relCol,  LCCollectionVec* trkHitVec)
 {
   //At first, relCol and trkHitVec are void data.
-  typedef std::multimap< std::pair<int,int>, SimTrackerHit*> RelMap_t;
-  //std::multimap< std::pair<int,int>, SimTrackerHit*> relMap;//"multimap" allows duplication of Key and "map" doesn't.
-  RelMap_t relMap;//"multimap" allows duplication of Key and "map" doesn't.
 
-  relMap.clear();
+  // SimTrackerHits indexed by the order ID stored in the pixel hits, cast once per event
+  std::vector<SimTrackerHit*> simHits;
+  if( _makeRelation ) {
+    int nSimHits = STHcol->getNumberOfElements();
+    simHits.resize( nSimHits );
+    for(int i=0;i<nSimHits;i++){ simHits[i] = dynamic_cast<SimTrackerHit*>( STHcol->getElementAt(i) ); }
+  }
 
 
 
-  // Convert pixel hits to TrackerHits
+  // Pixel hits and clusters of one ladder
+  struct LadderWork_t {
+    int layer;
+    int ladder;
+    FPCCDLadderHit_t hits;
+    FPCCDClusterVec_t clusters;
+    FPCCDClusterLinks_t links;
+  };
+  std::vector<LadderWork_t> ladderWork;
+  ladderWork.reserve(_nLayer*_maxLadder);
+
+  // Random noise hits are not owned by pHitData
+  std::vector<FPCCDPixelHit*> noiseHits;
+
+  // (1) Copy all hits above threshold into per ladder vectors, sorted by (xi, zeta).
+  //     This step uses the random generator, so it is done sequentially.
   for(int layer=0;layer<_nLayer;layer++){
     int     nladder = _geodata[layer].nladder;
     double   sximin = _geodata[layer].sximin;
@@ -824,18 +885,13 @@ void FPCCDClustering::makeTrackerHitVec(FPCCDData* pHitData, LCCollection* STHco
     double sxiwidth = sximax-sximin;
     double  hlength = _geodata[layer].hlength;
 
-    // ----------------------------------------
-    // Start clustering of hits in each laddder
-    // ----------------------------------------
     for(int ladder=0;ladder<nladder;ladder++){
 
-      FPCCDLadderHit_t ladderHit; //typedef std::map<FPCCDHitLoc_t, FPCCDPixelHit*>  FPCCDLadderHit_t;
-
-      //typedef std::pair<unsigned int, unsigned int> FPCCDHitLoc_t;
-      //typedef std::map<FPCCDHitLoc_t, FPCCDPixelHit*>  FPCCDLadderHit_t;
-      // namely, std::map<std::pair<unsigned int, unsigned int>, FPCCDPixelHit*>
-
-
+      ladderWork.push_back( LadderWork_t() );
+      LadderWork_t &work = ladderWork.back();
+      work.layer = layer;
+      work.ladder = ladder;
+      FPCCDLadderHit_t &ladderHit = work.hits;
 
       PixelHitMap_t::iterator it=pHitData->itBegin(layer, ladder);      
       /*
@@ -844,7 +900,6 @@ void FPCCDClustering::makeTrackerHitVec(FPCCDData* pHitData, LCCollection* STHco
          typedef std::vector< std::vector<PixelHitMap_t> > PixelDataBuf_t;
        */
 
-      //(1) Copy all hits into local variables, ladderHit
       while( it != pHitData->itEnd(layer, ladder) ) {
 
         FPCCDPixelHit *aHit=(*it).second;
@@ -854,67 +909,126 @@ void FPCCDClustering::makeTrackerHitVec(FPCCDData* pHitData, LCCollection* STHco
           EnergyDigitizer( aHit );
         }
         if( aHit->getEdep() > ( _threshold/_electronsPerKeV ) * 1e-6 ) {  // Do the threshold cut
-
-          int xiID=aHit->getXiID();
-          int zetaID=aHit->getZetaID();
-          FPCCDHitLoc_t hitloc(xiID, zetaID);
-          ladderHit.insert(map<FPCCDHitLoc_t, FPCCDPixelHit*>::value_type(hitloc, aHit));
+          ladderHit.push_back( aHit );
         }
         it++;
       }
+      std::sort( ladderHit.begin(), ladderHit.end(), lessXiZeta );
+
       // Set the random noise hit
       if( _randomNoise && _energyDigitization){
         unsigned int noiseXi = 0;
         unsigned int noiseZeta = 0;
         double noiseEdep = 0;
+        std::set<FPCCDHitLoc_t> noiseLocs;
+        unsigned int nSignalHits = ladderHit.size();
 
         for(unsigned int i=0; i< gsl_ran_poisson( _rng, (sxiwidth/_pixelSizeVec[layer])*(2*hlength/_pixelSizeVec[layer])*3.1671*1e-5) ; i++){ // Random noise is generated by 4 sigma plobability.
 
           noiseXi = (unsigned int)gsl_ran_flat( _rng, 0, sxiwidth/_pixelSizeVec[layer] );
           noiseZeta = (unsigned int)gsl_ran_flat( _rng, 0, 2*hlength/_pixelSizeVec[layer] );          
           FPCCDHitLoc_t noiseHitLoc( noiseXi, noiseZeta );
-          FPCCDLadderHit_t::iterator noiseIt=ladderHit.find( noiseHitLoc );
 
-          if( noiseIt == ladderHit.end() ){
+          FPCCDLadderHit_t::iterator signalIt = std::lower_bound( ladderHit.begin(), ladderHit.begin()+nSignalHits, noiseHitLoc, lessThanLoc );
+          bool isSignalPixel = ( signalIt != ladderHit.begin()+nSignalHits 
+                                 && (unsigned int)(*signalIt)->getXiID() == noiseXi 
+                                 && (unsigned int)(*signalIt)->getZetaID() == noiseZeta );
+
+          if( !isSignalPixel && noiseLocs.insert( noiseHitLoc ).second ){
             noiseEdep = gsl_ran_gaussian_tail( _rng, _threshold, _electronNoiseRate )/(_electronsPerKeV * 1e+6 );
             FPCCDPixelHit* noiseHit = new FPCCDPixelHit(layer, ladder, noiseXi, noiseZeta, noiseEdep, FPCCDPixelHit::kBKG, 0);
             EnergyDigitizer( noiseHit);            
-            ladderHit.insert( map<FPCCDHitLoc_t, FPCCDPixelHit*>::value_type( noiseHitLoc, noiseHit) );
+            ladderHit.push_back( noiseHit );
+            noiseHits.push_back( noiseHit );
           }          
         }
-      }
-      // Do clustering
-      if( ladderHit.size() > 0 ) {
-        FPCCDClusterVec_t clusterVec;
-        //typedef std::vector<FPCCDPixelHit*> FPCCDCluster_t;
-        //typedef std::vector<FPCCDCluster_t*> FPCCDClusterVec_t;
-        //namely, std::vector<std::vector<FPCCDPixelHit*>>
-
-        makeClustersInALadder(layer, ladderHit, clusterVec);
-        if( _debug >= 1 ) { 
-          std::cout << "Layer:" << layer << " ladder:" << ladder << " # of clusters=" << clusterVec.size() << std::endl;
-          std::cout << "  # pixels in each clusters are "; 
-          for(unsigned int i=0;i<clusterVec.size();i++) {
-            std::cout << clusterVec[i]->size() << " " ;
-            if ( i > 1000 ) { std::cout << " ... omitting the rest. " ; break; }
-          }
-          std::cout << endl;
+        if( ladderHit.size() > nSignalHits ) {
+          std::sort( ladderHit.begin()+nSignalHits, ladderHit.end(), lessXiZeta );
+          std::inplace_merge( ladderHit.begin(), ladderHit.begin()+nSignalHits, ladderHit.end(), lessXiZeta );
         }
-        // Calulate position from cluster and 
-        makeTrackerHit(STHcol, layer, ladder, clusterVec, relMap, relCol, trkHitVec);
-        //At this phase, relCol and trkHitVec haven't been filled and changed.
-
-        // Now clean up clusters in clusterVec;
-        for(int i=clusterVec.size()-1;i>=0;i--){ delete clusterVec[i]; }
       }
     } // End of Ladder loop
   } // End of Layer loop
+
+  // (2) Do clustering and collect the SimTrackerHit links of each cluster.
+  //     Ladders are independent, so they may be shared among threads.
+  if( _nThreads > 1 && ladderWork.size() > 1 ) {
+    std::vector<std::thread> workers;
+    for(int ith=0;ith<_nThreads;ith++){
+      workers.push_back( std::thread( [this, &ladderWork, ith]() {
+            for(unsigned int iw=ith;iw<ladderWork.size();iw+=_nThreads){
+              LadderWork_t &work = ladderWork[iw];
+              if( work.hits.size() == 0 ) { continue; }
+              makeClustersInALadder(work.layer, work.hits, work.clusters);
+              collectClusterLinks(work.clusters, work.links);
+            }
+          } ) );
+    }
+    for(unsigned int ith=0;ith<workers.size();ith++){ workers[ith].join(); }
+  }
+  else {
+    for(unsigned int iw=0;iw<ladderWork.size();iw++){
+      LadderWork_t &work = ladderWork[iw];
+      if( work.hits.size() == 0 ) { continue; }
+      makeClustersInALadder(work.layer, work.hits, work.clusters);
+      collectClusterLinks(work.clusters, work.links);
+    }
+  }
+
+  // (3) Convert clusters to TrackerHits, ladder by ladder in a fixed order
+  for(unsigned int iw=0;iw<ladderWork.size();iw++){
+    LadderWork_t &work = ladderWork[iw];
+    if( work.hits.size() == 0 ) { continue; }
+    FPCCDClusterVec_t &clusterVec = work.clusters;
+
+    if( _debug >= 1 ) { 
+      std::cout << "Layer:" << work.layer << " ladder:" << work.ladder << " # of clusters=" << clusterVec.size() << std::endl;
+      std::cout << "  # pixels in each clusters are "; 
+      for(unsigned int i=0;i<clusterVec.size();i++) {
+        std::cout << clusterVec[i]->size() << " " ;
+        if ( i > 1000 ) { std::cout << " ... omitting the rest. " ; break; }
+      }
+      std::cout << endl;
+    }
+    // Calulate position from cluster and 
+    makeTrackerHit(work.layer, work.ladder, clusterVec, work.links, simHits, relCol, trkHitVec);
+
+    // Now clean up clusters in clusterVec;
+    for(int i=clusterVec.size()-1;i>=0;i--){ delete clusterVec[i]; }
+  }
+
+  for(unsigned int i=0;i<noiseHits.size();i++){ delete noiseHits[i]; }
 }
 
 
 
 
-void FPCCDClustering::makeTrackerHit(LCCollection* STHcol, int layer, int ladder, FPCCDClusterVec_t &clusterVec, std::multimap< std::pair<int,int>, SimTrackerHit*> relMap, LCCollectionVec* relCol, LCCollectionVec* trkHitVec )
+// =====================================================================
+void FPCCDClustering::collectClusterLinks( const FPCCDClusterVec_t &clusterVec, FPCCDClusterLinks_t &links )
+{
+  // Sometimes one pixel is generated by more than one simthits, so a pixel may
+  // carry several order IDs. -1 is the order ID of background pixels.
+  links.index.clear();
+  links.begin.resize( clusterVec.size()+1 );
+  for(unsigned int ic=0;ic<clusterVec.size();ic++) {
+    const FPCCDCluster_t &cluster = *clusterVec[ic];
+    unsigned int first = links.index.size();
+    links.begin[ic] = first;
+    for(unsigned int i=0;i<cluster.size();i++) {
+      int overlaidSize = cluster[i]->getSizeOfOrderID();
+      for(int ios = 0; ios < overlaidSize; ios++){
+        links.index.push_back( cluster[i]->getOrderID(ios) );
+      }
+    }
+    std::sort( links.index.begin()+first, links.index.end() );
+    links.index.erase( std::unique( links.index.begin()+first, links.index.end() ), links.index.end() );
+  }
+  links.begin[clusterVec.size()] = links.index.size();
+}
+
+
+// =====================================================================
+void FPCCDClustering::makeTrackerHit(int layer, int ladder, FPCCDClusterVec_t &clusterVec, const FPCCDClusterLinks_t &links, const std::vector<SimTrackerHit*> &simHits, LCCollectionVec* relCol, LCCollectionVec* trkHitVec )
 {
   //trkHitVec and relCol is yet void data. 
   //This Version is different from default version at the point of last area of this function scope.
@@ -941,16 +1055,7 @@ void FPCCDClustering::makeTrackerHit(LCCollection* STHcol, int layer, int ladder
     FPCCDPixelHit *maxZetaHit=(*cluster)[0]; FPCCDPixelHit *minZetaHit=(*cluster)[0];
 
     unsigned int nPix=cluster->size();    
-    std::list<int> orderVecOfCluster(0); //Mori added 20121203
     for(unsigned int i=0;i<nPix;i++) {
-      /***Mori added 20121203***/
-      int overlaidSize = (*cluster)[i]->getSizeOfOrderID();//Sometimes one pixel is generated by more than one simthits. 
-      //So, usually overlaidSize is one, but sometimes 2 or more.
-      for(int ios = 0; ios < overlaidSize; ios++){
-        orderVecOfCluster.push_back( (*cluster)[i]->getOrderID(ios) ); //Mori added 20121204
-      }
-      /********end**************/
-
       FPCCDPixelHit *aHit=(*cluster)[i]; trackquality = aHit->getQuality(); enesum+=aHit->getEdep();
       xiene+=((double)(aHit->getXiID()+0.5))*_pixelSizeVec[layer]*aHit->getEdep();
       zetaene+=((double)(aHit->getZetaID()+0.5))*_pixelSizeVec[layer]*aHit->getEdep();
@@ -1012,20 +1117,6 @@ void FPCCDClustering::makeTrackerHit(LCCollection* STHcol, int layer, int ladder
 
 
 
-            //*******************************Mori added 20121203*************************************//
-            // Here finds the numbers of types of simthits that create trkhit in this scope.
-            std::vector<int> typesOfOrderID;
-            orderVecOfCluster.sort(); //sort() also sort order Vec 
-            std::list<int>::iterator itlist;
-            int tmpV = -1000;
-            for(itlist = orderVecOfCluster.begin(); itlist != orderVecOfCluster.end(); itlist++){
-              if(*itlist != tmpV){ 
-                typesOfOrderID.push_back(*itlist);
-                tmpV = *itlist;
-              }
-            }
-            //********************************************************************************************//
-
             float pointResoRPhi = 0.0;
             float pointResoZ    = 0.0;
             if(_positionReso_ReadingFile_ON == true){
@@ -1092,12 +1183,14 @@ void FPCCDClustering::makeTrackerHit(LCCollection* STHcol, int layer, int ladder
 
             //LCRelationImpl* rel = new LCRelationImpl ;
             if(_makeRelation == true){
+              // The types of simthits that create trkhit in this scope.
               SimTrackerHit* p_simthit; 
-              int ntypes = typesOfOrderID.size();
+              int ntypes = links.begin[ic+1] - links.begin[ic];
               for(int i = 0; i < ntypes; i++){ 
-                LCRelationImpl* rel = new LCRelationImpl ;
-                if(typesOfOrderID[i] >= 0){
-                  p_simthit =  dynamic_cast<SimTrackerHit*>( STHcol->getElementAt( typesOfOrderID[i] ) ) ;      
+                int orderID = links.index[ links.begin[ic] + i ];
+                if(orderID >= 0){
+                  LCRelationImpl* rel = new LCRelationImpl ;
+                  p_simthit = simHits[ orderID ];
                   float nTo = static_cast<float>( ntypes ); 
                   rel->setTo( p_simthit ); 
                   rel->setFrom( trkHit ); 
@@ -1123,11 +1216,9 @@ void FPCCDClustering::makeTrackerHit(LCCollection* STHcol, int layer, int ladder
 //void FPCCDClustering::viewerOfClusterShape(FPCCDClusterVec_t &clusterVec);
 
 // =====================================================================
-void FPCCDClustering::makeClustersInALadder(int layer, FPCCDLadderHit_t &ladderHit, FPCCDClusterVec_t &clusterVec)
+void FPCCDClustering::makeClustersInALadder(int layer, const FPCCDLadderHit_t &ladderHit, FPCCDClusterVec_t &clusterVec) const
 {
-  //typedef std::pair<unsigned int, unsigned int> FPCCDHitLoc_t;
-  //typedef std::map<FPCCDHitLoc_t, FPCCDPixelHit*>  FPCCDLadderHit_t;
-  // namely, std::map<std::pair<unsigned int, unsigned int>, FPCCDPixelHit*>
+  //typedef std::vector<FPCCDPixelHit*> FPCCDLadderHit_t, sorted by (xi, zeta)
 
   //typedef std::vector<FPCCDPixelHit*> FPCCDCluster_t;
   //typedef std::vector<FPCCDCluster_t*> FPCCDClusterVec_t;
@@ -1137,65 +1228,59 @@ void FPCCDClustering::makeClustersInALadder(int layer, FPCCDLadderHit_t &ladderH
   //(2) Start pixel hit clustering 
   //    All pixels adjucent pixels are clustered, if it has a hit.  Threshold is not considered yet
   //    2013_06_07 I think thresold cut has been done before makeClustersInALadder(...).
+  //
+  //    Two pass connected component labelling over the sparse rows of the ladder.
+  //    First pass: each pixel is merged with its left neighbour in the same row and
+  //    with the three touching pixels of the previous row, which are found by a
+  //    pointer walking along the previous row. Second pass: pixels are collected 
+  //    into clusters according to their root.
+
+  unsigned int npix = ladderHit.size();
+  std::vector<unsigned int> parent(npix);
+
+  unsigned int rowBegin = 0;   // first pixel of the current row
+  unsigned int prevBegin = 0;  // [prevBegin, prevEnd) : pixels of row xi-1 not yet left behind
+  unsigned int prevEnd = 0;
+  for(unsigned int i=0;i<npix;i++) {
+    parent[i] = i;
+    unsigned int xi = ladderHit[i]->getXiID();
+    unsigned int zeta = ladderHit[i]->getZetaID();
+
+    if( i == 0 || xi != (unsigned int)ladderHit[i-1]->getXiID() ) {   // Start of a new row
+      if( i > 0 && (unsigned int)ladderHit[i-1]->getXiID()+1 == xi ) { prevBegin = rowBegin; prevEnd = i; }
+      else { prevBegin = i; prevEnd = i; }
+      rowBegin = i;
+    }
+    else if( (unsigned int)ladderHit[i-1]->getZetaID()+1 == zeta ) {
+      unite( parent, i, i-1 );
+    }
 
-  int   maxxi = _geodata[layer].num_xi_pixel;
-  int maxzeta = _geodata[layer].num_zeta_pixel;
-
-  FPCCDLadderHit_t::iterator ih = ladderHit.begin();
-  while( ih != ladderHit.end() ) {
-    FPCCDPixelHit *h=(*ih).second;
-    (*ih).second=0;
-    ih++;
-    if( h==0 ) { continue; }
-    //  std::cerr << "Found a seed pixel.  Edep=" << h->getEdep() << std::endl;
-    //  Found a ssed of a cluster
-
-    FPCCDCluster_t *cluster=new FPCCDCluster_t();
-    cluster->push_back(h);
-    int xi0=h->getXiID();
-    int zeta0=h->getZetaID();
-    typedef std::pair<int, int> Direction_t;
-    std::stack<Direction_t>  direction;   
-    for(int i=-1;i<=1;i++) { // Set initial search direction, neighbouring 8 pixels are searched
-      for(int j=-1;j<=1;j++) {
-        if( i!=0 || j!= 0 ) { direction.push(Direction_t(i,j)); }
-      }
-    } 
-    // Now look for all directions and find pixel with hit.
-    while( ! direction.empty() ) {
-      Direction_t newdir=direction.top();
-      int xi=xi0+newdir.first;
-      int zeta=zeta0+newdir.second;
-      //          std::cerr << "searching at (xi,zeta)=" << xi << "  " << zeta << std::endl;
-      if( xi < 0 || xi > maxxi || zeta < 0 || zeta > maxzeta ) {
-        direction.pop(); continue;
-      }
-      FPCCDHitLoc_t newloc(xi, zeta);
-      FPCCDLadderHit_t::iterator look=ladderHit.find(newloc);//If not found, end iterator is returned.
-      if( look == ladderHit.end() ) {
-        direction.pop(); continue;
-      }
-      FPCCDPixelHit *aHit=(*look).second;
-      if( aHit == 0 ) {
-        direction.pop(); continue;
-      }
-      cluster->push_back( aHit );
-      //          std::cout << " Found hit .. at xi, zeta=" << xi << " " << zeta << std::endl;
-      (*look).second=0;
-      for (int ix=-1;ix<=1;ix++) {
-        for(int iz=-1;iz<=1;iz++) {
-          if( ix != 0 || iz != 0 ) { 
-            direction.push(Direction_t(newdir.first+ix, newdir.second+iz));
-          }
-        }
-      }
-    } // Complete search of all nighbours of the seed
-    if( cluster->size() > 0 ) {
-      //Mori added
-      if(_firstCut.isActive != true || _firstCut.nPix[layer] < 0 || cluster->size() < static_cast<unsigned int>(_firstCut.nPix[layer])){
-        clusterVec.push_back(cluster);  
-      }
+    while( prevBegin < prevEnd && (unsigned int)ladderHit[prevBegin]->getZetaID()+1 < zeta ) { prevBegin++; }
+    for(unsigned int j=prevBegin;j<prevEnd && (unsigned int)ladderHit[j]->getZetaID() <= zeta+1;j++) {
+      unite( parent, i, j );
+    }
+  }
+
+  // The root of each cluster is its first pixel, so clusters come out ordered by
+  // their first pixel and are filled in (xi, zeta) order.
+  std::vector<FPCCDCluster_t*> clusterOfRoot(npix, 0);
+  FPCCDClusterVec_t clusters;
+  for(unsigned int i=0;i<npix;i++) {
+    unsigned int root = findRoot( parent, i );
+    if( root == i ) {
+      clusterOfRoot[i] = new FPCCDCluster_t();
+      clusters.push_back( clusterOfRoot[i] );
+    }
+    clusterOfRoot[root]->push_back( ladderHit[i] );
+  }
+
+  for(unsigned int ic=0;ic<clusters.size();ic++) {
+    FPCCDCluster_t *cluster = clusters[ic];
+    //Mori added
+    if(_firstCut.isActive != true || _firstCut.nPix[layer] < 0 || cluster->size() < static_cast<unsigned int>(_firstCut.nPix[layer])){
+      clusterVec.push_back(cluster);  
     }
+    else { delete cluster; }
   } 
 }
 
@@ -2,6 +2,7 @@
 #include "FPCCDDigitizer.h"
 #include "FPCCDPixelHit.h"
 #include "FPCCDData.h"
+#include "FPCCDPixelCodec.h"
 
 #include <iostream>
 #include <cstring>
@@ -29,20 +30,6 @@ using namespace lcio ;
 using namespace marlin ;
 using namespace std ;
 
-namespace
-{
-  template<class T1,class T2,class T3>
-  class SortByPosX
-  {
-  public:
-    bool operator()( const T1& object1, const T1& object2 )
-    {
-      return object1.first->x() < object2.first->x();
-    }
-  };
-}
-
-
 FPCCDDigitizer aFPCCDDigitizer ;
 
 
@@ -143,6 +130,16 @@ FPCCDDigitizer::FPCCDDigitizer() : Processor("FPCCDDigitizer") {
                               _EL_almostOFF ,
                               bool(false));
 
+  registerProcessorParameter( "CompactPixelFormat" ,
+                              "true : write VTXPixelHits in the compact run-length encoded format. Readable by FPCCDClustering and anaPix only." ,
+                              _compactPixelFormat ,
+                              bool(false));
+
+  registerProcessorParameter( "CompactPixelFormat_EdepStep(keV)" ,
+                              "Energy deposit of a pixel is rounded to a multiple of this value in the compact format (keV)" ,
+                              _compactEdepStep ,
+                              double(0.01));
+
   // Input collections
   registerInputCollection( LCIO::SIMTRACKERHIT,
                            "VTXCollectionName" , 
@@ -268,7 +265,12 @@ void FPCCDDigitizer::modifyEvent( LCEvent * evt )
 
 /*===================area D1 end=============================================*/    
     
-    theData.packPixelHits( *fpccdDataVec );// Save _pxHits info in *LCCollectionVec ( in this case the elements of LCCollectionVec have LCGenericObject)
+    if( _compactPixelFormat ){
+      FPCCDPixelCodec::packPixelHits( theData, _nLayer, _maxLadder, _compactEdepStep*1e-6, *fpccdDataVec );
+    }
+    else{
+      theData.packPixelHits( *fpccdDataVec );// Save _pxHits info in *LCCollectionVec ( in this case the elements of LCCollectionVec have LCGenericObject)
+    }
     
     evt->addCollection( fpccdDataVec , _outColNameVTX ) ;
     if(_debug == 1){
@@ -284,11 +286,9 @@ void FPCCDDigitizer::makePixelHits(SimTrackerHitImpl *SimTHit,  FPCCDData &hitVe
 {//The type of FPCCDData is not Vector. So the word "&hitVec" is confusing. Pay attention to it. 
  //nth_simthit is the number of the element of STHcol. Namely, it is the nth_simthit of STHcol->getElementAt(nth_simthit).
  //This makes data remember which simthit a pixel hit is originated from. 
-  gear::Vector3D* HitPosInMokka = new gear::Vector3D(SimTHit->getPosition()[0],SimTHit->getPosition()[1],SimTHit->getPosition()[2]);
+  gear::Vector3D HitPosInMokka(SimTHit->getPosition()[0],SimTHit->getPosition()[1],SimTHit->getPosition()[2]);
   /************get basic info.**************/
   const gear::BField& gearBField = Global::GEAR->getBField();
-  double posphi = HitPosInMokka->phi();
-  if(HitPosInMokka->y()<0) posphi += 2*M_PI;
   int layer = 0 ; int ladderID = 0 ;
   const int cellId = SimTHit->getCellID0();
 
@@ -301,61 +301,54 @@ void FPCCDDigitizer::makePixelHits(SimTrackerHitImpl *SimTHit,  FPCCDData &hitVe
   }
   else{ layer = cellId  - 1 ; }
   /*********** check which ladder hit on*************************************/
-  if( !_ladder_Number_encoded_in_cellID ) {    ladderID = getLadderID( HitPosInMokka, layer); }
+  if( !_ladder_Number_encoded_in_cellID ) {    ladderID = getLadderID( &HitPosInMokka, layer); }
   _pixelSize = _pixelSizeVec[layer]; 
   /*********** get hit dir(mom) at hit points and other info.****************/
-  gear::Vector3D* MomAtHitPos = new gear::Vector3D(SimTHit->getMomentum()[0],SimTHit->getMomentum()[1],SimTHit->getMomentum()[2]);
-  double momphi = MomAtHitPos->phi();
-  if(MomAtHitPos->y()<0) momphi += 2*M_PI;
+  gear::Vector3D MomAtHitPos(SimTHit->getMomentum()[0],SimTHit->getMomentum()[1],SimTHit->getMomentum()[2]);
   gear::Vector3D origin;
-  gear::Vector3D bfield = gearBField.at(origin);
-  gear::Vector3D* BField = new gear::Vector3D(bfield.x(),bfield.y(),bfield.z());
+  gear::Vector3D BField = gearBField.at(origin);
   MCParticle* mcp = SimTHit -> getMCParticle();
   if( mcp == 0 ) return ;
   float charge = mcp->getCharge();
   /*********** get local pos and dir on each ladder **************************/
-  gear::Vector3D*      LocalHitPos = getLocalPos(HitPosInMokka, layer, ladderID);
-  gear::Vector3D* MomAtLocalHitPos = new gear::Vector3D(MomAtHitPos->x()*_geodata[layer].sinphi[ladderID]-MomAtHitPos->y()*_geodata[layer].cosphi[ladderID],
-                                                        MomAtHitPos->z(),
-                                                        MomAtHitPos->x()*_geodata[layer].cosphi[ladderID]+MomAtHitPos->y()*_geodata[layer].sinphi[ladderID]);
-  gear::Vector3D*      LocalBField = new gear::Vector3D( _geodata[layer].sinphi[ladderID]*BField->x()-_geodata[layer].cosphi[ladderID]*BField->y(),
-                                                         BField->z(),
-                                                         _geodata[layer].cosphi[ladderID]*BField->x()+_geodata[layer].sinphi[ladderID]*BField->y());
-  gear::Vector3D* PosOutFromLadder = new gear::Vector3D(0,0,0);
-  gear::Vector3D*    PosInToLadder = new gear::Vector3D(0,0,0);
+  gear::Vector3D      LocalHitPos = getLocalPos(&HitPosInMokka, layer, ladderID);
+  gear::Vector3D MomAtLocalHitPos(MomAtHitPos.x()*_geodata[layer].sinphi[ladderID]-MomAtHitPos.y()*_geodata[layer].cosphi[ladderID],
+                                  MomAtHitPos.z(),
+                                  MomAtHitPos.x()*_geodata[layer].cosphi[ladderID]+MomAtHitPos.y()*_geodata[layer].sinphi[ladderID]);
+  gear::Vector3D      LocalBField( _geodata[layer].sinphi[ladderID]*BField.x()-_geodata[layer].cosphi[ladderID]*BField.y(),
+                                   BField.z(),
+                                   _geodata[layer].cosphi[ladderID]*BField.x()+_geodata[layer].sinphi[ladderID]*BField.y());
+  gear::Vector3D PosOutFromLadder(0,0,0);
+  gear::Vector3D    PosInToLadder(0,0,0);
   /*********** get the intersections with the surface of sensitive region**********************/
-  if( sqrt(MomAtLocalHitPos->x()*MomAtLocalHitPos->x() + MomAtLocalHitPos->z()*MomAtLocalHitPos->z()) < _momCut*1e-03){ // transvers momentum criteria for helix approximation
+  if( sqrt(MomAtLocalHitPos.x()*MomAtLocalHitPos.x() + MomAtLocalHitPos.z()*MomAtLocalHitPos.z()) < _momCut*1e-03){ // transvers momentum criteria for helix approximation
     if( _debug == 1 ) cout << "========== Track of this hit is trated as a helix ==========" << endl;
-    getInOutPosOfHelixOnLadder(layer, PosOutFromLadder, PosInToLadder, LocalHitPos, MomAtLocalHitPos, LocalBField,charge);
+    getInOutPosOfHelixOnLadder(layer, &PosOutFromLadder, &PosInToLadder, &LocalHitPos, &MomAtLocalHitPos, &LocalBField,charge);
   }
   else{
-    getInOutPosOnLadder(layer, PosOutFromLadder,PosInToLadder,LocalHitPos,MomAtLocalHitPos); 
+    getInOutPosOnLadder(layer, &PosOutFromLadder,&PosInToLadder,&LocalHitPos,&MomAtLocalHitPos); 
     if(_debug == 1){
-    std::cout <<" layer  = " << layer << " : PosIntoLadder = "<< PosInToLadder->x() << "," << PosInToLadder->y() << "," << PosInToLadder->z() << std::endl;
-    std::cout <<" layer  = " << layer << " : PosOutFromLadder = "<< PosOutFromLadder->x() << "," << PosOutFromLadder->y() << "," << PosOutFromLadder->z() << std::endl;
+    std::cout <<" layer  = " << layer << " : PosIntoLadder = "<< PosInToLadder.x() << "," << PosInToLadder.y() << "," << PosInToLadder.z() << std::endl;
+    std::cout <<" layer  = " << layer << " : PosOutFromLadder = "<< PosOutFromLadder.x() << "," << PosOutFromLadder.y() << "," << PosOutFromLadder.z() << std::endl;
     }
   }
 
-  if( inSensitiveRegion( PosOutFromLadder, layer) && inSensitiveRegion( PosInToLadder, layer) ){ // check if the particle through the sensitive region.
+  if( inSensitiveRegion( &PosOutFromLadder, layer) && inSensitiveRegion( &PosInToLadder, layer) ){ // check if the particle through the sensitive region.
   
     /********* make new SimTrackerHit for seinsitive thickness of FPCCD***************/ 
     if(_modifySimTHit){
-      gear::Vector3D Path(PosOutFromLadder->x()-PosInToLadder->x(), PosOutFromLadder->y()-PosInToLadder->y(),
-                          PosOutFromLadder->z()-PosInToLadder->z()); 
+      gear::Vector3D Path(PosOutFromLadder.x()-PosInToLadder.x(), PosOutFromLadder.y()-PosInToLadder.y(),
+                          PosOutFromLadder.z()-PosInToLadder.z()); 
       double PathLength = Path.r();
-      makeNewSimTHit(SimTHit, LocalHitPos, MomAtLocalHitPos, layer, ladderID, PathLength);
+      makeNewSimTHit(SimTHit, &LocalHitPos, &MomAtLocalHitPos, layer, ladderID, PathLength);
     }
-    /******** get hit points incoming and outgoiong each pixel (@ edge of pixel)************/
-    std::vector<std::pair<const gear::Vector3D*,int> >EdgeOfPixel = getIntersectionOfTrkAndPix(layer,PosOutFromLadder,PosInToLadder);
-    /*********calculate length that particle pass through pixel & central point of pixel*********/
-    sort( EdgeOfPixel.begin(), EdgeOfPixel.end(), SortByPosX<std::pair<const gear::Vector3D*, int>, const gear::Vector3D*, int >() );
-    std::map< std::pair< int, int>*, double> pixel_local = getLocalPixel(SimTHit,EdgeOfPixel);
-    std::map< std::pair< int, int>*, double>::iterator i_pixel_local = pixel_local.begin();
+    /******** walk through the pixels between incoming and outgoing point, and calculate energy deposit in each pixel *********/
+    getLocalPixel(SimTHit, layer, PosInToLadder, PosOutFromLadder, _pixelDeposits);
     
-    while( i_pixel_local != pixel_local.end() ){
-      int    xiID = (*i_pixel_local).first->first;
-      int  zetaID = (*i_pixel_local).first->second;
-      float    dE = (float)(*i_pixel_local).second; //  [mm]   
+    for(unsigned int ipix=0; ipix<_pixelDeposits.size(); ipix++){
+      int    xiID = _pixelDeposits[ipix].xi;
+      int  zetaID = _pixelDeposits[ipix].zeta;
+      float    dE = (float)_pixelDeposits[ipix].edep; //  [GeV]   
       FPCCDPixelHit::HitQuality_t quality;
       if(_OccupancyStudy == 0){
 	     if( _isSignal && mcp->getParents().size() == 0 ){ quality = FPCCDPixelHit::kSingle; }
@@ -373,7 +366,6 @@ void FPCCDDigitizer::makePixelHits(SimTrackerHitImpl *SimTHit,  FPCCDData &hitVe
       hitVec.addPixelHit(aHit,quality);//The type of "hitVec" is FPCCDData.
       
       if(_debug == 1 ) aHit.print();
-      i_pixel_local++;
     }
   
   }
@@ -381,13 +373,6 @@ void FPCCDDigitizer::makePixelHits(SimTrackerHitImpl *SimTHit,  FPCCDData &hitVe
     if(_debug == 1) cout << "This particle didn't through the sensitive region." << endl;
   }
        
-  delete HitPosInMokka;
-  delete LocalHitPos;
-  delete MomAtLocalHitPos;
-  delete LocalBField;
-  delete PosOutFromLadder;
-  delete PosInToLadder;
-  
   return ;
 }
 
@@ -413,53 +398,56 @@ void FPCCDDigitizer::end(){
 // =====================================================================
 int FPCCDDigitizer::getLadderID(const gear::Vector3D* pos, const int layer){
   
-  std::cout << "layer is " << layer << std::endl;
-  double layerthickness = _geodata[layer].sthick;
-  double         radius = _geodata[layer].rmin+0.5*layerthickness;
-  int           nladder = _geodata[layer].nladder;
-  double           dphi = _geodata[layer].dphi;
-  double     offset_phi = _geodata[layer].phi0;
+  if(_debug == 1) std::cout << "layer is " << layer << std::endl;
+  const GeoData_t& geo = _geodata[layer];
+  double layerthickness = geo.sthick;
+  double         radius = geo.rmin+0.5*layerthickness;
+  int           nladder = geo.nladder;
   double         posphi = pos->phi();
   double           posR = pos->rho();
 
+  // Ladder j is accepted if posR*cos(posphi-phi_j)-radius is within +-layerthickness.
+  // This needs cos(posphi-phi_j) >= (radius-layerthickness)/posR, so only the ladders
+  // with phi_j inside that window around posphi are tested. The lowest accepted ladder
+  // is taken, as in a scan over all ladders.
   int ladderID = 50;
-  double local_phi = 50.;
-  for(int j=0; j<nladder; j++){
-    local_phi = posphi - dphi*j - offset_phi;
-    if((posR*cos(local_phi)-radius >= -layerthickness) && (posR*cos(local_phi)-radius <= layerthickness)){
-      ladderID = j;
-      break;
+  if( posR > radius-layerthickness ){
+    double window = ( radius-layerthickness > 0 ) ? acos( (radius-layerthickness)/posR ) : M_PI;
+    int kmin = (int)floor( (posphi-window-geo.phi0)/geo.dphi );
+    int kmax = (int)ceil( (posphi+window-geo.phi0)/geo.dphi );
+    if( kmax-kmin >= nladder ) kmax = kmin+nladder-1;
+    for(int k=kmin; k<=kmax; k++){
+      int j = ( (k%nladder)+nladder )%nladder;
+      if( j >= ladderID ) continue;
+      double local_phi = posphi - geo.dphi*j - geo.phi0;
+      if((posR*cos(local_phi)-radius >= -layerthickness) && (posR*cos(local_phi)-radius <= layerthickness)){
+        ladderID = j;
+      }
     }
   }
-  if(ladderID>100) cout << "LADDERID>100!: " << ladderID << endl;
-  local_phi = posphi - dphi*(ladderID+1) - offset_phi;
-  if((posR*cos(local_phi)-radius >= -layerthickness) && (posR*cos(local_phi)-radius <= layerthickness)){
-    ladderID++;
-  }
   if(ladderID==50){
-    for(int j=0; j<nladder; j++){
-      local_phi = posphi - dphi*j - offset_phi;
-      if((posR*cos(local_phi)-radius >= -1.*layerthickness) && (posR*cos(local_phi)-radius <= 1.*layerthickness)){
-        ladderID = j;
-        break;
-      }
+    cout << "LADDERID==50!" << endl;
+    return ladderID;
+  }
+  // in the overlap region of two neighbouring ladders prefer the second one
+  if( ladderID+1 < nladder ){
+    double local_phi = posphi - geo.dphi*(ladderID+1) - geo.phi0;
+    if((posR*cos(local_phi)-radius >= -layerthickness) && (posR*cos(local_phi)-radius <= layerthickness)){
+      ladderID++;
     }
   }
-  if(ladderID==50) cout << "LADDERID==50!" << endl;
-  if(ladderID>100) cout << "LADDERID>100!..." << ladderID << endl;
   
   return ladderID;
 }
 
 // =====================================================================
-gear::Vector3D* FPCCDDigitizer::getLocalPos(const gear::Vector3D* pos, const int layer, const int ladder){
-  double   posR = pos->rho();
-  double posphi = pos->phi();
+gear::Vector3D FPCCDDigitizer::getLocalPos(const gear::Vector3D* pos, const int layer, const int ladder){
   double radius = _geodata[layer].rmin+0.5*_pixelheight + (layer%2)*(_geodata[layer].sthick-_pixelheight);
-  gear::Vector3D* LocalPos = new gear::Vector3D(
-     posR*(cos(posphi)*_geodata[layer].sinphi[ladder]-sin(posphi)*_geodata[layer].cosphi[ladder]),
+  // rotation with the cached cos/sin of the ladder phi
+  gear::Vector3D LocalPos(
+     pos->x()*_geodata[layer].sinphi[ladder]-pos->y()*_geodata[layer].cosphi[ladder],
      pos->z(),
-     posR*(cos(posphi)*_geodata[layer].cosphi[ladder]+sin(posphi)*_geodata[layer].sinphi[ladder])-radius
+     pos->x()*_geodata[layer].cosphi[ladder]+pos->y()*_geodata[layer].sinphi[ladder]-radius
   );
   return LocalPos;
 }
@@ -654,63 +642,9 @@ void FPCCDDigitizer::getInOutPosOfHelixOnLadder(int layer, gear::Vector3D* outpo
 }
 
 // =====================================================================
-std::vector<std::pair<const gear::Vector3D*, int> > FPCCDDigitizer::getIntersectionOfTrkAndPix(const int f_layer, gear::Vector3D* top,gear::Vector3D* bottom){
-  std::vector<std::pair<const gear::Vector3D*, int> > EdgeOfPixel;
-  double   sximin =  _geodata[f_layer].sximin;
-  double szetamin = -_geodata[f_layer].hlength;
-  double small_localx;
-  double large_localx;
-  double small_localy;
-  double large_localy;
-  if(top->x()>=bottom->x()){ large_localx = top->x(); small_localx = bottom->x(); }
-  else { large_localx = bottom->x(); small_localx = top->x(); }
-  if(top->y()>=bottom->y()) {large_localy = top->y(); small_localy = bottom->y(); }
-  else { large_localy = bottom->y(); small_localy = top->y(); }
-  
-  
-  int sloopx = (int)ceil((small_localx-sximin)/_pixelSize) ;
-  int eloopx = (int)ceil((large_localx-sximin)/_pixelSize) - 1;
-  int sloopy = (int)ceil((small_localy-szetamin)/_pixelSize) ;
-  int eloopy = (int)ceil((large_localy-szetamin)/_pixelSize) - 1;
-
-  int nloopx = eloopx - sloopx + 1;
-  int nloopy = eloopy - sloopy + 1;
-  if(_debug  == 1){
-    std::cout << "check sximin,szetamin = " << sximin << " , " << szetamin << std::endl;
-    std::cout << "check small_localx, large_localx = " << small_localx << " , " << large_localx << std::endl;
-    std::cout << "check small_localy, large_localy = " << small_localy << " , " << large_localy << std::endl;
-    std::cout << "check sloopx, eloopx = " << sloopx << " , " << eloopx << std::endl;
-    std::cout << "check sloopy, eloopy = " << sloopy << " , " << eloopy << std::endl;
-    std::cout << "check nloopx, nloopy = " << nloopx << " , " << nloopy << std::endl;
-  }
-
-  for(int j=0; j<nloopx; j++){
-    double XEdgeOfPixelZ = ((top->z()-bottom->z())/(top->x()-bottom->x()))*(sximin+(sloopx+j)*_pixelSize-(top->x()+bottom->x())/2.)+(top->z()+bottom->z())/2.;
-    double XEdgeOfPixelX = sximin+(sloopx+j)*_pixelSize;
-    double XEdgeOfPixelY = ((top->y()-bottom->y())/(top->x()-bottom->x()))*(sximin+(sloopx+j)*_pixelSize-(top->x()+bottom->x())/2.)+(top->y()+bottom->y())/2.;
-    
-    gear::Vector3D* XEdgeOfPixel = new gear::Vector3D(XEdgeOfPixelX,XEdgeOfPixelY,XEdgeOfPixelZ);
-    EdgeOfPixel.push_back(std::pair<gear::Vector3D*,int>(XEdgeOfPixel,1));
-  }
-  for(int j=0; j<nloopy; j++){
-    double YEdgeOfPixelZ = ((top->z()-bottom->z())/(top->y()-bottom->y()))*(szetamin+(sloopy+j)*_pixelSize-(top->y()+bottom->y())/2.)+(top->z()+bottom->z())/2.;
-    double YEdgeOfPixelX = ((top->x()-bottom->x())/(top->y()-bottom->y()))*(szetamin+(sloopy+j)*_pixelSize-(top->y()+bottom->y())/2.)+(top->x()+bottom->x())/2.;
-    double YEdgeOfPixelY = szetamin+(sloopy+j)*_pixelSize;
+void FPCCDDigitizer::getLocalPixel(SimTrackerHitImpl* simthit, int f_layer, const gear::Vector3D& inpos, const gear::Vector3D& outpos, std::vector<FPCCDPixelDeposit_t>& deposits){
+  deposits.clear();
 
-    gear::Vector3D* YEdgeOfPixel = new gear::Vector3D(YEdgeOfPixelX,YEdgeOfPixelY,YEdgeOfPixelZ);
-    EdgeOfPixel.push_back(std::pair<gear::Vector3D*,int>(YEdgeOfPixel,2));
-  }
-  EdgeOfPixel.push_back(std::pair<gear::Vector3D*,int>(top,0));
-  EdgeOfPixel.push_back(std::pair<gear::Vector3D*,int>(bottom,0));
-  return EdgeOfPixel;
-}
-
-// =====================================================================
-std::map< pair<int, int>*, double> FPCCDDigitizer::getLocalPixel(SimTrackerHitImpl* simthit, vector<std::pair<const gear::Vector3D*,int> > edgeofpixel){
-  std::map<pair< int, int>*, double> pixel_local;
-  UTIL::BitField64 encoder( lcio::LCTrackerCellID::encoding_string() ) ;
-  encoder.setValue(simthit->getCellID0()) ;
-  int f_layer    = encoder[lcio::LCTrackerCellID::layer()] ;
   double dEdx = 0.0;
   if(_EL_almostOFF == false){
      dEdx = simthit->getEDep()*1e+9; // Energy deposit of 50um thickness ladder. [eV]
@@ -721,135 +655,56 @@ std::map< pair<int, int>*, double> FPCCDDigitizer::getLocalPixel(SimTrackerHitIm
          If you want to inspect position resolution of clusters with energy loss almost zero,
          set _EL_almostOff : true */ 
   }
-
-
   double path_length = simthit->getPathLength(); // Path length of 50um thickness ladder. [mm]
 
-  double   mpv = 0.;
-  double    dE = 0.;
-  double sigma = 0.;
-  std::vector<std::pair<const gear::Vector3D*,int> >::iterator nxt = edgeofpixel.begin();
-  while( nxt != edgeofpixel.end()-1 ){
-    std::vector<std::pair<const gear::Vector3D*,int> >::iterator fst = nxt;
-    nxt++;
-
-    double diffx = (*nxt).first->x() - (*fst).first->x();
-    double diffy = (*nxt).first->y() - (*fst).first->y();
-    double diffz = (*nxt).first->z() - (*fst).first->z();
-    double L_through_pixel = sqrt(diffx*diffx + diffy*diffy + diffz*diffz);
-
-    mpv = (dEdx/path_length)*L_through_pixel;
-    sigma = (_sigmaConst)*L_through_pixel;
-
-    dE = gRandom->Landau( mpv, sigma)*1e-9; // Energy deposit is smeared by Landau distribution. [GeV]
-
-    std::pair< int, int>* pixID = FindPixel((*fst),(*nxt),f_layer); // estimate central point of pixels 
-    pixel_local.insert(std::map< std::pair<int, int>*, double>::value_type( pixID, dE));
-  }
-  return pixel_local;
-}
-
-// =====================================================================
-std::pair< int, int>* FPCCDDigitizer::FindPixel(std::pair<const gear::Vector3D*,int> fst, std::pair<const gear::Vector3D*,int> nxt, int layer){
-
-  std::pair<int,int> fst_array[4] ;
-  std::pair<int,int> nxt_array[4] ;
-
-  makeCandidates(fst, fst_array, layer);    
-  makeCandidates(nxt, nxt_array, layer);
-  
-  std::pair<int,int>* pixID = new std::pair< int, int>(0,0);
-  for(int i=0; i<4; i++){
-    for(int j=0; j<4; j++){
-      if(fst_array[i].first >= 0 && fst_array[i] == nxt_array[j] ){
-        pixID->first = fst_array[i].first;
-        pixID->second = fst_array[i].second;
-        goto GotPixID;
-      }
-    }
-  }
- GotPixID:
-
-  return pixID;
-}
-// =====================================================================
-void FPCCDDigitizer::makeCandidates( std::pair<const gear::Vector3D*,int> edge, std::pair<int,int>* cand_array, int layer){
-
-  std::pair<int,int> candID1(-1,-1);
-  std::pair<int,int> candID2(-1,-1);
-  std::pair<int,int> candID3(-1,-1);
-  std::pair<int,int> candID4(-1,-1);
-
-  double hlength = _geodata[layer].hlength;
-  double sximin  = _geodata[layer].sximin;
-
-  double quotient_x = (edge.first->x()-sximin)/_pixelSize ;
-  double quotient_y = (edge.first->y()+hlength)/_pixelSize ;
-
-  double mergin = 1e-5;
-
-  switch(edge.second)
-    {
-    case 0 : // intersection with ladder surface.
-      candID1.first = (int)floor(quotient_x);
-      if     ( quotient_x - candID1.first < mergin/_pixelSize )     candID2.first = candID1.first - 1;
-      else if( quotient_x - candID1.first > 1 - mergin/_pixelSize ) candID2.first = candID1.first + 1;
-      else candID2.first = candID1.first;
-      
-      candID1.second = (int)floor(quotient_y);
-      if     ( quotient_y - candID1.second < mergin/_pixelSize )    candID2.second = candID1.second - 1;
-      else if( quotient_y - candID1.second > 1 - mergin/_pixelSize )candID2.second = candID1.second + 1;      
-      else candID2.second = candID1.second;
-      break;
-
-    case 1 : // intersection with pixel border in xi
-      candID1.first  = (int)floor(quotient_x + 0.5);
-      candID2.first  = candID1.first - 1;
-      candID1.second = (int)floor(quotient_y);
-      candID2.second = candID1.second;
-      
-      if     ( quotient_y - candID1.second < mergin/_pixelSize){
-        candID3.first  = candID1.first;
-        candID3.second = candID1.second - 1;
-        candID4.first  = candID2.first;
-        candID4.second = candID2.second - 1;
-      }
-      else if( quotient_y - candID1.second > 1 - mergin/_pixelSize){
-        candID3.first  = candID1.first;
-        candID3.second = candID1.second + 1;
-        candID4.first  = candID2.first;
-        candID4.second = candID2.second + 1;
+  double   sximin =  _geodata[f_layer].sximin;
+  double szetamin = -_geodata[f_layer].hlength;
+  int   nxipixel = (int)ceil((_geodata[f_layer].sximax-sximin)/_pixelSize);
+  int nzetapixel = (int)ceil(2*_geodata[f_layer].hlength/_pixelSize);
+
+  // Straight path p(t) = inpos + t*(outpos-inpos), 0<=t<=1, in units of pixels.
+  double x0 = (inpos.x()-sximin)/_pixelSize;
+  double y0 = (inpos.y()-szetamin)/_pixelSize;
+  double dx = (outpos.x()-inpos.x())/_pixelSize;
+  double dy = (outpos.y()-inpos.y())/_pixelSize;
+  double diffz = outpos.z()-inpos.z();
+  double length = sqrt(dx*dx*_pixelSize*_pixelSize + dy*dy*_pixelSize*_pixelSize + diffz*diffz);
+
+  // Parameter t of the next crossing of a pixel border in xi and in zeta, and the step between borders.
+  const double never = 2.0;
+  double tnextx = never, tdeltax = never;
+  double tnexty = never, tdeltay = never;
+  if( dx > 0 )      { tdeltax =  1/dx; tnextx = (floor(x0)+1-x0)/dx; }
+  else if( dx < 0 ) { tdeltax = -1/dx; tnextx = (ceil(x0)-1-x0)/dx; }
+  if( dy > 0 )      { tdeltay =  1/dy; tnexty = (floor(y0)+1-y0)/dy; }
+  else if( dy < 0 ) { tdeltay = -1/dy; tnexty = (ceil(y0)-1-y0)/dy; }
+
+  double t = 0;
+  while( t < 1 ){
+    double tnext = std::min( std::min(tnextx, tnexty), 1.0 );
+    if( tnext > t ){ // a corner crossing gives no segment
+      // The pixel is the one containing the middle of the segment
+      double tmid = 0.5*(t+tnext);
+      int xi   = std::max( 0, std::min( nxipixel-1,   (int)floor(x0+tmid*dx) ) );
+      int zeta = std::max( 0, std::min( nzetapixel-1, (int)floor(y0+tmid*dy) ) );
+
+      double L_through_pixel = (tnext-t)*length;
+      double   mpv = (dEdx/path_length)*L_through_pixel;
+      double sigma = (_sigmaConst)*L_through_pixel;
+      double    dE = gRandom->Landau( mpv, sigma)*1e-9; // Energy deposit is smeared by Landau distribution. [GeV]
+
+      if( !deposits.empty() && deposits.back().xi == xi && deposits.back().zeta == zeta ){
+        deposits.back().edep += dE;
       }
-      break;
-
-    case 2 : // intersection with pixel border in zeta
-      candID1.first  = (int)floor(quotient_x);
-      candID2.first  = candID1.first;
-      candID1.second = (int)floor(quotient_y + 0.5);
-      candID2.second = candID1.second - 1;
-
-      if     ( quotient_x - candID1.first < mergin/_pixelSize){
-        candID3.first  = candID1.first - 1;
-        candID3.second = candID1.second;
-        candID4.first  = candID2.first - 1;
-        candID4.second = candID2.second;
+      else{
+        FPCCDPixelDeposit_t deposit = { xi, zeta, dE };
+        deposits.push_back( deposit );
       }
-      else if( quotient_x - candID1.first > 1 - mergin/_pixelSize){
-        candID3.first  = candID1.first + 1;
-        candID3.second = candID1.second;
-        candID4.first  = candID2.first + 1;
-        candID4.second = candID2.second;
-      }break;
-
-    default :
-      if(_debug == 1) std::cout << "pixel candidates cannot found. : " << edge.second << std::endl;
-      break;
     }
-  *cand_array = candID1;
-  *(cand_array+1) = candID2;
-  *(cand_array+2) = candID3;
-  *(cand_array+3) = candID4;
-    
+    if( tnextx <= tnext ) tnextx += tdeltax;
+    if( tnexty <= tnext ) tnexty += tdeltay;
+    t = tnext;
+  }
   return ;
 }
 
@@ -0,0 +1,186 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+#include "FPCCDPixelCodec.h"
+#include "FPCCDPixelHit.h"
+#include "FPCCDData.h"
+
+#include <IMPL/LCGenericObjectImpl.h>
+#include <streamlog/streamlog.h>
+
+#include <cmath>
+#include <algorithm>
+
+using namespace lcio ;
+
+const std::string FPCCDPixelCodec::FormatParameter = "FPCCDPixelFormat";
+const std::string FPCCDPixelCodec::CompactFormat = "compact";
+
+namespace
+{
+  bool lessXiZeta( FPCCDPixelHit* a, FPCCDPixelHit* b )
+  {
+    if( a->getXiID() != b->getXiID() ) { return a->getXiID() < b->getXiID(); }
+    return a->getZetaID() < b->getZetaID();
+  }
+}
+
+// =====================================================================
+void FPCCDPixelCodec::ByteWriter::putByte( unsigned int byte )
+{
+  unsigned int shift = 8*(_nBytes%4);
+  if( shift == 0 ) { _words.push_back(0); }
+  _words.back() |= ( byte & 0xff ) << shift;
+  _nBytes++;
+}
+
+// =====================================================================
+void FPCCDPixelCodec::ByteWriter::putVarint( unsigned int value )
+{
+  while( value >= 0x80 ) {
+    putByte( ( value & 0x7f ) | 0x80 );
+    value >>= 7;
+  }
+  putByte( value );
+}
+
+// =====================================================================
+unsigned int FPCCDPixelCodec::ByteReader::getByte()
+{
+  unsigned int shift = 8*(_pos%4);
+  if( shift == 0 ) { _word = (unsigned int)_obj->getIntVal( _firstWord + _pos/4 ); }
+  _pos++;
+  return ( _word >> shift ) & 0xff;
+}
+
+// =====================================================================
+unsigned int FPCCDPixelCodec::ByteReader::getVarint()
+{
+  unsigned int value = 0;
+  unsigned int shift = 0;
+  unsigned int byte = 0;
+  do {
+    byte = getByte();
+    value |= ( byte & 0x7f ) << shift;
+    shift += 7;
+  } while( byte & 0x80 );
+  return value;
+}
+
+// =====================================================================
+bool FPCCDPixelCodec::isCompact( LCCollection &col )
+{
+  return col.getParameters().getStringVal( FormatParameter ) == CompactFormat;
+}
+
+// =====================================================================
+void FPCCDPixelCodec::packPixelHits( FPCCDData &pxHits, int nLayer, int maxLadder,
+                                     double edepStep, LCCollectionVec &col )
+{
+  col.parameters().setValue( FormatParameter, CompactFormat );
+
+  std::vector<FPCCDPixelHit*> hits;
+  std::vector<unsigned int> words;
+  for(int layer=0;layer<nLayer;layer++){
+    for(int ladder=0;ladder<maxLadder;ladder++){
+      hits.clear();
+      for(PixelHitMap_t::iterator it=pxHits.itBegin(layer, ladder);it!=pxHits.itEnd(layer, ladder);it++){
+        hits.push_back( (*it).second );
+      }
+      if( hits.empty() ) { continue; }
+      std::sort( hits.begin(), hits.end(), lessXiZeta );
+
+      words.clear();
+      ByteWriter out( words );
+      int prevXi = 0;
+      int prevZetaEnd = 0;  // zeta following the previous run in the same xi row
+      int prevOrderID = 0;
+      unsigned int i = 0;
+      while( i < hits.size() ) {
+        // Run of pixels with consecutive zeta
+        unsigned int j = i+1;
+        while( j < hits.size() && hits[j]->getXiID() == hits[i]->getXiID()
+               && hits[j]->getZetaID() == hits[j-1]->getZetaID()+1 ) { j++; }
+
+        int xi = hits[i]->getXiID();
+        int zeta = hits[i]->getZetaID();
+        if( xi != prevXi ) { prevZetaEnd = 0; }
+        out.putVarint( xi-prevXi );
+        out.putVarint( zeta-prevZetaEnd );
+        out.putVarint( j-i );
+
+        for(unsigned int k=i;k<j;k++){
+          FPCCDPixelHit *aHit = hits[k];
+          int nOrderID = aHit->getSizeOfOrderID();
+          out.putVarint( ( nOrderID << 2 ) | ( aHit->getQuality() & 0x3 ) );
+          out.putSigned( (int)std::floor( aHit->getEdep()/edepStep + 0.5 ) );
+          for(int io=0;io<nOrderID;io++){
+            int orderID = aHit->getOrderID(io);
+            out.putSigned( orderID-prevOrderID );
+            prevOrderID = orderID;
+          }
+        }
+        prevXi = xi;
+        prevZetaEnd = zeta + (j-i);
+        i = j;
+      }
+
+      LCGenericObjectImpl *obj = new LCGenericObjectImpl;
+      obj->setIntVal( 0, Version );
+      obj->setIntVal( 1, layer );
+      obj->setIntVal( 2, ladder );
+      obj->setIntVal( 3, hits.size() );
+      obj->setIntVal( 4, out.nBytes() );
+      for(unsigned int iw=0;iw<words.size();iw++){ obj->setIntVal( 5+iw, (int)words[iw] ); }
+      obj->setFloatVal( 0, edepStep );
+      col.addElement( obj );
+    }
+  }
+}
+
+// =====================================================================
+int FPCCDPixelCodec::unpackPixelHits( LCCollection &col, FPCCDData &pxHits )
+{
+  if( !isCompact( col ) ) { return pxHits.unpackPixelHits( col ); }
+
+  int nhit = 0;
+  for(int ie=0;ie<col.getNumberOfElements();ie++){
+    LCGenericObject *obj = dynamic_cast<LCGenericObject*>( col.getElementAt(ie) );
+    if( obj == 0 ) { continue; }
+    if( obj->getIntVal(0) != Version ) {
+      streamlog_out( ERROR ) << "FPCCDPixelCodec: unknown format version " << obj->getIntVal(0)
+                             << " in collection element " << ie << ", skipped" << std::endl;
+      continue;
+    }
+    int layer = obj->getIntVal(1);
+    int ladder = obj->getIntVal(2);
+    int npix = obj->getIntVal(3);
+    double edepStep = obj->getFloatVal(0);
+
+    ByteReader in( obj, 5 );
+    int xi = 0;
+    int zetaEnd = 0;
+    int orderID = 0;
+    int nread = 0;
+    while( nread < npix ) {
+      int dxi = in.getVarint();
+      if( dxi != 0 ) { xi += dxi; zetaEnd = 0; }
+      int zeta = zetaEnd + in.getVarint();
+      int nrun = in.getVarint();
+      for(int k=0;k<nrun;k++){
+        unsigned int word = in.getVarint();
+        FPCCDPixelHit::HitQuality_t quality = FPCCDPixelHit::HitQuality_t( word & 0x3 );
+        int nOrderID = word >> 2;
+        double edep = in.getSigned()*edepStep;
+        FPCCDPixelHit aHit(layer, ladder, xi, zeta+k, edep, quality, 0);
+        for(int io=0;io<nOrderID;io++){
+          orderID += in.getSigned();
+          aHit.setOrderID( orderID );
+        }
+        pxHits.addPixelHit( aHit, quality );
+      }
+      zetaEnd = zeta + nrun;
+      nread += nrun;
+    }
+    nhit += npix;
+  }
+  return nhit;
+}
@@ -2,6 +2,7 @@
 #include "anaPix.h"
 #include "FPCCDPixelHit.h"
 #include "FPCCDData.h"
+#include "FPCCDPixelCodec.h"
 
 #include <iostream>
 
@@ -188,7 +189,7 @@ void anaPix::processEvent( LCEvent * evt )
   }
   if( pHitCol != 0 ){    
     FPCCDData  theData(_nLayer, _maxLadder);  // prepare object to make pixelhits
-    int nhit = theData.unpackPixelHits(*pHitCol);
+    int nhit = FPCCDPixelCodec::unpackPixelHits(*pHitCol, theData);
     if( _debug == 1 ) { theData.dump(); }
     if( nhit > 0 ) {  // Output Trackhit, if there are pixel hits
       g_event = _nEvt;
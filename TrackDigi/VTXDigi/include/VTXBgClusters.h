@@ -94,6 +94,7 @@ class VTXBgClusters : public Processor {
   float _epi{}; //epitaxial thickness in unit of 50 um (standard thickness)
   float _pitch[6]{}; //pitch in um
   float _it[6]{}; //integration time in ns
+  double _smaHalf[6]{}; //half minor axis of the cluster ellipse in mm (per layer)
 
   //  gsl_rng * r ;
   VXDGeometry* _vxdGeo{};
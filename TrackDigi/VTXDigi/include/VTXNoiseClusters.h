@@ -26,6 +26,20 @@ using namespace marlin ;
 
 class VXDGeometry ;
 
+/** Helper struct for the noise clusters of one VXD layer: the ladder surface and the 
+ *  cluster shape library - the cluster size distribution (z, r-phi) of the layer's 
+ *  histogram tabulated as cumulative distribution over the histogram bins.
+ */
+struct NoiseClusterLayer{
+  double width{};
+  double length{};
+  double area{};   // area of one double ladder (+z and -z) in cm^2
+  int nLadders{};
+  std::vector<double> cdf{};       // cumulative probability of bin ( iZ + nZ*iRPhi ), nBins+1 entries 
+  std::vector<double> zEdges{};    // bin edges of the cluster size in z
+  std::vector<double> rphiEdges{}; // bin edges of the cluster size in r-phi
+};
+
 
 /** ======= VTXNoiseClusters ========== <br>
  * Adds random noise hits to collection of SimTrackerHits of the vertex detector.
@@ -34,6 +48,9 @@ class VXDGeometry ;
  * surface. An object of type VXDClusterParameters is added to every hit to describe the 
  * extension of the cluster on the ladder surface. 
  * The distribution of the cluster sizes is read from ROOT histograms - one per layer.
+ * The histograms and the ladder surfaces are tabulated in init() and the cluster sizes
+ * are sampled from these tables with the processor's random generator, so the 
+ * clusters are reproducible with the RandomSeed.
  * 
  * @param RootHistograms      root file name and histogram names (one per layer)
  * @param HitDensityPerLayer  hit densities (hits/cm^2) per VXD layer
@@ -82,6 +99,18 @@ class VTXNoiseClusters : public  Processor, public EventModifier{
 
  protected:
 
+  /** Tabulate the cluster size histogram and the ladder surface of every layer.
+   */
+  void buildClusterLibrary() ;
+
+  /** Sample the cluster size (z, r-phi) of the given layer from its cluster shape library.
+   */
+  void sampleClusterSize( const NoiseClusterLayer& layer, double& cluZ, double& cluRPhi ) ;
+
+  /** Create nHit noise clusters on the given ladder and add them to the collection.
+   */
+  void addNoiseClusters( LCCollection* col, int layerId, int ladderId, int nHit ) ;
+
   std::string _colNameVTX{};
   FloatVec _densities{};
   StringVec _rootNames{};
@@ -98,6 +127,9 @@ class VTXNoiseClusters : public  Processor, public EventModifier{
   std::vector<TH2F*> _hist{};
   TFile* _hfile{};
 
+  std::vector<NoiseClusterLayer> _layers{};
+  double _hgap{};
+
 #ifdef MARLIN_USE_AIDA
    Hist1DVec _hist1DVec{};
    Hist2DVec _hist2DVec{};
@@ -12,6 +12,8 @@
 /** Helper struct for VXD ladder geometry */
 struct VXDLadder{
   double phi{};   // phi of ladder - rotation araound z-axis
+  double cosPhi{}; // cached cos(phi) and sin(phi) of the rotation
+  double sinPhi{};
   gear::Vector3D trans{}; // translation after rotation
 //   CLHEP::Hep2Vector p0 ;  // 'left' end of ladder in r-phi
 //   CLHEP::Hep2Vector p1 ;  // 'right' end of ladder in r-phi
@@ -29,6 +31,10 @@ struct VXDLayer{
   double gap{};
   double ladderArea{};
   int nLadders{};
+  int nSectors{};
+  /** ladders (in increasing order) whose sensitive area overlaps the phi sector
+   *  [ k*2pi/nSectors , (k+1)*2pi/nSectors ) , with phi in [0,2pi) */
+  std::vector< std::vector<int> > sectorLadders{};
 };
 
 typedef std::vector< VXDLayer >  VXDLayers ;
@@ -86,6 +92,14 @@ protected:
   void init() ;
   VXDGeometry(){}
 
+  /** Return the ladder in the given layer that contains labPos, -1 if none.
+   *  Only the ladders of the phi sector of labPos are tested.
+   */
+  int findLadder( const gear::Vector3D& labPos, int layerID ) ;
+
+  /** Number of phi sectors per ladder used for the ladder lookup tables */
+  static const int _sectorsPerLadder = 4 ;
+
   gear::GearMgr* _gearMgr{};
   VXDLadders _vxdLadders{};
   VXDLayers  _vxdLayers{};
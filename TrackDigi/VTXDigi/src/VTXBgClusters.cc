@@ -112,6 +112,12 @@ void VTXBgClusters::init() {
     }
     std::cout << "------------MODIFIED mode for sensor--------------- " << std::endl;
   }
+
+  // the minor axis of the ellipse only depends on the layer
+  for(int i=0; i<6; i++) {
+    double sma = ( _mod==0 ? 3*_pitch[i] : 4*_pitch[i] ) ;
+    _smaHalf[i] = sma * ( 0.001 / 2. ) ; //in mm and half axis
+  }
 }
 
 void VTXBgClusters::processRunHeader( LCRunHeader*  /*run*/) { 
@@ -168,13 +174,9 @@ void VTXBgClusters::processEvent( LCEvent * evt ) {
         //calculate the two axis of the ellipse that approximate the cluster
         double effpl = SimTHit->getPathLength()*_epi; //effective path length on the ladder surface
 
-        double sma; //ellipse minor axis
-        if (_mod==0)
-          sma=3*_pitch[layerId];
-        else sma=4*_pitch[layerId];
+        double sma = _smaHalf[layerId]; //ellipse minor axis - in mm and half axis
 
         double SMA = ((int)(effpl*1000/_pitch[layerId] -1/4) +4)*_pitch[layerId]; //ellipse major axis - effpl in mm
-        sma*= (0.001 / 2.) ; //in mm and half axis
         SMA*= (0.001 / 2.) ; //in mm and half axis
 
  
@@ -182,6 +184,12 @@ void VTXBgClusters::processEvent( LCEvent * evt ) {
         gear::Vector3D pos(SimTHit->getPosition()[0],SimTHit->getPosition()[1],SimTHit->getPosition()[2]) ;
         int ladderId = (_vxdGeo->getLadderID(pos,layerId)).second;
 
+        if( ladderId < 0 ) {
+          streamlog_out( WARNING ) << " VTX hit outside sensitive : " << pos 
+                                   << " - no cluster parameters added " << std::endl ;
+          continue ;
+        }
+
        streamlog_out( DEBUG ) << " eff. path length : " << effpl 
                                << " SMA " << SMA 
                                << " sma " << sma 
@@ -193,13 +201,15 @@ void VTXBgClusters::processEvent( LCEvent * evt ) {
         //calculate the momentum of the hit in the ladder ref.syst.
         gear::Vector3D mom(SimTHit->getMomentum()[0],SimTHit->getMomentum()[1],SimTHit->getMomentum()[2]); 
         gear::Vector3D laddermom = _vxdGeo->lab2LadderDir(mom,layerId,ladderId) ;
-        double modladdermom = sqrt(laddermom[1]*laddermom[1]+laddermom[2]*laddermom[2]);
+        double invmodladdermom = 1. / sqrt(laddermom[1]*laddermom[1]+laddermom[2]*laddermom[2]);
+        double uy = laddermom[1]*invmodladdermom ;
+        double uz = laddermom[2]*invmodladdermom ;
 
         //calculate the direction of the SMA (which lays on the y-z plane)
-        gear::Vector3D dSMAladder(0,SMA*laddermom[1]/modladdermom,SMA*laddermom[2]/modladdermom);
+        gear::Vector3D dSMAladder(0,SMA*uy,SMA*uz);
 
         //calculate the direction of the sma (orthogonal to SMA on the y-z plane)
-        gear::Vector3D dsmaladder(0,sma*laddermom[2]/modladdermom,sma*laddermom[1]/modladdermom);
+        gear::Vector3D dsmaladder(0,sma*uz,sma*uy);
 
 //         //calculate the direction of the SMA in the lab frame
 //         gear::Vector3D dSMA = _vxdGeo->ladder2LabDir(dSMAladder,layerId,ladderId);
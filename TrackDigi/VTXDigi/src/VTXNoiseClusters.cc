@@ -27,6 +27,7 @@
 
 #include <cmath>
 #include <math.h>
+#include <algorithm>
 
 #include "TFile.h" 
 
@@ -102,7 +103,8 @@ void VTXNoiseClusters::init() {
   // ranlux algorithm of Lscher, which produces 'luxury random numbers'
   _rng = gsl_rng_alloc(gsl_rng_ranlxs2) ;
 
-  gsl_rng_default_seed = _ranSeed ;
+  // gsl_rng_default_seed is only read by gsl_rng_alloc, so the seed is set explicitly
+  gsl_rng_set( _rng , _ranSeed ) ;
 
 
 
@@ -167,6 +169,101 @@ void VTXNoiseClusters::init() {
     
   }
 
+  buildClusterLibrary() ;
+}
+
+
+void VTXNoiseClusters::buildClusterLibrary() { 
+
+  const gear::VXDParameters& gearVXD = Global::GEAR->getVXDParameters() ;
+  const gear::VXDLayerLayout& layerVXD = gearVXD.getVXDLayerLayout(); 
+
+  _hgap = gearVXD.getShellGap() / 2. ;
+
+  _layers.resize( layerVXD.getNLayers() ) ;
+
+  for(int i=0;i<layerVXD.getNLayers(); ++i ){
+
+    NoiseClusterLayer& lay = _layers[i] ;
+
+    // ------ ladder surface
+    lay.width    = layerVXD.getSensitiveWidth (i) ;
+    lay.length   = layerVXD.getSensitiveLength (i) ; 
+    lay.area     = 2 * lay.length * lay.width / 100. ;  // mm^2 to cm^2
+    lay.nLadders = layerVXD.getNLadders(i) ;
+
+    // ------ cluster shape library: cumulative distribution over the histogram bins
+    TH2F* h = _hist[i] ;
+
+    int nZ    = h->GetNbinsX() ;
+    int nRPhi = h->GetNbinsY() ;
+
+    lay.zEdges.resize( nZ + 1 ) ;
+    for(int iz=0 ; iz <= nZ ; ++iz )
+      lay.zEdges[iz] = h->GetXaxis()->GetBinLowEdge( iz + 1 ) ;
+
+    lay.rphiEdges.resize( nRPhi + 1 ) ;
+    for(int ir=0 ; ir <= nRPhi ; ++ir )
+      lay.rphiEdges[ir] = h->GetYaxis()->GetBinLowEdge( ir + 1 ) ;
+
+    lay.cdf.resize( nZ * nRPhi + 1 ) ;
+    lay.cdf[0] = 0. ;
+    for(int ir=0 ; ir < nRPhi ; ++ir ){
+      for(int iz=0 ; iz < nZ ; ++iz ){
+        int bin = iz + nZ * ir ;
+        lay.cdf[ bin + 1 ] = lay.cdf[ bin ] + h->GetBinContent( iz + 1 , ir + 1 ) ;
+      }
+    }
+
+    double sum = lay.cdf.back() ;
+    if( !( sum > 0. ) ) {
+      std::string mess(" empty cluster size histogram :") ;
+      mess +=  _rootNames[i+1] ;
+      throw Exception( mess ) ;
+    }
+    for(unsigned k=1 ; k < lay.cdf.size() ; ++k )
+      lay.cdf[k] /= sum ;
+    lay.cdf.back() = 1. ;
+
+    // ------ the noise hits are created inside the ladder surface, check the ladder
+    //        corners are sensitive once here instead of every created hit
+    for( int j=0 ; j < lay.nLadders ; j++ ) {
+      for( int c=0 ; c < 8 ; c++ ) {
+
+        double k1 = ( (c & 1) ? -0.499 : 0.499 ) ;
+        double k2 = ( (c & 2) ? -1. : 1. ) * ( (c & 4) ? 0.999 : 0.001 ) ;
+
+        gear::Vector3D lad( 0 , k1 * lay.width, k2 * lay.length + _hgap ) ;  
+        gear::Vector3D lab = _vxdGeo->ladder2LabPos( lad, i , j )  ;
+
+        if( ! gearVXD.isPointInSensitive( lab ) ){
+          streamlog_out( WARNING ) << " layer: " << i << " - ladder: " << j 
+                                   << " noise hits may be created outside sensitve volume, e.g. " 
+                                   << lab << std::endl ;
+          break ;
+        }
+      }
+    }
+  }
+}
+
+
+void VTXNoiseClusters::sampleClusterSize( const NoiseClusterLayer& lay, double& cluZ, double& cluRPhi ) { 
+
+  // same as TH2::GetRandom2(): find the bin, z is interpolated within the bin
+  // with the same random number and r-phi is uniform within the bin
+  double r1 = gsl_rng_uniform( _rng ) ;
+
+  int bin = ( std::upper_bound( lay.cdf.begin() , lay.cdf.end() , r1 ) - lay.cdf.begin() ) - 1 ;
+
+  int nZ = lay.zEdges.size() - 1 ;
+  int iz = bin % nZ ;
+  int ir = bin / nZ ;
+
+  cluZ    = lay.zEdges[iz] + ( lay.zEdges[iz+1] - lay.zEdges[iz] ) 
+    * ( r1 - lay.cdf[bin] ) / ( lay.cdf[bin+1] - lay.cdf[bin] ) ;
+
+  cluRPhi = lay.rphiEdges[ir] + ( lay.rphiEdges[ir+1] - lay.rphiEdges[ir] ) * gsl_rng_uniform( _rng ) ;
 }
 
 
@@ -220,108 +317,88 @@ void VTXNoiseClusters::modifyEvent( LCEvent * evt ) {
 //   //fg ++++++++++++++ test and debug code ++++++++++++++++++++++
   
 
-  //get VXD geometry info
-  const gear::VXDParameters& gearVXD = Global::GEAR->getVXDParameters() ;
-  const gear::VXDLayerLayout& layerVXD = gearVXD.getVXDLayerLayout(); 
-  
-
-  if( (unsigned) layerVXD.getNLayers() !=   _densities.size()  ){
+  if( _layers.size() !=   _densities.size()  ){
     
     
     streamlog_out( ERROR  ) << " *************************************************** " << std::endl 
                             << " wrong number of hit densities: " <<  _densities.size() 
-                            << " for " << layerVXD.getNLayers() << " VXD layers "
+                            << " for " << _layers.size() << " VXD layers "
                             << "  - do nothing ! " << std::endl 
                             << " *************************************************** " << std::endl  ;
     
     return ;
     
   }
-              
-  double hgap = 	gearVXD.getShellGap() / 2. ;
 
-  for( int i=0 ; i <  layerVXD.getNLayers() ; i++ ) {
+  for( unsigned i=0 ; i < _layers.size() ; i++ ) {
     
-    double 	width = layerVXD.getSensitiveWidth (i) ;
-    double 	len =   layerVXD.getSensitiveLength (i) ; 
+    const NoiseClusterLayer& lay = _layers[i] ;
 
-    // area of one double ladder (+z and -z)
-    double area = 2 * len * width / 100. ;  // mm^2 to cm^2
-    
-    int nLad  = layerVXD.getNLadders(i) ;
-    
-    for( int j=0 ; j < nLad ; j++ ) {
+    for( int j=0 ; j < lay.nLadders ; j++ ) {
 
-      int  nHit = gsl_ran_poisson( _rng ,  _densities[ i ] * area  ) ;
+      int  nHit = gsl_ran_poisson( _rng ,  _densities[ i ] * lay.area  ) ;
 
       streamlog_out( DEBUG ) << " layer: " << i << " - ladder: " << j 
                              << " density: " <<  _densities[ i ] 
-                             << " area: " <<   area
+                             << " area: " <<   lay.area
                              << " #hits: " << nHit 
                              << std::endl ;
 
-      for( int k=0 ; k< nHit ; k++){
+      addNoiseClusters( col, i, j, nHit ) ;
+    }
+  }
 
-        double  l1 = gsl_rng_uniform( _rng ) ;
-        double  l2 = gsl_rng_uniform( _rng ) ;
-       
-        // ------ compute a point on the ladder 
-        // - (x,y) origin is in the center of the ladder:
-        double k1 = 0.5 - l1 ; 
-        // - z origin is at z==0 in the lab
 
-        double k2 =  ( (k % 2) ?  -1. : 1. ) * l2 ; 
+  _nEvt ++ ;
+}
 
-        gear::Vector3D lad( 0 , k1 * width, k2 * len + hgap ) ;  
-        
-        gear::Vector3D lab = _vxdGeo->ladder2LabPos( lad, i , j )  ;
 
-        // double check if point is in sensitive
-        if( ! gearVXD.isPointInSensitive( lab ) ){
-          streamlog_out( WARNING ) << " created hit outside sensitve volume " << lab << std::endl ;
-        }        
-        
-        SimTrackerHitImpl *hit = new SimTrackerHitImpl() ;
+void VTXNoiseClusters::addNoiseClusters( LCCollection* col, int layerId, int ladderId, int nHit ) { 
 
-        double pos[3] = { lab[0] , lab[1] , lab[2]  } ;
+  const NoiseClusterLayer& lay = _layers[ layerId ] ;
 
-        hit->setPosition( pos ) ;
+  for( int k=0 ; k< nHit ; k++){
 
-        hit->setEDep( 0. ) ; // FIXME: which dedx should be used for noise hits 
+    double  l1 = gsl_rng_uniform( _rng ) ;
+    double  l2 = gsl_rng_uniform( _rng ) ;
+       
+    // ------ compute a point on the ladder 
+    // - (x,y) origin is in the center of the ladder:
+    double k1 = 0.5 - l1 ; 
+    // - z origin is at z==0 in the lab
 
-        //FIXME: encode a proper cellID
-        hit->setCellID0(  i + 1  ) ; // fg: here we'd like to have ladder id as well ....
+    double k2 =  ( (k % 2) ?  -1. : 1. ) * l2 ; 
 
+    gear::Vector3D lad( 0 , k1 * lay.width, k2 * lay.length + _hgap ) ;  
+        
+    gear::Vector3D lab = _vxdGeo->ladder2LabPos( lad, layerId , ladderId )  ;
 
-        // now we need to add some cluster parameters  to the hit :
-        double cluZ, cluRPhi ;
+    SimTrackerHitImpl *hit = new SimTrackerHitImpl() ;
 
+    double pos[3] = { lab[0] , lab[1] , lab[2]  } ;
 
-       _hist[i]->GetRandom2( cluZ, cluRPhi ) ;
-        
+    hit->setPosition( pos ) ;
 
-       // --- cluster axes in ladder frame
-       gear::Vector3D axisAlad( 0, cluRPhi/2. , 0    ) ;
-       gear::Vector3D axisBlad( 0,   0     , cluZ/2. ) ;
-       
-       // --- cluster axes in lab frame
-       //        gear::Vector3D axisAlab = _vxdGeo->ladder2LabDir( axisAlad , i , j )  ;
-       //        gear::Vector3D axisBlab = _vxdGeo->ladder2LabDir( axisBlad, i , j )  ;
-       
-       // hit position in ladder frame:
+    hit->setEDep( 0. ) ; // FIXME: which dedx should be used for noise hits 
 
-       
-       hit->ext< ClusterParams >() = new VXDClusterParameters( lad, axisAlad , axisBlad , i , j )  ;
+    //FIXME: encode a proper cellID
+    hit->setCellID0(  layerId + 1  ) ; // fg: here we'd like to have ladder id as well ....
 
 
-       col->addElement( hit ) ; 
-       
-      }
-    }
-  }
+    // now we need to add some cluster parameters  to the hit :
+    double cluZ, cluRPhi ;
 
+    sampleClusterSize( lay, cluZ, cluRPhi ) ;
 
-  _nEvt ++ ;
+    // --- cluster axes in ladder frame
+    gear::Vector3D axisAlad( 0, cluRPhi/2. , 0    ) ;
+    gear::Vector3D axisBlad( 0,   0     , cluZ/2. ) ;
+       
+    // hit position in ladder frame:
+    hit->ext< ClusterParams >() = new VXDClusterParameters( lad, axisAlad , axisBlad , layerId , ladderId )  ;
+
+    col->addElement( hit ) ; 
+  }
 }
 
 
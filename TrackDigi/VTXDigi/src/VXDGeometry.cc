@@ -131,53 +131,129 @@ void VXDGeometry::init() {
       
       VXDLadder& l = _vxdLadders[i][j] ;
       l.phi = phi ;
+      l.cosPhi = std::cos( phi ) ;
+      l.sinPhi = std::sin( phi ) ;
       l.trans = t0 + t1  ;
 
     }
+
+    // phi sector table: for every sector the ladders whose sensitive area
+    // (in r-phi) overlaps it, computed from the phi range of the ladder corners
+    int nSec = _sectorsPerLadder * nLad ;
+    double secWidth = 2. * M_PI / nSec ;
+
+    _vxdLayers[i].nSectors = nSec ;
+    _vxdLayers[i].sectorLadders.assign( nSec , std::vector<int>() ) ;
+
+    for( int j=0 ; j < nLad ; j++ ) {
+
+      double phiMin =  M_PI ;
+      double phiMax = -M_PI ;
+
+      for( int k=0 ; k < 4 ; k++ ) {
+
+        gear::Vector3D corner( ( k & 1 ? 0.5 : -0.5 ) * thick , 
+                               ( k & 2 ? 0.5 : -0.5 ) * width , 
+                               0. ) ;
+
+        double dphi = ladder2LabPos( corner, i, j ).phi() - _vxdLadders[i][j].phi ;
+        dphi = std::remainder( dphi , 2. * M_PI ) ;
+
+        if( dphi < phiMin ) phiMin = dphi ;
+        if( dphi > phiMax ) phiMax = dphi ;
+      }
+
+      // small margin for rounding at the sector boundaries
+      const double margin = 1e-9 ;
+      int kMin = (int) std::floor( ( _vxdLadders[i][j].phi + phiMin - margin ) / secWidth ) ;
+      int kMax = (int) std::floor( ( _vxdLadders[i][j].phi + phiMax + margin ) / secWidth ) ;
+
+      for( int k = kMin ; k <= kMax ; k++ ) {
+        
+        std::vector<int>& sec = _vxdLayers[i].sectorLadders[ ( ( k % nSec ) + nSec ) % nSec ] ;
+        
+        if( sec.empty() || sec.back() != j ) 
+          sec.push_back( j ) ;
+      }
+    }
   }
 }
 
 
 gear::Vector3D VXDGeometry::lab2LadderPos( gear::Vector3D labPos, int layerID, int ladderID) {
   
-  gear::Vector3D u = labPos -  _vxdLadders[layerID][ladderID].trans ;
+  const VXDLadder& l = _vxdLadders[layerID][ladderID] ;
+
+  double ux = labPos.x() - l.trans.x() ;
+  double uy = labPos.y() - l.trans.y() ;
   
-  return gear::Vector3D( u.rho(), 
-                         u.phi() - _vxdLadders[layerID][ladderID].phi, 
-                         u.z(),  
-                         gear::Vector3D::cylindrical ) ;
+  return gear::Vector3D(  l.cosPhi * ux + l.sinPhi * uy , 
+                         -l.sinPhi * ux + l.cosPhi * uy , 
+                          labPos.z() - l.trans.z() ) ;
 }
 
 gear::Vector3D VXDGeometry::ladder2LabPos( gear::Vector3D ladderPos, int layerID, int ladderID){
 
-  gear::Vector3D r( ladderPos.rho(), 
-                    ladderPos.phi() + _vxdLadders[layerID][ladderID].phi, 
-                    ladderPos.z(),  
-                    gear::Vector3D::cylindrical ) ;
+  const VXDLadder& l = _vxdLadders[layerID][ladderID] ;
 
-  return r + _vxdLadders[layerID][ladderID].trans ;
+  return gear::Vector3D( l.cosPhi * ladderPos.x() - l.sinPhi * ladderPos.y() + l.trans.x() , 
+                         l.sinPhi * ladderPos.x() + l.cosPhi * ladderPos.y() + l.trans.y() , 
+                         ladderPos.z() + l.trans.z() ) ;
 
 }
 
 gear::Vector3D VXDGeometry::lab2LadderDir( gear::Vector3D labDir, int layerID, int ladderID) {
   
-  return gear::Vector3D( labDir.rho(), 
-                         labDir.phi() - _vxdLadders[layerID][ladderID].phi, 
-                         labDir.z(),  
-                         gear::Vector3D::cylindrical ) ;
+  const VXDLadder& l = _vxdLadders[layerID][ladderID] ;
+
+  return gear::Vector3D(  l.cosPhi * labDir.x() + l.sinPhi * labDir.y() , 
+                         -l.sinPhi * labDir.x() + l.cosPhi * labDir.y() , 
+                          labDir.z() ) ;
 }
 
 gear::Vector3D VXDGeometry::ladder2LabDir( gear::Vector3D ladderDir, int layerID, int ladderID){
 
-  return gear::Vector3D( ladderDir.rho(), 
-                         ladderDir.phi() + _vxdLadders[layerID][ladderID].phi, 
-                         ladderDir.z(),  
-                         gear::Vector3D::cylindrical ) ;
+  const VXDLadder& l = _vxdLadders[layerID][ladderID] ;
+
+  return gear::Vector3D( l.cosPhi * ladderDir.x() - l.sinPhi * ladderDir.y() , 
+                         l.sinPhi * ladderDir.x() + l.cosPhi * ladderDir.y() , 
+                         ladderDir.z() ) ;
   
 }
   
 
  
+int VXDGeometry::findLadder( const gear::Vector3D& labPos, int layerID ) {
+
+  const VXDLayer& lay = _vxdLayers[layerID] ;
+
+  double phi = labPos.phi() ;
+  if( phi < 0. ) phi += 2. * M_PI ;
+
+  int k = (int) ( phi * lay.nSectors / ( 2. * M_PI ) ) ;
+  if( k >= lay.nSectors ) k = lay.nSectors - 1 ;
+
+  const std::vector<int>& sec = lay.sectorLadders[k] ;
+
+  for(unsigned n = 0 ; n < sec.size() ;  ++n ) { // check the ladders of this sector
+    
+    int j = sec[n] ;
+
+    gear::Vector3D l = lab2LadderPos( labPos , layerID , j ) ;
+    
+    double z_abs = std::abs( l.z() ) - lay.gap / 2. ;
+    
+    if( ( 0 < z_abs && z_abs < lay.length         ) && 
+        ( std::abs( l.y() )  < lay.width / 2.     ) && 
+        ( std::abs( l.x() )  < lay.thickness / 2. )    ) {
+      
+      return j ;
+    }
+  }
+  return -1 ;
+}
+
+ 
 std::pair<int,int> VXDGeometry::getLadderID( gear::Vector3D labPos, int layerID ) {
   
   if( layerID < 0 ) { // need to search the layer first.... 
@@ -189,43 +265,16 @@ std::pair<int,int> VXDGeometry::getLadderID( gear::Vector3D labPos, int layerID
       
       if( _vxdLayers[i].rMin <= r && r <= _vxdLayers[i].rMax ) { // candidate layer
         
-        //        bool isSensitive = false ;
-        unsigned m = _vxdLadders[i].size() ;
+        int j = findLadder( labPos , i ) ;
 
-        for(unsigned j = 0 ; j < m ;  ++j ) { // check 
-          
-          gear::Vector3D l = lab2LadderPos( labPos , i , j ) ;
-          
-          double z_abs = std::abs( l.z() ) - _vxdLayers[i].gap / 2. ;
-          
-          if( ( 0 < z_abs && z_abs < _vxdLayers[i].length         ) && 
-              ( std::abs( l.y() )  < _vxdLayers[i].width / 2.     ) && 
-              ( std::abs( l.x() )  < _vxdLayers[i].thickness / 2. )    ) {
-            
-            return std::make_pair(  i , j )  ;
-          }
-        }
+        if( j >= 0 ) 
+          return std::make_pair(  i , j )  ;
       }
     }
     return std::make_pair(  -1, -1  )  ;
   }
 
-  unsigned m = _vxdLadders[layerID].size() ;
-  
-  for(unsigned j = 0 ; j < m ;  ++j ) { // check 
-    
-    gear::Vector3D l = lab2LadderPos( labPos , layerID , j ) ;
-    
-    double z_abs = std::abs( l.z() ) - _vxdLayers[layerID].gap / 2. ;
-    
-    if( ( 0 < z_abs && z_abs < _vxdLayers[layerID].length         ) && 
-        ( std::abs( l.y() )  < _vxdLayers[layerID].width / 2.     ) && 
-        ( std::abs( l.x() )  < _vxdLayers[layerID].thickness / 2. )    ) {
-      
-      return std::make_pair( layerID , j )  ;
-    }
-  }
-  return std::make_pair(  layerID , -1  )  ;
+  return std::make_pair( layerID , findLadder( labPos , layerID ) )  ;
 }
   
 
@@ -7,6 +7,7 @@
 #include <vector>
 #include "TrackPair.h"
 #include "HelixClass.h"
+#include "TrackPairEngine.h"
 
 using namespace lcio ;
 using namespace marlin ;
@@ -80,6 +81,9 @@ using namespace marlin ;
  *  (default value 0.2 GeV) <br>
  *  @param SplitTrackMaxFracDeltaP maximum fractional difference in momentum of split track segments <br>
  *  (default value 0.02) <br>
+ *  @param NumberOfThreads number of threads used to compute the closest approach <br>
+ *  of the candidate track pairs <br>
+ *  (default value 1) <br>
  *  @author M. Thomson, DESY
  */
 
@@ -99,6 +103,21 @@ typedef struct {
   int   pdgCode;
 } twoTrackIntersection_t;
 
+typedef struct {
+  int   tracki;
+  int   trackj;
+  int   parent;     // track whose end helix meets the start helix of the daughter
+  int   daughter;
+  bool  flipped;
+  bool  mcKink;
+  float zs;         // z range between the two track ends
+  float ze;
+  float deltaz;
+  float deltar;
+  float deltarxy;
+  float rendi;
+} kinkCandidate_t;
+
 
 /** KinkFinder Processor <br>
  *  KinkFinder processor identify kinked tracks <br>
@@ -171,6 +190,10 @@ class KinkFinder : public Processor {
   int   _nLayersVTX{};
   std::vector<float> _rSIT{};
   std::vector<float> _rVTX{};
+  float _maxDeltaRxy{};
+
+  int _nThreads{};
+  TrackPairEngine _pairEngine{};
 
 
 } ;
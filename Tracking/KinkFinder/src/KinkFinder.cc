@@ -10,6 +10,7 @@
 #include "IMPL/ReconstructedParticleImpl.h"
 #include "IMPL/VertexImpl.h"
 #include <math.h>
+#include <algorithm>
 
 #include <DD4hep/Detector.h>
 #include <DD4hep/DD4hepUnits.h>
@@ -173,6 +174,11 @@ KinkFinder::KinkFinder() : Processor("KinkFinder") {
 			     float(2.));
 
 
+  registerProcessorParameter("NumberOfThreads",
+			     "Number of threads used to compute the closest approach of the candidate track pairs",
+			     _nThreads,
+			     int(1));
+
   registerProcessorParameter("DebugPrinting",
 			     "Debug level",
 			     _debugPrinting,
@@ -217,6 +223,21 @@ void KinkFinder::init() {
     _rSIT.push_back( sit->layers[iL].distanceSensitive );
   }
 
+  // Largest separation in r of the parent and daughter track ends accepted by
+  // the kink selection (twice the largest deltaRxy cut), used to find the
+  // candidate daughters of a track
+  float maxDeltaRxyCut = 2.0*(_tpcOuterR-_tpcInnerR)/_tpcMaxRow*_maxDeltaTpcLayers;
+  if(_nLayersSIT>0 && _nLayersVTX>0){
+    maxDeltaRxyCut = std::max(maxDeltaRxyCut, _rSIT[0]-_rVTX[_nLayersVTX-1]);
+    maxDeltaRxyCut = std::max(maxDeltaRxyCut, _tpcInnerR-_rSIT[_nLayersSIT-1]);
+    maxDeltaRxyCut = std::max(maxDeltaRxyCut, *std::max_element(_rSIT.begin(),_rSIT.end())-
+			                      *std::min_element(_rSIT.begin(),_rSIT.end()));
+    maxDeltaRxyCut = std::max(maxDeltaRxyCut, 10.f);
+  }
+  _maxDeltaRxy = 2*1.1*maxDeltaRxyCut;
+
+  _pairEngine.setNumberOfThreads(_nThreads);
+
 
   _nRun = -1;
   _nEvt = 0;
@@ -284,6 +305,9 @@ void KinkFinder::processEvent( LCEvent * evt ) {
   std::vector< std::vector<twoTrackIntersection_t> > splitDaughters( tracks.size() ) ;
   std::vector< float> zAtEnd(  tracks.size() );
   std::vector< float> zAtStart(tracks.size() );
+  std::vector<TrackHelix> trackHelixEnd(  tracks.size() );
+  std::vector<TrackHelix> trackHelixStart(tracks.size() );
+  std::vector<kinkCandidate_t> kinkCandidates;
 
   for(unsigned int  itrack=0;itrack< tracks.size();++itrack){
     TrackerHitVec hitvec = tracks[itrack]->getTrackerHits();
@@ -450,6 +474,7 @@ void KinkFinder::processEvent( LCEvent * evt ) {
     helixStart[itrack]->Initialize_BZ(x0, y0, r0, 
 			 bz, phiH, _bField,signPz,
 			 zBegin);
+    trackHelixStart[itrack].Initialize(*helixStart[itrack]);
 
 
     float seeds[3];
@@ -477,6 +502,7 @@ void KinkFinder::processEvent( LCEvent * evt ) {
     helixEnd[itrack]->Initialize_BZ(x0, y0, r0, 
 			 bz, phiH, _bField,signPz,
 			 zEnd);
+    trackHelixEnd[itrack].Initialize(*helixEnd[itrack]);
 
     delete[] xh;
     delete[] yh;
@@ -485,27 +511,62 @@ void KinkFinder::processEvent( LCEvent * evt ) {
 
   }
 
+  // Track end points ordered in r: a daughter starts close in r to the end of
+  // its parent (the inner radius of the daughter is close to the outer radius
+  // of the parent, or for a flipped daughter its outer radius is close to the
+  // inner radius of the parent)
+  std::vector< std::pair<float,int> > innerIndex;
+  std::vector< std::pair<float,int> > outerIndex;
+  for(unsigned int itrack=0;itrack< tracks.size();++itrack){
+    innerIndex.push_back( std::make_pair(rInner[itrack],int(itrack)) );
+    outerIndex.push_back( std::make_pair(rOuter[itrack],int(itrack)) );
+  }
+  std::sort(innerIndex.begin(),innerIndex.end());
+  std::sort(outerIndex.begin(),outerIndex.end());
+
+  // Helices of the track start (2*i) and end (2*i+1) in the pair engine
+  _pairEngine.clear();
+  for(unsigned int itrack=0;itrack< tracks.size();++itrack){
+    _pairEngine.addHelix( trackHelixStart[itrack] );
+    _pairEngine.addHelix( trackHelixEnd[itrack] );
+  }
+
+  // MC kinks are studied for any pair of tracks
+  bool allPairs = trackNavigator!=NULL && _debugPrinting>0;
+  std::vector<int> partners;
+
   for(unsigned int i=0;i< tracks.size();++i){ 
 //    Track* tracki = tracks[i];
 //    float d0i = tracki->getD0();
 //    float z0i = tracki->getZ0();
     if(hits[i]>=_minTrackHits){
       float seedi[3];
-      float refe[3];
       float z = zAtEnd[i];
-      refe[0]  = helixEnd[i]->getReferencePoint()[0];
-      refe[1]  = helixEnd[i]->getReferencePoint()[1];
-      refe[2]  = helixEnd[i]->getReferencePoint()[2];
-      helixEnd[i]->getPointInZ(z, refe, seedi);
+      trackHelixEnd[i].getPoint(trackHelixEnd[i].getPhiInZ(z), seedi);
       float rendi = sqrt(seedi[0]*seedi[0]+seedi[1]*seedi[1]);
-      for(unsigned int  j=0;j< tracks.size();++j){
+
+      // tracks which can pass the deltaRxy cut with track i as the parent
+      partners.clear();
+      if(allPairs){
+	for(unsigned int j=0;j< tracks.size();++j)partners.push_back(j);
+      }else{
+	std::vector< std::pair<float,int> >::const_iterator it;
+	it = std::lower_bound(innerIndex.begin(),innerIndex.end(),std::make_pair(rOuter[i]-_maxDeltaRxy,-1));
+	for(;it!=innerIndex.end() && it->first<=rOuter[i]+_maxDeltaRxy;++it)partners.push_back(it->second);
+	it = std::lower_bound(outerIndex.begin(),outerIndex.end(),std::make_pair(rInner[i]-_maxDeltaRxy,-1));
+	for(;it!=outerIndex.end() && it->first<=rInner[i]+_maxDeltaRxy;++it)partners.push_back(it->second);
+	std::sort(partners.begin(),partners.end());
+	partners.erase(std::unique(partners.begin(),partners.end()),partners.end());
+      }
+
+      for(unsigned int ipartner=0;ipartner<partners.size();++ipartner){
+	unsigned int j = partners[ipartner];
 	if(i!=j && hits[j]>_minTrackHits && momentum[j] < (1.0 + _maxSplitTrackFracDeltaP)*momentum[i]){
 //	  Track* trackj = tracks[j];
 //        float d0j = trackj->getD0();
 //	  float z0j = trackj->getZ0();
 	  if(rInner[i]>_rKinkCut || rInner[j]>_rKinkCut){
 	    float seedj[3];
-	    float refs[3];
 	    float deltaz;
 	    float ddx;
 	    float ddy;
@@ -521,10 +582,7 @@ void KinkFinder::processEvent( LCEvent * evt ) {
 	      // normal kink where both tracks propagate outwards
 	      ip = i;
 	      id = j;
-	      refs[0]  = helixStart[j]->getReferencePoint()[0];
-	      refs[1]  = helixStart[j]->getReferencePoint()[1];
-	      refs[2]  = helixStart[j]->getReferencePoint()[2];
-	      helixStart[j]->getPointInZ(z, refs, seedj);
+	      trackHelixStart[j].getPoint(trackHelixStart[j].getPhiInZ(z), seedj);
 	      deltaz =  zAtEnd[i] - zAtStart[j];
 	      ddx = (zout[i].x-zin[j].x);
 	      ddy = (zout[i].y-zin[j].y);
@@ -540,10 +598,7 @@ void KinkFinder::processEvent( LCEvent * evt ) {
 	      flipped = true;
 	      ip = j;
 	      id = i;
-	      refs[0]  = helixEnd[j]->getReferencePoint()[0];
-	      refs[1]  = helixEnd[j]->getReferencePoint()[1];
-	      refs[2]  = helixEnd[j]->getReferencePoint()[2];
-	      helixEnd[j]->getPointInZ(z, refs, seedj);	      
+	      trackHelixEnd[j].getPoint(trackHelixEnd[j].getPhiInZ(z), seedj);
 	      deltaz =  zAtEnd[i] - zAtEnd[j];
 	      ddx = (zout[i].x-zout[j].x);
 	      ddy = (zout[i].y-zout[j].y);
@@ -558,11 +613,6 @@ void KinkFinder::processEvent( LCEvent * evt ) {
 	    float dz = seedi[2]-seedj[2];
 	    float dr = sqrt(dx*dx+dy*dy+dz*dz);
 	    
-	    float xkink = 0;
-	    float ykink = 0;
-	    float zkink = 0;
-	    float rkink = 0;
-
 
 	    bool mcKink = false;
 	    if(mcParticle[j]!=NULL && _debugPrinting>0){
@@ -589,327 +639,360 @@ void KinkFinder::processEvent( LCEvent * evt ) {
 	  
 	  
 
+	    // the kink point needs the closest approach of the parent end and
+	    // daughter start helices, pairs without it can't pass the cuts
 	    if(dr<100 || mcKink){
-	      dr = 999999.;
-	      float refsp[3];
-	      float refsd[3];
-	      refsp[0]  = helixEnd[ip]->getReferencePoint()[0];
-	      refsp[1]  = helixEnd[ip]->getReferencePoint()[1];
-	      refsp[2]  = helixEnd[ip]->getReferencePoint()[2];
-	      refsd[0]  = helixStart[id]->getReferencePoint()[0];
-	      refsd[1]  = helixStart[id]->getReferencePoint()[1];
-	      refsd[2]  = helixStart[id]->getReferencePoint()[2];
-	      float seedp[3];
-	      float seedd[3];
 	      float zs = z1;
 	      float ze = z2;
 	      if(z2 < z1){
 		zs = z2;
 		ze = z1;
 	      }
-	      float zstep = (ze-zs)/10.;
-	      if(zstep<1)zstep=1;
-	      
-	      for(float zf = zs; zf < ze; zf+= zstep){
-		helixEnd[ip]->getPointInZ(zf, refsp, seedp);
-		helixStart[id]->getPointInZ(zf, refsd, seedd);
- 		float dxf = seedp[0]-seedd[0];
-		float dyf = seedp[1]-seedd[1];
-		float dzf = seedp[2]-seedd[2];
-		float newdr = sqrt(dxf*dxf+dyf*dyf+dzf*dzf);
-		if(newdr<dr){
-		  dr=newdr;
-		  xkink = (seedp[0]+seedd[0])/2;
-		  ykink = (seedp[1]+seedd[1])/2;
-		  rkink = sqrt(xkink*xkink+ykink*ykink);
-		  zkink = zf;
-		  if(rkink<rOuter[i])rkink=rOuter[i];
-		  if(rkink>rInner[j])rkink=rInner[j];
-		}
-	      }
+	      kinkCandidate_t cand;
+	      cand.tracki   = i;
+	      cand.trackj   = j;
+	      cand.parent   = ip;
+	      cand.daughter = id;
+	      cand.flipped  = flipped;
+	      cand.mcKink   = mcKink;
+	      cand.zs       = zs;
+	      cand.ze       = ze;
+	      cand.deltaz   = deltaz;
+	      cand.deltar   = deltar;
+	      cand.deltarxy = deltarxy;
+	      cand.rendi    = rendi;
+	      kinkCandidates.push_back(cand);
+	      _pairEngine.addPair(2*ip+1, 2*id,
+				  trackHelixEnd[ip].getPhiInZ(0.5*(zs+ze)),
+				  trackHelixStart[id].getPhiInZ(0.5*(zs+ze)));
 	    }
-	    
-	    bool  ok = true;
-	    if(fabs(deltaz)>200)ok=false;
-	    if(fabs(deltaz)>100 && dr > 5.0)ok=false;
-	    
-	    float deltaRxyCut = -100;
-	    float drCut   = -100;
+	  }
+	}
+      }
+    }
+  }
+
+  // Closest approach of the candidate pairs (in parallel for NumberOfThreads>1)
+  _pairEngine.evaluate();
+
+  // Kink, prong and split hypotheses, in the order of the track pairs
+  _pairEngine.process( [&](const TrackPairResult & pair) {
+
+    const kinkCandidate_t & cand = kinkCandidates[pair.index];
+    unsigned int i  = cand.tracki;
+    unsigned int j  = cand.trackj;
+    bool flipped    = cand.flipped;
+    bool mcKink     = cand.mcKink;
+    float deltaz    = cand.deltaz;
+    float deltar    = cand.deltar;
+    float deltarxy  = cand.deltarxy;
+    float rendi     = cand.rendi;
+
+    // kink point - the closest approach of the parent end and daughter start
+    // helices, within the z range between the two track ends
+    const TrackHelix & helixp = trackHelixEnd[cand.parent];
+    const TrackHelix & helixd = trackHelixStart[cand.daughter];
+    float dr = pair.distance;
+    float seedp[3];
+    float seedd[3];
+    helixp.getPoint(pair.phi1, seedp);
+    helixd.getPoint(pair.phi2, seedd);
+    float zf = (seedp[2]+seedd[2])/2;
+    if(zf<cand.zs || zf>cand.ze){
+      // closest approach outside the z range, take the helix points at its
+      // nearer end
+      zf = zf<cand.zs ? cand.zs : cand.ze;
+      helixp.getPoint(helixp.getPhiInZ(zf), seedp);
+      helixd.getPoint(helixd.getPhiInZ(zf), seedd);
+      float dxf = seedp[0]-seedd[0];
+      float dyf = seedp[1]-seedd[1];
+      float dzf = seedp[2]-seedd[2];
+      dr = sqrt(dxf*dxf+dyf*dyf+dzf*dzf);
+    }
+    float xkink = (seedp[0]+seedd[0])/2;
+    float ykink = (seedp[1]+seedd[1])/2;
+    float zkink = zf;
+    float rkink = sqrt(xkink*xkink+ykink*ykink);
+    if(rkink<rOuter[i])rkink=rOuter[i];
+    if(rkink>rInner[j])rkink=rInner[j];
+
+    bool  ok = true;
+    if(fabs(deltaz)>200)ok=false;
+    if(fabs(deltaz)>100 && dr > 5.0)ok=false;
+
+    float deltaRxyCut = -100;
+    float drCut   = -100;
 //    	    bool goodRadialSep = false;
-	    // require kink to be outside VTX detector
-	    if(rkink > _rVTX[_nLayersVTX-1]){
-	      // for TPC use
-	      drCut  = _drCutTPC;
-	      deltaRxyCut= (_tpcOuterR-_tpcInnerR)/_tpcMaxRow*_maxDeltaTpcLayers;
-	      if(dr<_tightDrCutTPC)deltaRxyCut=deltaRxyCut*1.5;
-	      if(dr<_veryTightDrCutTPC)deltaRxyCut=deltaRxyCut/1.5*2.0;
-
-	      // for SIT
-	      if(rkink<_tpcInnerR+deltaRxyCut){
-		drCut  = _drCutSIT;
-		int iSitLayer=0;
-		for(int il=0;il<_nLayersSIT;il++){
-		  if(rkink>_rSIT[il])iSitLayer=il+1;
-		}
-		// kink between VTX and SIT
-		if(iSitLayer==0)deltaRxyCut = _rSIT[0]-_rVTX[_nLayersVTX-1];
-		// kink between SIT and TPC
-		if(iSitLayer==_nLayersSIT){
-		  deltaRxyCut = _tpcInnerR - _rSIT[_nLayersSIT-1];
-		  drCut  = _drCutTPC;
-		}
-		if(iSitLayer>0 && iSitLayer <_nLayersSIT)deltaRxyCut = _rSIT[iSitLayer] - _rSIT[iSitLayer-1];
-		// add some protection for SIT layers - large gap
-		int ili = -999;
-		int ilo = -999;
-		for(int il=0; il<_nLayersSIT;il++){
-		  if(fabs(rOuter[i]-_rSIT[il])<10.)ili=il;
-		  if(fabs(rInner[j]-_rSIT[il])<10.)ilo=il;
-		}
-		if(ili>=0&&ilo>=0){
-		  float fix = (_rSIT[ilo] - _rSIT[ili]);
-		  if(fix<10)fix=10.;
-		  if(fix>deltaRxyCut)deltaRxyCut = fix;
-		}
-		// add some slop to account for geometry
-		deltaRxyCut = deltaRxyCut*1.1; 
-	      }
-	    }
+    // require kink to be outside VTX detector
+    if(rkink > _rVTX[_nLayersVTX-1]){
+      // for TPC use
+      drCut  = _drCutTPC;
+      deltaRxyCut= (_tpcOuterR-_tpcInnerR)/_tpcMaxRow*_maxDeltaTpcLayers;
+      if(dr<_tightDrCutTPC)deltaRxyCut=deltaRxyCut*1.5;
+      if(dr<_veryTightDrCutTPC)deltaRxyCut=deltaRxyCut/1.5*2.0;
+
+      // for SIT
+      if(rkink<_tpcInnerR+deltaRxyCut){
+	drCut  = _drCutSIT;
+	int iSitLayer=0;
+	for(int il=0;il<_nLayersSIT;il++){
+	  if(rkink>_rSIT[il])iSitLayer=il+1;
+	}
+	// kink between VTX and SIT
+	if(iSitLayer==0)deltaRxyCut = _rSIT[0]-_rVTX[_nLayersVTX-1];
+	// kink between SIT and TPC
+	if(iSitLayer==_nLayersSIT){
+	  deltaRxyCut = _tpcInnerR - _rSIT[_nLayersSIT-1];
+	  drCut  = _drCutTPC;
+	}
+	if(iSitLayer>0 && iSitLayer <_nLayersSIT)deltaRxyCut = _rSIT[iSitLayer] - _rSIT[iSitLayer-1];
+	// add some protection for SIT layers - large gap
+	int ili = -999;
+	int ilo = -999;
+	for(int il=0; il<_nLayersSIT;il++){
+	  if(fabs(rOuter[i]-_rSIT[il])<10.)ili=il;
+	  if(fabs(rInner[j]-_rSIT[il])<10.)ilo=il;
+	}
+	if(ili>=0&&ilo>=0){
+	  float fix = (_rSIT[ilo] - _rSIT[ili]);
+	  if(fix<10)fix=10.;
+	  if(fix>deltaRxyCut)deltaRxyCut = fix;
+	}
+	// add some slop to account for geometry
+	deltaRxyCut = deltaRxyCut*1.1; 
+      }
+    }
 
-	      
-	    // looser cuts for debug
-	    //	    std::cout << i << " : " << j << " dr = " << dr << " ( " << drCut << " )    deltaRxy = " << deltarxy << " ( " << deltaRxyCut << " ) " << std::endl; 
-	    if( (dr<drCut && deltarxy < deltaRxyCut*2) || mcKink){
-	      bool possibleSplit = false;
-	      bool split = false;
-	      rkink = sqrt(xkink*xkink+ykink*ykink);
-
-	      if( (rkink > _rKinkCut && !flipped) || mcKink){
-
-		float massENu   = this->kinkMass(helixEnd[i],helixStart[j],0., 0.);
-		float massMuNu  = this->kinkMass(helixEnd[i],helixStart[j],mMuon,0.);
-		float massPiPi  = this->kinkMass(helixEnd[i],helixStart[j],mPion,mPion);
-		float massPiN   = this->kinkMass(helixEnd[i],helixStart[j],mPion,mNeutron);
-		float massPPi0  = this->kinkMass(helixEnd[i],helixStart[j],mProton,mPion);
-		float massPiL   = this->kinkMass(helixEnd[i],helixStart[j],mPion,mLambda);
-		float FmassENu   = this->kinkMass(helixEnd[i],helixEnd[j],0., 0.);
-		float FmassMuNu  = this->kinkMass(helixEnd[i],helixEnd[j],mMuon,0.);
-		float FmassPiPi  = this->kinkMass(helixEnd[i],helixEnd[j],mPion,mPion);
-		float FmassPiN   = this->kinkMass(helixEnd[i],helixEnd[j],mPion,mNeutron);
-		float FmassPPi0  = this->kinkMass(helixEnd[i],helixEnd[j],mProton,mPion);
-		float FmassPiL   = this->kinkMass(helixEnd[i],helixEnd[j],mPion,mLambda);
-		float tPion = fabs(zkink-zAtStart[i])*mPion/fabs(momentumZ[i])/cTauPion;
-		float tSigma = fabs(zkink-zAtStart[i])*mSigma/fabs(momentumZ[i])/cTauSigma;
-		float tKaon  = fabs(zkink-zAtStart[i])*mKaon/fabs(momentumZ[i])/cTauKaon;
-		float tHyperon  = fabs(zkink-zAtStart[i])*mHyperon/fabs(momentumZ[i])/cTauHyperon;
-		float probPion    = 0;
-		float probKaon    = 0;
-		float probSigma   = 0;
-		float probHyperon = 0;
-		if(_pionDecayMassCut>0){
-		  float deltaPion = fabs(massMuNu-mPion)/_pionDecayMassCut; 
-		  if(deltaPion<1 && tPion > 0.001)probPion = 3.125*deltaPion*deltaPion+tPion;
-		}
-		if(_kaonDecayMassCut>0){
-		  float deltaKaonMuNu = fabs(massMuNu-mKaon)/_kaonDecayMassCut; 
-		  float deltaKaonPiPi = fabs(massPiPi-mKaon)/_kaonDecayMassCut;
-		  float deltaKaon = deltaKaonMuNu;
-		  if(deltaKaonPiPi<deltaKaon)deltaKaon = deltaKaonPiPi;
-		  if(deltaKaon<1 && tKaon > 0.005)probKaon = 3.125*deltaKaon*deltaKaon+tKaon;
-		}
-		if(_sigmaDecayMassCut>0 && momentum[i] > _minELambda){
-		  float deltaSigmaPiN  = fabs(massPiN-mSigma)/_sigmaDecayMassCut; 
-		  float deltaSigmaPPi0 = fabs(massPPi0-mSigma)/_sigmaDecayMassCut;
-		  float deltaSigma     = deltaSigmaPiN;
-		  if(deltaSigmaPPi0<deltaSigma)deltaSigma = deltaSigmaPPi0;
-		  if(deltaSigma<1 && tSigma < _sigmaTimeCut)probSigma = 3.125*deltaSigma*deltaSigma+tSigma;
-		}
-		if(_hyperonDecayMassCut>0 && momentum[i] > _minELambda){
-		  float deltaHyperon   = fabs(massPiL-mHyperon)/_hyperonDecayMassCut; 
-		  if(deltaHyperon<1 && tHyperon < _hyperonTimeCut)probHyperon = 3.125*deltaHyperon*deltaHyperon+tHyperon;
-		}
-		bool goodKinkMass = false;
-		if(probPion>0.0001||probKaon>0.0001||probSigma>0.0001||probHyperon>0.0001)goodKinkMass=true;
 
+    // looser cuts for debug
+    //      std::cout << i << " : " << j << " dr = " << dr << " ( " << drCut << " )    deltaRxy = " << deltarxy << " ( " << deltaRxyCut << " ) " << std::endl; 
+    if( (dr<drCut && deltarxy < deltaRxyCut*2) || mcKink){
+      bool possibleSplit = false;
+      bool split = false;
+      rkink = sqrt(xkink*xkink+ykink*ykink);
+
+      if( (rkink > _rKinkCut && !flipped) || mcKink){
+
+	float massENu   = this->kinkMass(helixEnd[i],helixStart[j],0., 0.);
+	float massMuNu  = this->kinkMass(helixEnd[i],helixStart[j],mMuon,0.);
+	float massPiPi  = this->kinkMass(helixEnd[i],helixStart[j],mPion,mPion);
+	float massPiN   = this->kinkMass(helixEnd[i],helixStart[j],mPion,mNeutron);
+	float massPPi0  = this->kinkMass(helixEnd[i],helixStart[j],mProton,mPion);
+	float massPiL   = this->kinkMass(helixEnd[i],helixStart[j],mPion,mLambda);
+	float FmassENu   = this->kinkMass(helixEnd[i],helixEnd[j],0., 0.);
+	float FmassMuNu  = this->kinkMass(helixEnd[i],helixEnd[j],mMuon,0.);
+	float FmassPiPi  = this->kinkMass(helixEnd[i],helixEnd[j],mPion,mPion);
+	float FmassPiN   = this->kinkMass(helixEnd[i],helixEnd[j],mPion,mNeutron);
+	float FmassPPi0  = this->kinkMass(helixEnd[i],helixEnd[j],mProton,mPion);
+	float FmassPiL   = this->kinkMass(helixEnd[i],helixEnd[j],mPion,mLambda);
+	float tPion = fabs(zkink-zAtStart[i])*mPion/fabs(momentumZ[i])/cTauPion;
+	float tSigma = fabs(zkink-zAtStart[i])*mSigma/fabs(momentumZ[i])/cTauSigma;
+	float tKaon  = fabs(zkink-zAtStart[i])*mKaon/fabs(momentumZ[i])/cTauKaon;
+	float tHyperon  = fabs(zkink-zAtStart[i])*mHyperon/fabs(momentumZ[i])/cTauHyperon;
+	float probPion    = 0;
+	float probKaon    = 0;
+	float probSigma   = 0;
+	float probHyperon = 0;
+	if(_pionDecayMassCut>0){
+	  float deltaPion = fabs(massMuNu-mPion)/_pionDecayMassCut; 
+	  if(deltaPion<1 && tPion > 0.001)probPion = 3.125*deltaPion*deltaPion+tPion;
+	}
+	if(_kaonDecayMassCut>0){
+	  float deltaKaonMuNu = fabs(massMuNu-mKaon)/_kaonDecayMassCut; 
+	  float deltaKaonPiPi = fabs(massPiPi-mKaon)/_kaonDecayMassCut;
+	  float deltaKaon = deltaKaonMuNu;
+	  if(deltaKaonPiPi<deltaKaon)deltaKaon = deltaKaonPiPi;
+	  if(deltaKaon<1 && tKaon > 0.005)probKaon = 3.125*deltaKaon*deltaKaon+tKaon;
+	}
+	if(_sigmaDecayMassCut>0 && momentum[i] > _minELambda){
+	  float deltaSigmaPiN  = fabs(massPiN-mSigma)/_sigmaDecayMassCut; 
+	  float deltaSigmaPPi0 = fabs(massPPi0-mSigma)/_sigmaDecayMassCut;
+	  float deltaSigma     = deltaSigmaPiN;
+	  if(deltaSigmaPPi0<deltaSigma)deltaSigma = deltaSigmaPPi0;
+	  if(deltaSigma<1 && tSigma < _sigmaTimeCut)probSigma = 3.125*deltaSigma*deltaSigma+tSigma;
+	}
+	if(_hyperonDecayMassCut>0 && momentum[i] > _minELambda){
+	  float deltaHyperon   = fabs(massPiL-mHyperon)/_hyperonDecayMassCut; 
+	  if(deltaHyperon<1 && tHyperon < _hyperonTimeCut)probHyperon = 3.125*deltaHyperon*deltaHyperon+tHyperon;
+	}
+	bool goodKinkMass = false;
+	if(probPion>0.0001||probKaon>0.0001||probSigma>0.0001||probHyperon>0.0001)goodKinkMass=true;
 
-		float dpop = 2*fabs(momentum[i]-momentum[j])/(momentum[i]+momentum[j]); 
-		float dp   = fabs(momentum[i]-momentum[j]);
-		if(dr<drCut && dpop < _maxSplitTrackFracDeltaP && dp < _maxSplitTrackDeltaP){
-		  possibleSplit = true;
-		}
 
-		if( (deltarxy<deltaRxyCut && dr<drCut) || possibleSplit ){
-		  twoTrackIntersection_t kinkij;
-		  kinkij.tracki   = i;
-		  kinkij.trackj   = j;
-		  kinkij.vtx[0]   = xkink;
-		  kinkij.vtx[1]   = ykink;
-		  kinkij.vtx[2]   = zkink;
-		  kinkij.p[0]     = helixStart[i]->getMomentum()[0];
-		  kinkij.p[1]     = helixStart[i]->getMomentum()[1];
-		  kinkij.p[2]     = helixStart[i]->getMomentum()[2];
-		  kinkij.mass     = 0.;
-		  kinkij.distance = dr;
-
-		  // split tracks
-		  if(deltarxy<2*deltaRxyCut && dr<drCut*2 ){
-		    if(possibleSplit && charge[i]*charge[j]>0 ){
-		      TrackerHitVec hitveci= tracks[i]->getTrackerHits();
-		      TrackerHitVec hitvecj= tracks[j]->getTrackerHits();
-		      int nhitsi = (int)hitveci.size();
-		      int nhitsj = (int)hitvecj.size();
-		      int ntpci = 0;
-		      int ntpcj = 0;
-		      HelixClass* helixi = helixStart[j];
-		      HelixClass* helixj = helixEnd[i]; 
-		      float hitxyz[3];
-		      float dist[3];
-		      float maxdisti=0;
-		      float maxdistj=0;
-		      int nclosei = 0;
-		      int nclosej = 0;
-		      float zmini = 99999;
-		      float zminj = 99999;
-		      float zmaxi = -99999;
-		      float zmaxj = -99999;
-		      for(int ih =0;ih<nhitsi;++ih){
-			float x = (float)hitveci[ih]->getPosition()[0];
-			float y = (float)hitveci[ih]->getPosition()[1];
-			float zz = (float)hitveci[ih]->getPosition()[2];
-			if(fabs(zz)<zmini)zmini=fabs(zz);
-			if(fabs(zz)>zmaxi)zmaxi=fabs(zz);
-			float r2 = x*x+y*y;
-			float  r = sqrt(r2);
-			if(r>_tpcInnerR)ntpci++;
-			hitxyz[0]=x;
-			hitxyz[1]=y;
-			hitxyz[2]=zz;
-			helixj->getDistanceToPoint(hitxyz, dist);
-			if(dist[2]>maxdisti)maxdisti=dist[2];
-			if(dist[2]<25.)nclosei++;
-		      }
-		      for(int ih =0;ih<nhitsj;++ih){
-			float x = (float)hitvecj[ih]->getPosition()[0];
-			float y = (float)hitvecj[ih]->getPosition()[1];
-			float zz = (float)hitvecj[ih]->getPosition()[2];
-			if(fabs(zz)<zminj)zminj=fabs(zz);
-			if(fabs(zz)>zmaxj)zmaxj=fabs(zz);
-			float r2 = x*x+y*y;
-			float  r = sqrt(r2);
-			if(r>_tpcInnerR)ntpcj++;
-			hitxyz[0]=x;
-			hitxyz[1]=y;
-			hitxyz[2]=zz;
-			helixi->getDistanceToPoint(hitxyz, dist);
-			if(dist[2]>maxdistj)maxdistj=dist[2];
-			if(dist[2]<25.)nclosej++;
-		      }
-		      float fclosei = (float)nclosei/(float)nhitsi;
-		      float fclosej = (float)nclosej/(float)nhitsj;
-		      if(_debugPrinting>0){
-			std::cout << " CAND SPLIT I : " << nhitsi << " ntpc " << ntpci << " nclose " << nclosei << " max " << maxdisti << " fclose : " << fclosei << std::endl; 
-			std::cout << " CAND SPLIT J : " << nhitsj << " ntpc " << ntpcj << " nclose " << nclosej << " max " << maxdistj << " fclose : " << fclosej << std::endl; 
-		      }
-		      if(maxdistj<50 && maxdisti < 50 && fclosej > 0.95 && fclosei > 0.95 && ntpcj+ntpci < _tpcMaxRow+10.)split = true;
-		      splitDaughters[i].push_back(kinkij);
-		    }
-		  }
+	float dpop = 2*fabs(momentum[i]-momentum[j])/(momentum[i]+momentum[j]); 
+	float dp   = fabs(momentum[i]-momentum[j]);
+	if(dr<drCut && dpop < _maxSplitTrackFracDeltaP && dp < _maxSplitTrackDeltaP){
+	  possibleSplit = true;
+	}
 
-		  // kinks
-		  if(deltarxy<deltaRxyCut && dr<drCut ){
-		    if(charge[i]*charge[j]>0 && goodKinkMass){
-		      if(_debugPrinting>0)std::cout << "Found  kink candidate " << i << " " << j  << std::endl;
-		      if(probPion>0||probKaon>0||probSigma>0||probHyperon>0)goodKinkMass=true;
-		      if(probPion > probKaon  && 
-			 probPion > probSigma &&
-			 probPion > probHyperon){
-			kinkij.pdgCode = 211;
-			if(charge[i]<0)kinkij.pdgCode = -211;
-			kinkij.mass = mPion;
-		      }
-		      if(probKaon > probPion  && 
-			 probKaon > probSigma &&
-			 probKaon > probHyperon){
-			kinkij.mass = mKaon;
-			kinkij.pdgCode = 321;
-			if(charge[i]<0)kinkij.pdgCode = -321;
-		      }
-		      if(probSigma > probPion  && 
-			 probSigma > probKaon &&
-			 probSigma > probHyperon){
-			kinkij.mass = mSigma;
-			kinkij.pdgCode = 3222;
-			if(charge[i]<0)kinkij.pdgCode = 3222;
-		      }
-		      if(probHyperon > probPion  && 
-			 probHyperon > probKaon  &&
-			 probHyperon > probSigma){
-			kinkij.mass = mHyperon;
-			kinkij.pdgCode = 3312;
-			if(charge[i]>0)kinkij.pdgCode = -3312;
-		      }
-		      kinkDaughters[i].push_back(kinkij);
-		    }
-		  }
+	if( (deltarxy<deltaRxyCut && dr<drCut) || possibleSplit ){
+	  twoTrackIntersection_t kinkij;
+	  kinkij.tracki   = i;
+	  kinkij.trackj   = j;
+	  kinkij.vtx[0]   = xkink;
+	  kinkij.vtx[1]   = ykink;
+	  kinkij.vtx[2]   = zkink;
+	  kinkij.p[0]     = helixStart[i]->getMomentum()[0];
+	  kinkij.p[1]     = helixStart[i]->getMomentum()[1];
+	  kinkij.p[2]     = helixStart[i]->getMomentum()[2];
+	  kinkij.mass     = 0.;
+	  kinkij.distance = dr;
+
+	  // split tracks
+	  if(deltarxy<2*deltaRxyCut && dr<drCut*2 ){
+	    if(possibleSplit && charge[i]*charge[j]>0 ){
+	      TrackerHitVec hitveci= tracks[i]->getTrackerHits();
+	      TrackerHitVec hitvecj= tracks[j]->getTrackerHits();
+	      int nhitsi = (int)hitveci.size();
+	      int nhitsj = (int)hitvecj.size();
+	      int ntpci = 0;
+	      int ntpcj = 0;
+	      HelixClass* helixi = helixStart[j];
+	      HelixClass* helixj = helixEnd[i]; 
+	      float hitxyz[3];
+	      float dist[3];
+	      float maxdisti=0;
+	      float maxdistj=0;
+	      int nclosei = 0;
+	      int nclosej = 0;
+	      float zmini = 99999;
+	      float zminj = 99999;
+	      float zmaxi = -99999;
+	      float zmaxj = -99999;
+	      for(int ih =0;ih<nhitsi;++ih){
+		float x = (float)hitveci[ih]->getPosition()[0];
+		float y = (float)hitveci[ih]->getPosition()[1];
+		float zz = (float)hitveci[ih]->getPosition()[2];
+		if(fabs(zz)<zmini)zmini=fabs(zz);
+		if(fabs(zz)>zmaxi)zmaxi=fabs(zz);
+		float r2 = x*x+y*y;
+		float  r = sqrt(r2);
+		if(r>_tpcInnerR)ntpci++;
+		hitxyz[0]=x;
+		hitxyz[1]=y;
+		hitxyz[2]=zz;
+		helixj->getDistanceToPoint(hitxyz, dist);
+		if(dist[2]>maxdisti)maxdisti=dist[2];
+		if(dist[2]<25.)nclosei++;
+	      }
+	      for(int ih =0;ih<nhitsj;++ih){
+		float x = (float)hitvecj[ih]->getPosition()[0];
+		float y = (float)hitvecj[ih]->getPosition()[1];
+		float zz = (float)hitvecj[ih]->getPosition()[2];
+		if(fabs(zz)<zminj)zminj=fabs(zz);
+		if(fabs(zz)>zmaxj)zmaxj=fabs(zz);
+		float r2 = x*x+y*y;
+		float  r = sqrt(r2);
+		if(r>_tpcInnerR)ntpcj++;
+		hitxyz[0]=x;
+		hitxyz[1]=y;
+		hitxyz[2]=zz;
+		helixi->getDistanceToPoint(hitxyz, dist);
+		if(dist[2]>maxdistj)maxdistj=dist[2];
+		if(dist[2]<25.)nclosej++;
+	      }
+	      float fclosei = (float)nclosei/(float)nhitsi;
+	      float fclosej = (float)nclosej/(float)nhitsj;
+	      if(_debugPrinting>0){
+		std::cout << " CAND SPLIT I : " << nhitsi << " ntpc " << ntpci << " nclose " << nclosei << " max " << maxdisti << " fclose : " << fclosei << std::endl; 
+		std::cout << " CAND SPLIT J : " << nhitsj << " ntpc " << ntpcj << " nclose " << nclosej << " max " << maxdistj << " fclose : " << fclosej << std::endl; 
+	      }
+	      if(maxdistj<50 && maxdisti < 50 && fclosej > 0.95 && fclosei > 0.95 && ntpcj+ntpci < _tpcMaxRow+10.)split = true;
+	      splitDaughters[i].push_back(kinkij);
+	    }
+	  }
 
-		  // prongs
-		  if(deltarxy<deltaRxyCut && dr<drCut ){
-		
-		    if(_debugPrinting>0)std::cout << "Found prong candidate " << i << " " << j  << std::endl;
-		    prongDaughters[i].push_back(kinkij);
-		    kinkij.pdgCode = 211;
-		    if(charge[i]<0)kinkij.pdgCode = -211;
-		    kinkij.mass = mPion;
-		  }
+	  // kinks
+	  if(deltarxy<deltaRxyCut && dr<drCut ){
+	    if(charge[i]*charge[j]>0 && goodKinkMass){
+	      if(_debugPrinting>0)std::cout << "Found  kink candidate " << i << " " << j  << std::endl;
+	      if(probPion>0||probKaon>0||probSigma>0||probHyperon>0)goodKinkMass=true;
+	      if(probPion > probKaon  && 
+		 probPion > probSigma &&
+		 probPion > probHyperon){
+		kinkij.pdgCode = 211;
+		if(charge[i]<0)kinkij.pdgCode = -211;
+		kinkij.mass = mPion;
+	      }
+	      if(probKaon > probPion  && 
+		 probKaon > probSigma &&
+		 probKaon > probHyperon){
+		kinkij.mass = mKaon;
+		kinkij.pdgCode = 321;
+		if(charge[i]<0)kinkij.pdgCode = -321;
+	      }
+	      if(probSigma > probPion  && 
+		 probSigma > probKaon &&
+		 probSigma > probHyperon){
+		kinkij.mass = mSigma;
+		kinkij.pdgCode = 3222;
+		if(charge[i]<0)kinkij.pdgCode = 3222;
+	      }
+	      if(probHyperon > probPion  && 
+		 probHyperon > probKaon  &&
+		 probHyperon > probSigma){
+		kinkij.mass = mHyperon;
+		kinkij.pdgCode = 3312;
+		if(charge[i]>0)kinkij.pdgCode = -3312;
+	      }
+	      kinkDaughters[i].push_back(kinkij);
+	    }
+	  }
 
-		}
-		
-		if(_debugPrinting>0){
-		  if(mcParticle[j]!=NULL){
-		    EVENT::MCParticleVec parents = mcParticle[j]->getParents();
-		    if(parents.size()>0 && mcParticle[i]!=NULL){
-		      for(unsigned im = 0; im<parents.size();im++){
-			if(parents[im]==mcParticle[i])std::cout << " TRUE KINK . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . " << std::endl;
-		      }
-		    }
-		  }
-		  
-
-
-		  std::cout << "   Candidate kink tracks : " << i << "," << j << " p[i] " << momentum[i] << " p[j] " << momentum[j] << std::endl;
-		  if(flipped)std::cout << "   Flipped Track " << std::endl;;
-		  std::cout << "   MC  : ";
-		  if(mcParticle[i]!=NULL)std::cout << mcParticle[i]->getPDG();
-		  std::cout << " - "; 
-		  if(mcParticle[j]!=NULL)std::cout << mcParticle[j]->getPDG();
-		  std::cout << std::endl;	
-		  std::cout << "   Mass                  : " << massENu << " " << massMuNu << " " << massPiPi << " " << massPiN << " " << massPPi0 << " " << massPiL << std::endl;  
-		  if(flipped)std::cout << "   MassF                 : " << FmassENu << " " << FmassMuNu << " " << FmassPiPi << " " << FmassPiN << " " << FmassPPi0 << FmassPiL << std::endl;  
-
-		  std::cout << "     ProbPion            : " << probPion << " TimePion    : " << tPion  << " Dm = " << massMuNu-mPion << std::endl;
-		  std::cout << "     ProbKaon            : " << probKaon << " TimeKaon    : " << tKaon  << 
-		    " Dm = " << massMuNu-mKaon << 
-		    " Dm = " << massPiPi-mKaon <<  std::endl;
-		  std::cout << "     ProbSigma           : " << probSigma << " TimeSigma   : " << tSigma << " Dm = " << massPiN-mSigma << 
-		    " Dm = " << massPPi0-mSigma <<  std::endl;
-		  std::cout << "     ProbHyperon         : " << probHyperon << " TimeHyperon : " << tHyperon << " Dm = " << massPiL-mHyperon <<  std::endl;
-		  std::cout << "   Charge                : " << i << "," << j << " q[i] " << charge[i] << " q[j] " << charge[j] << std::endl;
-		  std::cout << "   Rendi                 : " << i << "," << j << "  rend " << rendi << "  dr = " << dr << " (deltaR = " << deltar << ")" << std::endl;
-		  std::cout << "   zkink                 : " <<  zkink << " rzykink " << rkink << std::endl;
-		  if(deltarxy<deltaRxyCut)std::cout << "   DeltaRxy vs cut       : " << deltarxy << " < " << deltaRxyCut << std::endl;
-		  if(deltarxy>deltaRxyCut)std::cout << "   DeltaRxy vs cut       : " << deltarxy << " > " << deltaRxyCut << std::endl;
-		  if(dr<drCut)std::cout <<             "   dr vs cut             : " << dr << " < " << drCut << std::endl;
-		  if(dr>drCut)std::cout <<             "   dr vs cut             : " << dr << " > " << drCut << std::endl;
-		  std::cout << "   zi/zj                 : " <<  zAtStart[i] << " - " << zAtEnd[i] << "     " << zAtStart[j] << " - " << zAtEnd[j] << std::endl;
-		  std::cout << "   rinner/router         : " << rInner[i] << " - " << rOuter[i]    << "     " << rInner[j]   << " - " << rOuter[j] << std::endl;
-		}
+	  // prongs
+	  if(deltarxy<deltaRxyCut && dr<drCut ){
+
+	    if(_debugPrinting>0)std::cout << "Found prong candidate " << i << " " << j  << std::endl;
+	    prongDaughters[i].push_back(kinkij);
+	    kinkij.pdgCode = 211;
+	    if(charge[i]<0)kinkij.pdgCode = -211;
+	    kinkij.mass = mPion;
+	  }
+
+	}
+
+	if(_debugPrinting>0){
+	  if(mcParticle[j]!=NULL){
+	    EVENT::MCParticleVec parents = mcParticle[j]->getParents();
+	    if(parents.size()>0 && mcParticle[i]!=NULL){
+	      for(unsigned im = 0; im<parents.size();im++){
+		if(parents[im]==mcParticle[i])std::cout << " TRUE KINK . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . " << std::endl;
 	      }
 	    }
 	  }
+
+
+
+	  std::cout << "   Candidate kink tracks : " << i << "," << j << " p[i] " << momentum[i] << " p[j] " << momentum[j] << std::endl;
+	  if(flipped)std::cout << "   Flipped Track " << std::endl;;
+	  std::cout << "   MC  : ";
+	  if(mcParticle[i]!=NULL)std::cout << mcParticle[i]->getPDG();
+	  std::cout << " - "; 
+	  if(mcParticle[j]!=NULL)std::cout << mcParticle[j]->getPDG();
+	  std::cout << std::endl;       
+	  std::cout << "   Mass                  : " << massENu << " " << massMuNu << " " << massPiPi << " " << massPiN << " " << massPPi0 << " " << massPiL << std::endl;  
+	  if(flipped)std::cout << "   MassF                 : " << FmassENu << " " << FmassMuNu << " " << FmassPiPi << " " << FmassPiN << " " << FmassPPi0 << FmassPiL << std::endl;  
+
+	  std::cout << "     ProbPion            : " << probPion << " TimePion    : " << tPion  << " Dm = " << massMuNu-mPion << std::endl;
+	  std::cout << "     ProbKaon            : " << probKaon << " TimeKaon    : " << tKaon  << 
+	    " Dm = " << massMuNu-mKaon << 
+	    " Dm = " << massPiPi-mKaon <<  std::endl;
+	  std::cout << "     ProbSigma           : " << probSigma << " TimeSigma   : " << tSigma << " Dm = " << massPiN-mSigma << 
+	    " Dm = " << massPPi0-mSigma <<  std::endl;
+	  std::cout << "     ProbHyperon         : " << probHyperon << " TimeHyperon : " << tHyperon << " Dm = " << massPiL-mHyperon <<  std::endl;
+	  std::cout << "   Charge                : " << i << "," << j << " q[i] " << charge[i] << " q[j] " << charge[j] << std::endl;
+	  std::cout << "   Rendi                 : " << i << "," << j << "  rend " << rendi << "  dr = " << dr << " (deltaR = " << deltar << ")" << std::endl;
+	  std::cout << "   zkink                 : " <<  zkink << " rzykink " << rkink << std::endl;
+	  if(deltarxy<deltaRxyCut)std::cout << "   DeltaRxy vs cut       : " << deltarxy << " < " << deltaRxyCut << std::endl;
+	  if(deltarxy>deltaRxyCut)std::cout << "   DeltaRxy vs cut       : " << deltarxy << " > " << deltaRxyCut << std::endl;
+	  if(dr<drCut)std::cout <<             "   dr vs cut             : " << dr << " < " << drCut << std::endl;
+	  if(dr>drCut)std::cout <<             "   dr vs cut             : " << dr << " > " << drCut << std::endl;
+	  std::cout << "   zi/zj                 : " <<  zAtStart[i] << " - " << zAtEnd[i] << "     " << zAtStart[j] << " - " << zAtEnd[j] << std::endl;
+	  std::cout << "   rinner/router         : " << rInner[i] << " - " << rOuter[i]    << "     " << rInner[j]   << " - " << rOuter[j] << std::endl;
 	}
       }
     }
-  }
+  } );
 
   int countk = 0;
   int countp = 0;
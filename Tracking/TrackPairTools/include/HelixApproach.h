@@ -0,0 +1,62 @@
+#ifndef HelixApproach_H
+#define HelixApproach_H 1
+
+class HelixClass;
+
+/** TrackHelix <br>
+ *  Helix of a track in the parametrisation used for the closest approach <br>
+ *  of two tracks. The point of the helix at phase phi is <br>
+ *  x = xc + radius*cos(phi), y = yc + radius*sin(phi), <br>
+ *  z = zRef + (phi-phiRef)*dzdphi, <br>
+ *  i.e. phi is the azimuth of the point seen from the centre of the helix <br>
+ *  circle. The parameters are taken from a HelixClass, the momentum of <br>
+ *  the HelixClass is expected at its reference point. <br>
+ */
+struct TrackHelix {
+
+  void Initialize( HelixClass & helix ) ;
+
+  /** Point of the helix at phase phi */
+  void getPoint( double phi, float * point ) const ;
+
+  /** Momentum of the particle at phase phi */
+  void getMomentum( double phi, float * momentum ) const ;
+
+  /** Phase of the point of the helix at given z (phiRef for a helix with pz = 0) */
+  double getPhiInZ( float z ) const ;
+
+  float xc{};
+  float yc{};
+  float radius{};
+  float phiRef{};    // phase of the reference point
+  float zRef{};
+  float dzdphi{};
+  float rotation{};  // +1 counter-clockwise, -1 clockwise motion in xy
+  float pxy{};
+  float pz{};
+
+} ;
+
+/** Closest approach of two helices. The distance is minimised by the <br>
+ *  Newton method (with Gauss-Newton steps where the distance isn't locally <br>
+ *  convex) starting at the phases phi1 and phi2, which are replaced by the <br>
+ *  phases of the points of closest approach. Returns the distance. <br>
+ */
+float HelixClosestApproach( const TrackHelix & helix1, const TrackHelix & helix2,
+			    double & phi1, double & phi2 ) ;
+
+/** Closest approach of two helices seeded by the intersections of their <br>
+ *  circles in the xy plane (or by the closest points of the circles if they <br>
+ *  don't intersect). The turn of the first helix nearest to its reference <br>
+ *  point is taken, the turn of the second helix is matched to it in z. <br>
+ *  Returns the distance, the vertex (middle of the points of closest <br>
+ *  approach) and the sum of the momenta at the points of closest approach. <br>
+ */
+float HelixDistance( const TrackHelix & helix1, const TrackHelix & helix2,
+		     float * vertex, float * momentum ) ;
+
+/** As above, returns the distance and the phases of the points of closest approach */
+float HelixDistance( const TrackHelix & helix1, const TrackHelix & helix2,
+		     double & phi1, double & phi2 ) ;
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef TrackPairEngine_H
+#define TrackPairEngine_H 1
+
+#include <vector>
+#include <functional>
+#include "HelixApproach.h"
+
+/** Closest approach of a pair of helices, as evaluated by the TrackPairEngine */
+struct TrackPairResult {
+  int index{};          // order in which the pair was added
+  int first{};          // helix indices
+  int second{};
+  float distance{};
+  double phi1{};        // phases of the points of closest approach
+  double phi2{};
+  float vertex[3]{};    // middle of the points of closest approach
+  float momentum[3]{};  // sum of the momenta at the points of closest approach
+};
+
+/** TrackPairEngine <br>
+ *  Evaluates the closest approach of candidate pairs of helices. The helices <br>
+ *  are stored once per event and referred to by index, the candidate pairs <br>
+ *  are added one by one. The pairs are evaluated independently, in parallel <br>
+ *  if more than one thread is set, and the results are handed to the <br>
+ *  hypothesis callback of the processor in the order in which the pairs were <br>
+ *  added, so the output doesn't depend on the number of threads. <br>
+ */
+class TrackPairEngine {
+
+ public:
+
+  TrackPairEngine() {}
+
+  void setNumberOfThreads( int nThreads ) { _nThreads = nThreads ; }
+
+  /** Remove all helices and pairs */
+  void clear() ;
+
+  /** Add a helix, returns its index */
+  int addHelix( const TrackHelix & helix ) ;
+
+  int getNumberOfHelices() const { return int(_helices.size()) ; }
+
+  const TrackHelix & getHelix( int i ) const { return _helices[i] ; }
+
+  /** Add a pair seeded by the xy intersections of the helix circles (see HelixDistance) */
+  void addPair( int first, int second ) ;
+
+  /** Add a pair with the minimisation started at phases phi1 and phi2 */
+  void addPair( int first, int second, double phi1, double phi2 ) ;
+
+  int getNumberOfPairs() const { return int(_pairs.size()) ; }
+
+  /** Closest approach of all pairs */
+  void evaluate() ;
+
+  /** Hand the evaluated pairs to the hypothesis callback, in the order of the pairs */
+  void process( const std::function<void(const TrackPairResult&)> & hypotheses ) const ;
+
+ protected:
+
+  void evaluatePair( TrackPairResult & pair ) const ;
+
+  int _nThreads{1};
+
+  std::vector<TrackHelix> _helices{};
+
+  std::vector<TrackPairResult> _pairs{};
+  std::vector<bool> _seeded{};
+
+} ;
+
+#endif
@@ -0,0 +1,239 @@
+#include "HelixApproach.h"
+#include "HelixClass.h"
+#include <math.h>
+#include <algorithm>
+
+void TrackHelix::Initialize( HelixClass & helix ) {
+
+  xc = helix.getXC();
+  yc = helix.getYC();
+  radius = helix.getRadius();
+
+  float ref[3];
+  float mom[3];
+  for (int i=0;i<3;++i) {
+    ref[i] = helix.getReferencePoint()[i];
+    mom[i] = helix.getMomentum()[i];
+  }
+
+  phiRef = atan2(ref[1]-yc,ref[0]-xc);
+  zRef = ref[2];
+  pxy = sqrt(mom[0]*mom[0]+mom[1]*mom[1]);
+  pz = mom[2];
+
+  // sense of rotation from the momentum at the reference point
+  float cross = (ref[0]-xc)*mom[1] - (ref[1]-yc)*mom[0];
+  rotation = cross<0 ? -1. : 1.;
+
+  dzdphi = 0.;
+  if (pxy>0)
+    dzdphi = rotation*radius*pz/pxy;
+
+}
+
+void TrackHelix::getPoint( double phi, float * point ) const {
+
+  point[0] = xc + radius*cos(phi);
+  point[1] = yc + radius*sin(phi);
+  point[2] = zRef + (phi-phiRef)*dzdphi;
+
+}
+
+void TrackHelix::getMomentum( double phi, float * momentum ) const {
+
+  momentum[0] = -rotation*pxy*sin(phi);
+  momentum[1] =  rotation*pxy*cos(phi);
+  momentum[2] = pz;
+
+}
+
+double TrackHelix::getPhiInZ( float z ) const {
+
+  if (dzdphi==0)
+    return phiRef;
+
+  return phiRef + (z-zRef)/dzdphi;
+
+}
+
+// Squared distance of the helix points at phases phi1, phi2
+static double distance2( const TrackHelix & h1, const TrackHelix & h2, double phi1, double phi2 ) {
+
+  double dx = h1.xc + h1.radius*cos(phi1) - h2.xc - h2.radius*cos(phi2);
+  double dy = h1.yc + h1.radius*sin(phi1) - h2.yc - h2.radius*sin(phi2);
+  double dz = h1.zRef + (phi1-h1.phiRef)*h1.dzdphi - h2.zRef - (phi2-h2.phiRef)*h2.dzdphi;
+  return dx*dx+dy*dy+dz*dz;
+
+}
+
+float HelixClosestApproach( const TrackHelix & h1, const TrackHelix & h2,
+			    double & phi1, double & phi2 ) {
+
+  const int    maxIterations = 30;
+  const int    maxHalvings   = 10;
+  const double maxStep       = 0.5;   // rad
+  const double minStep       = 1e-7;  // rad
+
+  double d2 = distance2(h1,h2,phi1,phi2);
+
+  for (int iter=0;iter<maxIterations;++iter) {
+
+    double c1 = cos(phi1), s1 = sin(phi1);
+    double c2 = cos(phi2), s2 = sin(phi2);
+
+    // separation, tangents and second derivatives of the helix points
+    double d[3]  = { h1.xc + h1.radius*c1 - h2.xc - h2.radius*c2,
+		     h1.yc + h1.radius*s1 - h2.yc - h2.radius*s2,
+		     h1.zRef + (phi1-h1.phiRef)*h1.dzdphi - h2.zRef - (phi2-h2.phiRef)*h2.dzdphi };
+    double t1[3] = { -h1.radius*s1, h1.radius*c1, h1.dzdphi };
+    double t2[3] = { -h2.radius*s2, h2.radius*c2, h2.dzdphi };
+    double a1[2] = { -h1.radius*c1, -h1.radius*s1 };
+    double a2[2] = { -h2.radius*c2, -h2.radius*s2 };
+
+    double g1 =  d[0]*t1[0] + d[1]*t1[1] + d[2]*t1[2];
+    double g2 = -d[0]*t2[0] - d[1]*t2[1] - d[2]*t2[2];
+
+    double t11 = t1[0]*t1[0] + t1[1]*t1[1] + t1[2]*t1[2];
+    double t22 = t2[0]*t2[0] + t2[1]*t2[1] + t2[2]*t2[2];
+    double h12 = -(t1[0]*t2[0] + t1[1]*t2[1] + t1[2]*t2[2]);
+    double h11 = t11 + d[0]*a1[0] + d[1]*a1[1];
+    double h22 = t22 - d[0]*a2[0] - d[1]*a2[1];
+
+    // Gauss-Newton where the distance isn't locally convex, damped for
+    // (nearly) parallel tangents
+    if (h11<=0 || h22<=0 || h11*h22-h12*h12<=0) {
+      h11 = t11;
+      h22 = t22;
+    }
+    double damping = 1e-6*(h11+h22);
+    h11 += damping;
+    h22 += damping;
+    double det = h11*h22-h12*h12;
+    if (det<=0) break;
+
+    double step1 = -( h22*g1 - h12*g2)/det;
+    double step2 = -(-h12*g1 + h11*g2)/det;
+
+    double stepMax = std::max(fabs(step1),fabs(step2));
+    if (stepMax>maxStep) {
+      step1 *= maxStep/stepMax;
+      step2 *= maxStep/stepMax;
+    }
+
+    // accept the step only if the distance decreases
+    bool improved = false;
+    for (int ih=0;ih<maxHalvings;++ih) {
+      double newd2 = distance2(h1,h2,phi1+step1,phi2+step2);
+      if (newd2<d2) {
+	phi1 += step1;
+	phi2 += step2;
+	d2 = newd2;
+	improved = true;
+	break;
+      }
+      step1 *= 0.5;
+      step2 *= 0.5;
+    }
+
+    if (!improved || std::max(fabs(step1),fabs(step2))<minStep) break;
+
+  }
+
+  return sqrt(d2);
+
+}
+
+// Turn of the phase phi nearest to the phase target
+static double nearestTurn( double phi, double target ) {
+
+  return phi + 2*M_PI*floor((target-phi)/(2*M_PI) + 0.5);
+
+}
+
+float HelixDistance( const TrackHelix & h1, const TrackHelix & h2,
+		     double & phi1Best, double & phi2Best ) {
+
+  // azimuths of the seed points on both circles
+  double alpha1[2];
+  double alpha2[2];
+  int nSeeds = 1;
+
+  double dx = h2.xc - h1.xc;
+  double dy = h2.yc - h1.yc;
+  double dc = sqrt(dx*dx+dy*dy);
+
+  if (dc<=0) {
+    // concentric circles
+    alpha1[0] = h1.phiRef;
+    alpha2[0] = h2.phiRef;
+  }
+  else if (dc>h1.radius+h2.radius) {
+    // separated circles, closest points face each other
+    alpha1[0] = atan2(dy,dx);
+    alpha2[0] = atan2(-dy,-dx);
+  }
+  else if (dc<fabs(h1.radius-h2.radius)) {
+    // one circle inside the other, closest points on the same side
+    double sign = h1.radius>h2.radius ? 1. : -1.;
+    alpha1[0] = atan2(sign*dy,sign*dx);
+    alpha2[0] = alpha1[0];
+  }
+  else {
+    // intersecting circles
+    double ux = dx/dc;
+    double uy = dy/dc;
+    double a = (dc*dc + h1.radius*h1.radius - h2.radius*h2.radius)/(2*dc);
+    double h = sqrt(std::max(h1.radius*h1.radius - a*a, 0.));
+    for (int is=0;is<2;++is) {
+      double sign = is==0 ? 1. : -1.;
+      double px = h1.xc + a*ux - sign*h*uy;
+      double py = h1.yc + a*uy + sign*h*ux;
+      alpha1[is] = atan2(py-h1.yc,px-h1.xc);
+      alpha2[is] = atan2(py-h2.yc,px-h2.xc);
+    }
+    nSeeds = 2;
+  }
+
+  float distance = 0.;
+
+  for (int is=0;is<nSeeds;++is) {
+    double phi1 = nearestTurn(alpha1[is],h1.phiRef);
+    float point1[3];
+    h1.getPoint(phi1,point1);
+    double phi2 = nearestTurn(alpha2[is],h2.getPhiInZ(point1[2]));
+
+    float dist = HelixClosestApproach(h1,h2,phi1,phi2);
+    if (is==0 || dist<distance) {
+      distance = dist;
+      phi1Best = phi1;
+      phi2Best = phi2;
+    }
+  }
+
+  return distance;
+
+}
+
+float HelixDistance( const TrackHelix & h1, const TrackHelix & h2,
+		     float * vertex, float * momentum ) {
+
+  double phi1Best = 0.;
+  double phi2Best = 0.;
+  float distance = HelixDistance(h1,h2,phi1Best,phi2Best);
+
+  float point1[3];
+  float point2[3];
+  float mom1[3];
+  float mom2[3];
+  h1.getPoint(phi1Best,point1);
+  h2.getPoint(phi2Best,point2);
+  h1.getMomentum(phi1Best,mom1);
+  h2.getMomentum(phi2Best,mom2);
+  for (int i=0;i<3;++i) {
+    vertex[i] = 0.5*(point1[i]+point2[i]);
+    momentum[i] = mom1[i]+mom2[i];
+  }
+
+  return distance;
+
+}
@@ -0,0 +1,96 @@
+#include "TrackPairEngine.h"
+#include <thread>
+
+void TrackPairEngine::clear() {
+
+  _helices.clear();
+
+  _pairs.clear();
+  _seeded.clear();
+
+}
+
+int TrackPairEngine::addHelix( const TrackHelix & helix ) {
+
+  _helices.push_back(helix);
+  return int(_helices.size())-1;
+
+}
+
+void TrackPairEngine::addPair( int first, int second ) {
+
+  TrackPairResult pair;
+  pair.index = int(_pairs.size());
+  pair.first = first;
+  pair.second = second;
+  _pairs.push_back(pair);
+  _seeded.push_back(false);
+
+}
+
+void TrackPairEngine::addPair( int first, int second, double phi1, double phi2 ) {
+
+  TrackPairResult pair;
+  pair.index = int(_pairs.size());
+  pair.first = first;
+  pair.second = second;
+  pair.phi1 = phi1;
+  pair.phi2 = phi2;
+  _pairs.push_back(pair);
+  _seeded.push_back(true);
+
+}
+
+void TrackPairEngine::evaluate() {
+
+  // each pair writes only its own result, so the pairs may be shared among threads
+  int nPairs = getNumberOfPairs();
+
+  if (_nThreads>1 && nPairs>1) {
+    std::vector<std::thread> workers;
+    for (int ith=0;ith<_nThreads;ith++) {
+      workers.push_back( std::thread( [this, nPairs, ith]() {
+	    for (int ip=ith;ip<nPairs;ip+=_nThreads)
+	      evaluatePair(_pairs[ip]);
+	  } ) );
+    }
+    for (unsigned int ith=0;ith<workers.size();ith++) workers[ith].join();
+  }
+  else {
+    for (int ip=0;ip<nPairs;++ip)
+      evaluatePair(_pairs[ip]);
+  }
+
+}
+
+void TrackPairEngine::process( const std::function<void(const TrackPairResult&)> & hypotheses ) const {
+
+  for (unsigned int ip=0;ip<_pairs.size();++ip)
+    hypotheses(_pairs[ip]);
+
+}
+
+void TrackPairEngine::evaluatePair( TrackPairResult & pair ) const {
+
+  const TrackHelix & helix1 = _helices[pair.first];
+  const TrackHelix & helix2 = _helices[pair.second];
+
+  if (_seeded[pair.index])
+    pair.distance = HelixClosestApproach(helix1, helix2, pair.phi1, pair.phi2);
+  else
+    pair.distance = HelixDistance(helix1, helix2, pair.phi1, pair.phi2);
+
+  float point1[3];
+  float point2[3];
+  float mom1[3];
+  float mom2[3];
+  helix1.getPoint(pair.phi1,point1);
+  helix2.getPoint(pair.phi2,point2);
+  helix1.getMomentum(pair.phi1,mom1);
+  helix2.getMomentum(pair.phi2,mom2);
+  for (int i=0;i<3;++i) {
+    pair.vertex[i] = 0.5*(point1[i]+point2[i]);
+    pair.momentum[i] = mom1[i]+mom2[i];
+  }
+
+}
@@ -6,6 +6,7 @@
 #include <string>
 #include <vector>
 #include "TrackPair.h"
+#include "TrackPairEngine.h"
 
 using namespace lcio ;
 using namespace marlin ;
@@ -47,6 +48,9 @@ using namespace marlin ;
  *  (default value 0.01 GeV) <br>
  *  @param MassRangeL0 maximal allowed deviation in mass for L0 hypothesis <br>
  *  (default value 0.008 GeV) <br>
+ *  @param NumberOfThreads number of threads used to compute the closest approach <br>
+ *  of the candidate track pairs <br>
+ *  (default value 1) <br>
  *  @author A.Raspereza, DESY
  *  @version $Id$ 
  */
@@ -71,6 +75,22 @@ class V0Finder : public Processor {
 
  protected:
 
+  /** Track quantities used by the pair search, computed once per track */
+  struct V0Track {
+    Track* track{};
+    TrackHelix helix{};
+    float charge{};
+    float pp{};
+    float rInner{};   // radius of innermost hit
+    float rMin{};     // radial range of the helix circle
+    float rMax{};
+  };
+
+  /** Can the helices of the two tracks meet within the track distance cut
+   *  at an accepted vertex radius? Pairs failing this can't form a V0.
+   */
+  bool isCompatible( const V0Track& t1, const V0Track& t2 ) const ;
+
   void Sorting( TrackPairVec & trkPairVec );
   float Rmin( Track* track );
   
@@ -102,6 +122,10 @@ class V0Finder : public Processor {
 
   float _minTrackHitRatio{};
 
+  int _nThreads{};
+
+  TrackPairEngine _pairEngine{};
+
 } ;
 
 #endif
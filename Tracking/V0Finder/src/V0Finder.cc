@@ -7,6 +7,7 @@
 #include "IMPL/VertexImpl.h"
 #include "UTIL/Operators.h"
 #include <math.h>
+#include <algorithm>
 
 #include <DD4hep/Detector.h>
 #include <DD4hep/DD4hepUnits.h>
@@ -101,6 +102,11 @@ V0Finder::V0Finder() : Processor("V0Finder") {
 			     _rxyCutLambda,
 			     float(50.0));
 
+  registerProcessorParameter("NumberOfThreads",
+			     "Number of threads used to compute the closest approach of the candidate track pairs",
+			     _nThreads,
+			     int(1));
+
 
 
 }
@@ -118,6 +124,8 @@ void V0Finder::init() {
   theDet.field().magneticField( { 0., 0., 0. }  , bfieldV  ) ;
   _bField = bfieldV[2]/dd4hep::tesla ;
 
+  _pairEngine.setNumberOfThreads(_nThreads);
+
   _nRun = -1;
   _nEvt = 0;
 
@@ -145,189 +153,204 @@ void V0Finder::processEvent( LCEvent * evt ) {
 
     std::map<Track*,int> trackUsed;
 
+    // Helices and the quantities used by the pair search, once per track
+    std::vector<V0Track> tracks(nelem);
+    _pairEngine.clear();
+
     for (int i=0;i<nelem;++i) {
-      Track * trk = dynamic_cast<Track*>(col->getElementAt(i));
-      trackUsed[trk] = 0;
+      V0Track & t = tracks[i];
+      t.track = dynamic_cast<Track*>(col->getElementAt(i));
+      trackUsed[t.track] = 0;
+
+      float d0 = t.track->getD0();
+      float z0 = t.track->getZ0();
+      float phi = t.track->getPhi();
+      float tanLambda = t.track->getTanLambda();
+      float omega = t.track->getOmega();
+      HelixClass helix;
+      helix.Initialize_Canonical(phi,d0,z0,omega,tanLambda,_bField);
+      t.helix.Initialize(helix);
+      t.charge = helix.getCharge();
+
+      float px = helix.getMomentum()[0];
+      float py = helix.getMomentum()[1];
+      float pz = helix.getMomentum()[2];
+      t.pp = sqrt(px*px+py*py+pz*pz);
+
+      t.rInner = t.track->getRadiusOfInnermostHit();
+
+      float rc = sqrt(t.helix.xc*t.helix.xc+t.helix.yc*t.helix.yc);
+      t.rMin = fabs(rc-t.helix.radius);
+      t.rMax = rc+t.helix.radius;
+
+      _pairEngine.addHelix(t.helix);
     }
-    
-    for (int i=0;i<nelem-1;++i) {
-      Track * firstTrack = dynamic_cast<Track*>(col->getElementAt(i));
-      float d01 = firstTrack->getD0();
-      float z01 = firstTrack->getZ0();
-      float phi1 = firstTrack->getPhi();
-      float tanLambda1 = firstTrack->getTanLambda();
-      float omega1 = firstTrack->getOmega();
-      HelixClass firstHelix;
-      firstHelix.Initialize_Canonical(phi1,d01,z01,omega1,tanLambda1,_bField);
-      float charge1 = firstHelix.getCharge();
-
-      float r1 = firstTrack->getRadiusOfInnermostHit();
 
+    // Candidate pairs: two tracks with opposite charges whose helices can
+    // meet at an accepted vertex. The closest approach is seeded from the
+    // track with the higher momentum, so it goes first in the engine
+    for (int i=0;i<nelem-1;++i) {
       for (int j=i+1;j<nelem;++j) {
-	Track * secondTrack = dynamic_cast<Track*>(col->getElementAt(j));
-	float r2 = secondTrack->getRadiusOfInnermostHit();
-
-	float d02 = secondTrack->getD0();
-	float z02 = secondTrack->getZ0();
-	float phi2 = secondTrack->getPhi();
-	float tanLambda2 = secondTrack->getTanLambda();
-	float omega2 = secondTrack->getOmega();
-	HelixClass secondHelix;
-	secondHelix.Initialize_Canonical(phi2,d02,z02,omega2,tanLambda2,_bField);
-	float charge2 = secondHelix.getCharge();
-	float prodCharge = charge1*charge2;
-	if (prodCharge<0) { // two tracks with opposite charges
-	  
-	  float px1 = firstHelix.getMomentum()[0];
-	  float py1 = firstHelix.getMomentum()[1];
-	  float pz1 = firstHelix.getMomentum()[2];
-	  float pp1 = sqrt(px1*px1+py1*py1+pz1*pz1);
-	  
-	  float px2 = secondHelix.getMomentum()[0];
-	  float py2 = secondHelix.getMomentum()[1];
-	  float pz2 = secondHelix.getMomentum()[2];
-	  float pp2 = sqrt(px2*px2+py2*py2+pz2*pz2);
-	  
-	  float distV0;
-	  float momentum[3];
-	  float vertex[3];
-	  
-	  if (pp1>pp2) {
-	    distV0 = firstHelix.getDistanceToHelix(&secondHelix, vertex, momentum);
-	  }
-	  else {
-	    distV0 = secondHelix.getDistanceToHelix(&firstHelix, vertex, momentum);
-	  }
-	  
-	  float radV0 = sqrt(vertex[0]*vertex[0]+vertex[1]*vertex[1]);
+	if (tracks[i].charge*tracks[j].charge<0 && isCompatible(tracks[i],tracks[j])) {
+	  if (tracks[i].pp>tracks[j].pp) _pairEngine.addPair(i,j);
+	  else _pairEngine.addPair(j,i);
+	}
+      }
+    }
+
+    // Closest approach of the candidate pairs (in parallel for NumberOfThreads>1)
+    _pairEngine.evaluate();
+
+    // Vertex cuts and hypotheses, in the order of the track pairs
+    _pairEngine.process( [&](const TrackPairResult & pair) {
+
+      // back to the order of the tracks in the collection
+      const V0Track & t1 = tracks[std::min(pair.first,pair.second)];
+      const V0Track & t2 = tracks[std::max(pair.first,pair.second)];
+
+      Track * firstTrack = t1.track;
+      Track * secondTrack = t2.track;
+
+      float charge1 = t1.charge;
+      float pp1 = t1.pp;
+      float pp2 = t2.pp;
+      float r1 = t1.rInner;
+      float r2 = t2.rInner;
+
+      float distV0 = pair.distance;
+      float momentum[3];
+      float vertex[3];
+      for (int iC=0;iC<3;++iC) {
+	vertex[iC] = pair.vertex[iC];
+	momentum[iC] = pair.momentum[iC];
+      }
+
+      float radV0 = sqrt(vertex[0]*vertex[0]+vertex[1]*vertex[1]);
 	  
 
-	  // check to ensure there are no hits on tracks at radii significantly smaller than reconstructed vertex
-	  // TO DO: should be done more precisely using helices
-	  if(r1/radV0<_minTrackHitRatio)continue;
-	  if(r2/radV0<_minTrackHitRatio)continue;
+      // check to ensure there are no hits on tracks at radii significantly smaller than reconstructed vertex
+      // TO DO: should be done more precisely using helices
+      if(r1/radV0<_minTrackHitRatio)return;
+      if(r2/radV0<_minTrackHitRatio)return;
 	 
 
-	  //	  if (distV0 < _dVertCut && radV0 > _rVertCut ) { // cut on vertex radius and track misdistance
-	  if (radV0 > _rVertCut  ) { 
+      //      if (distV0 < _dVertCut && radV0 > _rVertCut ) { // cut on vertex radius and track misdistance
+      if (radV0 > _rVertCut  ) { 
 
-	    streamlog_out( DEBUG4 ) << " ***************** found vertex for tracks : " << dd4hep::rec::Vector3D( (const float*) vertex ) 
-				    << " t1 " << lcshort( firstTrack ) << "\n"  
-				    << " t2 " << lcshort( secondTrack )  
-				    << " distV0 " << distV0 
-				    << std::endl ;
+	streamlog_out( DEBUG4 ) << " ***************** found vertex for tracks : " << dd4hep::rec::Vector3D( (const float*) vertex ) 
+				<< " t1 " << lcshort( firstTrack ) << "\n"  
+				<< " t2 " << lcshort( secondTrack )  
+				<< " distV0 " << distV0 
+				<< std::endl ;
 
-	    if( distV0 < _dVertCut ) { // cut on vertex radius and track misdistance
+	if( distV0 < _dVertCut ) { // cut on vertex radius and track misdistance
 	    
 
-	    streamlog_out( DEBUG ) << "  ***** testing various hypotheses " << std::endl ;
+	streamlog_out( DEBUG ) << "  ***** testing various hypotheses " << std::endl ;
 
-	    // Testing K0 hypothesis
-	    float energy1 = sqrt(pp1*pp1+MASSPion*MASSPion);
-	    float energy2 = sqrt(pp2*pp2+MASSPion*MASSPion);
-	    float energyV0 = energy1 + energy2;	  
-	    float massK0 = sqrt(energyV0*energyV0-momentum[0]*momentum[0]-momentum[1]*momentum[1]-momentum[2]*momentum[2]);
+	// Testing K0 hypothesis
+	float energy1 = sqrt(pp1*pp1+MASSPion*MASSPion);
+	float energy2 = sqrt(pp2*pp2+MASSPion*MASSPion);
+	float energyV0 = energy1 + energy2;   
+	float massK0 = sqrt(energyV0*energyV0-momentum[0]*momentum[0]-momentum[1]*momentum[1]-momentum[2]*momentum[2]);
 	    
-	    // Testing L0 hypothesis
-	    if (charge1<0) {
-	      energy1 = sqrt(pp1*pp1+MASSPion*MASSPion);
-	      energy2 = sqrt(pp2*pp2+MASSProton*MASSProton);
-	    }
-	    else {
-	      energy1 = sqrt(pp1*pp1+MASSProton*MASSProton);
-	      energy2 = sqrt(pp2*pp2+MASSPion*MASSPion);
-	    }
-	    energyV0 = energy1 + energy2;	  
-	    float massL0 = sqrt(energyV0*energyV0-momentum[0]*momentum[0]-momentum[1]*momentum[1]-momentum[2]*momentum[2]);
+	// Testing L0 hypothesis
+	if (charge1<0) {
+	  energy1 = sqrt(pp1*pp1+MASSPion*MASSPion);
+	  energy2 = sqrt(pp2*pp2+MASSProton*MASSProton);
+	}
+	else {
+	  energy1 = sqrt(pp1*pp1+MASSProton*MASSProton);
+	  energy2 = sqrt(pp2*pp2+MASSPion*MASSPion);
+	}
+	energyV0 = energy1 + energy2;         
+	float massL0 = sqrt(energyV0*energyV0-momentum[0]*momentum[0]-momentum[1]*momentum[1]-momentum[2]*momentum[2]);
 	  
-           // Testing L0bar hypothesis                                             
-            if (charge1>0) {
-              energy1 = sqrt(pp1*pp1+MASSPion*MASSPion);
-              energy2 = sqrt(pp2*pp2+MASSProton*MASSProton);
-            }
-            else {
-              energy1 = sqrt(pp1*pp1+MASSProton*MASSProton);
-              energy2 = sqrt(pp2*pp2+MASSPion*MASSPion);
-            }
-            energyV0 = energy1 + energy2;
-            float massL0bar = sqrt(energyV0*energyV0-momentum[0]*momentum[0]-momentum[1]*momentum[1]-momentum[2]*momentum[2]);
-
-
-
-	    // Testing photon hypothesis	  
-	    energyV0 = pp1 + pp2;
-	    float massGamma = sqrt(energyV0*energyV0-momentum[0]*momentum[0]-momentum[1]*momentum[1]-momentum[2]*momentum[2]);
-
-	    float deltaK0 = fabs(massK0 - MASSK0S);
-	    float deltaL0 = fabs(massL0 - MASSLambda0);
-	    float deltaGm = fabs(massGamma - MASSGamma);
-	    float deltaL0bar = fabs(massL0bar - MASSLambda0);
-	    if(radV0<_rxyCutGamma )deltaGm    = 100000.;
-	    if(radV0<_rxyCutK0S   )deltaK0    = 100000.;
-	    if(radV0<_rxyCutLambda)deltaL0    = 100000.;
-	    if(radV0<_rxyCutLambda)deltaL0bar = 100000.;
+       // Testing L0bar hypothesis                                             
+	if (charge1>0) {
+	  energy1 = sqrt(pp1*pp1+MASSPion*MASSPion);
+	  energy2 = sqrt(pp2*pp2+MASSProton*MASSProton);
+	}
+	else {
+	  energy1 = sqrt(pp1*pp1+MASSProton*MASSProton);
+	  energy2 = sqrt(pp2*pp2+MASSPion*MASSPion);
+	}
+	energyV0 = energy1 + energy2;
+	float massL0bar = sqrt(energyV0*energyV0-momentum[0]*momentum[0]-momentum[1]*momentum[1]-momentum[2]*momentum[2]);
+
+
+
+	// Testing photon hypothesis          
+	energyV0 = pp1 + pp2;
+	float massGamma = sqrt(energyV0*energyV0-momentum[0]*momentum[0]-momentum[1]*momentum[1]-momentum[2]*momentum[2]);
+
+	float deltaK0 = fabs(massK0 - MASSK0S);
+	float deltaL0 = fabs(massL0 - MASSLambda0);
+	float deltaGm = fabs(massGamma - MASSGamma);
+	float deltaL0bar = fabs(massL0bar - MASSLambda0);
+	if(radV0<_rxyCutGamma )deltaGm    = 100000.;
+	if(radV0<_rxyCutK0S   )deltaK0    = 100000.;
+	if(radV0<_rxyCutLambda)deltaL0    = 100000.;
+	if(radV0<_rxyCutLambda)deltaL0bar = 100000.;
 	    
-	    int code = 22;
-	    bool massCondition = false;
-
-           if (deltaGm<deltaL0&&deltaGm<deltaK0&&deltaGm<deltaL0bar) {
-              code = 22;
-              massCondition = deltaGm < _deltaMassGamma;
-            }
-            else if (deltaK0<deltaL0 && deltaK0<deltaL0bar) {
-              code = 310;
-              massCondition = deltaK0 < _deltaMassK0S;
-            }
-            else{
-              if (deltaL0<deltaL0bar ) {
-                code = 3122;
-                massCondition = deltaL0 < _deltaMassL0;
-              }else{
-                code = -3122;
-                massCondition = deltaL0bar < _deltaMassL0;
-              }
-            }
-
-	   streamlog_out( DEBUG ) << "  ***** mass condition :  " <<  massCondition 
-				  << "  code : " << code  << std::endl ;
-
-	    if (massCondition) {
-	      bool ok = true;
-	      if(r1/radV0<_minTrackHitRatio|| r2/radV0<_minTrackHitRatio){
-		r1 = this->Rmin(firstTrack);
-		r2 = this->Rmin(secondTrack);
-		if(r1/radV0<_minTrackHitRatio || r2/radV0<_minTrackHitRatio)ok = false;
-		//std::cout << " V0X: " << ok << " r = " << radV0 << " r1 = " << r1 << " r2 = " << r2 << std::endl;
-	      }
-	      if(!ok)continue;
-	      TrackPair * trkPair = new TrackPair();
-	      trkPair->setFirstTrack( firstTrack );
-	      trkPair->setSecondTrack( secondTrack );
-	      trkPair->setDistance( distV0 );
-	      trkPair->setVertex( vertex );
-	      trkPair->setMomentum( momentum );	    
-	      trkPair->setCode( code );
-	      trkPairs.push_back( trkPair );
+	int code = 22;
+	bool massCondition = false;
+
+       if (deltaGm<deltaL0&&deltaGm<deltaK0&&deltaGm<deltaL0bar) {
+	  code = 22;
+	  massCondition = deltaGm < _deltaMassGamma;
+	}
+	else if (deltaK0<deltaL0 && deltaK0<deltaL0bar) {
+	  code = 310;
+	  massCondition = deltaK0 < _deltaMassK0S;
+	}
+	else{
+	  if (deltaL0<deltaL0bar ) {
+	    code = 3122;
+	    massCondition = deltaL0 < _deltaMassL0;
+	  }else{
+	    code = -3122;
+	    massCondition = deltaL0bar < _deltaMassL0;
+	  }
+	}
+
+       streamlog_out( DEBUG ) << "  ***** mass condition :  " <<  massCondition 
+			      << "  code : " << code  << std::endl ;
+
+	if (massCondition) {
+	  bool ok = true;
+	  if(r1/radV0<_minTrackHitRatio|| r2/radV0<_minTrackHitRatio){
+	    r1 = this->Rmin(firstTrack);
+	    r2 = this->Rmin(secondTrack);
+	    if(r1/radV0<_minTrackHitRatio || r2/radV0<_minTrackHitRatio)ok = false;
+	    //std::cout << " V0X: " << ok << " r = " << radV0 << " r1 = " << r1 << " r2 = " << r2 << std::endl;
+	  }
+	  if(!ok)return;
+	  TrackPair * trkPair = new TrackPair();
+	  trkPair->setFirstTrack( firstTrack );
+	  trkPair->setSecondTrack( secondTrack );
+	  trkPair->setDistance( distV0 );
+	  trkPair->setVertex( vertex );
+	  trkPair->setMomentum( momentum );     
+	  trkPair->setCode( code );
+	  trkPairs.push_back( trkPair );
 	      
-	    }
-	    else {
-// 	      std::cout << "Rejected vertex : V = (" 
-// 			<< vertex[0] << ","
-// 			<< vertex[1] << ","
-// 			<< vertex[2] << ")" << std::endl;
-	    }
+	}
+	else {
+//            std::cout << "Rejected vertex : V = (" 
+//                      << vertex[0] << ","
+//                      << vertex[1] << ","
+//                      << vertex[2] << ")" << std::endl;
+	}
 	    
-// 	    std::cout << "Code = " << code << std::endl;
-// 	    std::cout << "Vertex = " << vertex[0] << " " << vertex[1] << " " << vertex[2] << std::endl;
-// 	    std::cout << "Momentum = " << momentum[0] << " " << momentum[1] << " " << momentum[2] << std::endl;
+//          std::cout << "Code = " << code << std::endl;
+//          std::cout << "Vertex = " << vertex[0] << " " << vertex[1] << " " << vertex[2] << std::endl;
+//          std::cout << "Momentum = " << momentum[0] << " " << momentum[1] << " " << momentum[2] << std::endl;
 
 	    
-	  } 
-	}
+	} 
       }
-    }
-
-    }//DEBUG ------
+    } );
 
 //     std::cout << std::endl;
 
@@ -434,21 +457,34 @@ void V0Finder::end(){ }
 
 void V0Finder::Sorting( TrackPairVec & trkPairVec ) {
 
-  int sizeOfVector = int(trkPairVec.size());
-  TrackPair *one,*two,*Temp;
-  
-  for (int i = 0 ; i < sizeOfVector-1; i++)
-    for (int j = 0; j < sizeOfVector-i-1; j++)
-      {
-	one = trkPairVec[j];
-	two = trkPairVec[j+1];
-	if( one->getDistance() > two->getDistance() )
-	  {
-	    Temp = trkPairVec[j];
-	    trkPairVec[j] = trkPairVec[j+1];
-	    trkPairVec[j+1] = Temp;
-	  }
-      }  
+  // stable - pairs with equal distance keep their order
+  std::stable_sort( trkPairVec.begin(), trkPairVec.end(), 
+		    [](TrackPair* one, TrackPair* two) { return one->getDistance() < two->getDistance(); } );
+
+}
+
+bool V0Finder::isCompatible( const V0Track& t1, const V0Track& t2 ) const {
+
+  // The points of closest approach lie on the helices, so their distance is
+  // at least the distance of the helix circles in the xy plane
+  float dx = t1.helix.xc-t2.helix.xc;
+  float dy = t1.helix.yc-t2.helix.yc;
+  float dc = sqrt(dx*dx+dy*dy);
+  float gap = std::max( dc-t1.helix.radius-t2.helix.radius, fabs(t1.helix.radius-t2.helix.radius)-dc );
+  if (gap>_dVertCut) return false;
+
+  // The vertex lies within the track distance of both helices. Its radius must
+  // pass the vertex radius cut and the loosest rxy cut of the hypotheses...
+  float rLow = std::max( _rVertCut, std::min( _rxyCutGamma, std::min( _rxyCutK0S, _rxyCutLambda ) ) );
+  if (t1.rMax+_dVertCut<rLow || t2.rMax+_dVertCut<rLow) return false;
+
+  // ...and the innermost hits of both tracks must not lie well inside the vertex
+  if (_minTrackHitRatio>0) {
+    float rHigh = std::min(t1.rInner,t2.rInner)/_minTrackHitRatio;
+    if (t1.rMin-_dVertCut>rHigh || t2.rMin-_dVertCut>rHigh) return false;
+  }
+
+  return true;
 
 }
 